@@ -120,7 +120,7 @@ int32_t FfiOHOSPreferencesPut(int64_t id, const char* key, ValueType value)
         LOGE("[Preferences] instance not exist. %{public}" PRId64, id);
         return ERR_INVALID_INSTANCE_CODE;
     }
-    return instance->Put(key, value);
+    return instance->Put(std::string(key), value);
 }
 
 ValueTypes FfiOHOSPreferencesGetAll(int64_t id)
@@ -448,13 +448,13 @@ ValueType PreferencesImpl::Get(const std::string &key, const ValueType &defValue
     return v;
 }
 
-int32_t PreferencesImpl::Put(const std::string &key, const ValueType &value)
+int32_t PreferencesImpl::Put(std::string &&key, const ValueType &value)
 {
     if (preferences == nullptr) {
         LOGE("The preferences is nullptr.");
         return E_ERROR;
     }
-    return preferences->Put(key, CValueTypeToNativeValue(value));
+    return preferences->Put(std::move(key), CValueTypeToNativeValue(value));
 }
 
 ValueTypes PreferencesImpl::GetAll()
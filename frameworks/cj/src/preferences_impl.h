@@ -74,7 +74,7 @@ public:
 
     ValueType Get(const std::string &key, const ValueType &defValue);
 
-    int32_t Put(const std::string &key, const ValueType &value);
+    int32_t Put(std::string &&key, const ValueType &value);
 
     ValueTypes GetAll();
 
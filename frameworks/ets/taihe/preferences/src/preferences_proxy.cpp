@@ -127,7 +127,7 @@ void PreferencesProxy::PutSync(string_view key, ValueType const& value)
             return;
         }
     }
-    auto errCode = preferences_->Put(keyStr, nativeValue);
+    auto errCode = preferences_->Put(std::move(keyStr), std::move(nativeValue));
     if (errCode != NativePreferences::E_OK) {
         SetBusinessError(std::make_shared<InnerError>(errCode));
     }
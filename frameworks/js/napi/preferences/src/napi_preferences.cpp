@@ -285,7 +285,7 @@ napi_value PreferencesProxy::SetValue(napi_env env, napi_callback_info info)
             LOG_ERROR("Failed to get instance when SetValue, The instance is nullptr.");
             return E_INNER_ERROR;
         }
-        return instance->Put(context->key, context->defValue);
+        return instance->Put(std::move(context->key), std::move(context->defValue));
     };
     auto output = [context](napi_env env, napi_value &result) {
         napi_status status = napi_get_undefined(env, &result);
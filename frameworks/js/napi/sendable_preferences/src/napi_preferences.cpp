@@ -264,7 +264,7 @@ napi_value PreferencesProxy::SetValue(napi_env env, napi_callback_info info)
         if (instance == nullptr) {
             return E_INNER_ERROR;
         }
-        return instance->Put(context->key, context->defValue);
+        return instance->Put(std::move(context->key), std::move(context->defValue));
     };
     auto output = [context](napi_env env, napi_value &result) {
         napi_status status = napi_get_undefined(env, &result);
@@ -15,13 +15,19 @@
 
 #ifndef PREFERENCES_FRAMEWORKS_EXECUTOR_H
 #define PREFERENCES_FRAMEWORKS_EXECUTOR_H
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <functional>
+#include <limits>
+#include <memory>
 #include <mutex>
 #include <queue>
+#include <string>
 #include <thread>
 
+#include "executor_queue.h"
 #include "preferences_thread.h"
-#include "priority_queue.h"
 namespace OHOS {
 namespace NativePreferences {
 
@@ -59,7 +65,9 @@ public:
         : thread_([this, name] {
               auto realName = std::string("task_queue_") + name;
               PthreadSetNameNp(realName);
+              GetLiveCounter()++;
               Run();
+              GetLiveCounter()--;
               self_ = nullptr;
           })
     {
@@ -69,14 +77,16 @@ public:
     Executor()
         : thread_([this] {
               PthreadSetNameNp("Executor");
+              GetLiveCounter()++;
               Run();
+              GetLiveCounter()--;
               self_ = nullptr;
           })
     {
         thread_.detach();
     }
 
-    void Bind(PriorityQueue<InnerTask, Time, TaskId> *queue, std::function<bool(std::shared_ptr<Executor>)> idle,
+    void Bind(ExecutorQueue<InnerTask, TaskId> *queue, std::function<bool(std::shared_ptr<Executor>)> idle,
         std::function<bool(std::shared_ptr<Executor>, bool)> release)
     {
         std::unique_lock<decltype(mutex_)> lock(mutex_);
@@ -95,8 +105,21 @@ public:
         cond_.wait(lock, [this, wait]() { return !wait || running_ == STOPPED; });
     }
 
+    // The executor threads running in the process, of all the pools.
+    static size_t GetLiveNum()
+    {
+        return GetLiveCounter().load();
+    }
+
 private:
     static constexpr Duration TIME_OUT = std::chrono::seconds(2);
+
+    static std::atomic<size_t> &GetLiveCounter()
+    {
+        static std::atomic<size_t> counter = 0;
+        return counter;
+    }
+
     void Run()
     {
         std::unique_lock<decltype(mutex_)> lock(mutex_);
@@ -130,7 +153,7 @@ private:
     std::condition_variable condition_;
     std::condition_variable cond_;
     std::shared_ptr<Executor> self_;
-    PriorityQueue<InnerTask, Time, TaskId> *waits_ = nullptr;
+    ExecutorQueue<InnerTask, TaskId> *waits_ = nullptr;
     std::function<bool(std::shared_ptr<Executor>)> idle_;
     std::function<bool(std::shared_ptr<Executor>, bool)> release_;
     std::thread thread_;
@@ -25,6 +25,8 @@
 #include "log_print.h"
 #include "pool.h"
 #include "priority_queue.h"
+#include "timer_wheel.h"
+#include "work_stealing_pool.h"
 
 namespace OHOS {
 namespace NativePreferences {
@@ -37,17 +39,39 @@ public:
     using InnerTask = Executor::InnerTask;
     using Status = Executor::Status;
     using TaskQueue = PriorityQueue<InnerTask, Time, TaskId>;
+    using DelayQueue = TimerWheel<InnerTask, Time, TaskId>;
     static constexpr Time INVALID_TIME = std::chrono::time_point<std::chrono::steady_clock, std::chrono::seconds>();
     static constexpr Duration INVALID_INTERVAL = std::chrono::milliseconds(0);
     static constexpr uint64_t UNLIMITED_TIMES = std::numeric_limits<uint64_t>::max();
     static constexpr Duration INVALID_DELAY = std::chrono::seconds(0);
     static constexpr TaskId INVALID_TASK_ID = static_cast<uint64_t>(0l);
 
-    ExecutorPool(size_t max, size_t min)
+    // How the tasks due now are run when max is more than 1. The executors of PRIORITY_QUEUE share one locked queue
+    // and leave after being idle for a while. The max workers of WORK_STEALING keep a deque each and stay until the
+    // pool is destroyed, a task handed to them can not be removed any more. The tasks due now start in submission
+    // order, except the ones submitted by a task of WORK_STEALING: they go to the deque of its worker, which runs
+    // the newest one first, while an idle worker steals the oldest one.
+    enum class Backend {
+        PRIORITY_QUEUE,
+        WORK_STEALING
+    };
+
+    struct Stats {
+        // The executor threads of the pool, the idle ones, the scheduler and the started workers included.
+        size_t executorNum = 0;
+        // The tasks waiting in the shared queue of the PRIORITY_QUEUE backend.
+        size_t queuedTaskNum = 0;
+        size_t delayedTaskNum = 0;
+        uint64_t schedulerWakeupCount = 0;
+    };
+
+    ExecutorPool(size_t max, size_t min, Backend backend = Backend::PRIORITY_QUEUE)
         : pool_(max, min), delayTasks_(InnerTask(), NextTimer), taskId_(INVALID_TASK_ID)
     {
         // When max equals 1, timer thread schedules and executes tasks.
-        if (max > 1) {
+        if (max > 1 && backend == Backend::WORK_STEALING) {
+            workers_ = new (std::nothrow) WorkStealingPool(max);
+        } else if (max > 1) {
             execs_ = new (std::nothrow) TaskQueue(InnerTask());
         }
     }
@@ -71,6 +95,7 @@ public:
             executor->Stop(true);
         });
         delete execs_;
+        delete workers_;
         poolStatus = Status::STOPPED;
     }
 
@@ -81,7 +106,7 @@ public:
             return INVALID_TASK_ID;
         }
 
-        if (execs_ == nullptr) {
+        if (execs_ == nullptr && workers_ == nullptr) {
             return Schedule(std::move(task), INVALID_DELAY, INVALID_INTERVAL, UNLIMITED_TIMES);
         }
 
@@ -139,9 +164,22 @@ public:
         return updated ? taskId : INVALID_TASK_ID;
     }
 
+    Stats GetStats()
+    {
+        Stats stats;
+        stats.executorNum = pool_.Size() + (workers_ != nullptr ? workers_->WorkerNum() : 0);
+        stats.queuedTaskNum = execs_ != nullptr ? execs_->Size() : 0;
+        stats.delayedTaskNum = delayTasks_.Size();
+        stats.schedulerWakeupCount = delayTasks_.GetWakeupCount();
+        return stats;
+    }
+
 private:
     TaskId Execute(Task task, TaskId taskId)
     {
+        if (workers_ != nullptr) {
+            return workers_->Submit(std::move(task)) ? taskId : INVALID_TASK_ID;
+        }
         InnerTask innerTask;
         innerTask.exec = task;
         innerTask.taskId = taskId;
@@ -154,7 +192,8 @@ private:
             execs_,
             [this](std::shared_ptr<Executor> exe) {
                 pool_.Idle(exe);
-                return true;
+                // a task pushed after the executor found the queue empty may have found no executor to bind.
+                return execs_->Size() == 0 || !pool_.Reclaim(exe);
             },
             [this](std::shared_ptr<Executor> exe, bool force) -> bool {
                 return pool_.Release(exe, force);
@@ -165,7 +204,7 @@ private:
     TaskId Schedule(InnerTask innerTask, Time delay)
     {
         auto id = innerTask.taskId;
-        if (execs_ != nullptr) {
+        if (execs_ != nullptr || workers_ != nullptr) {
             auto func = innerTask.exec;
             auto run = [this, func, id]() {
                 Execute(func, id);
@@ -215,9 +254,10 @@ private:
     Status poolStatus = Status::RUNNING;
     std::mutex mtx_;
     Pool<Executor> pool_;
-    TaskQueue delayTasks_;
+    DelayQueue delayTasks_;
     std::shared_ptr<Executor> scheduler_ = nullptr;
     TaskQueue *execs_ = nullptr;
+    WorkStealingPool *workers_ = nullptr;
     std::atomic<TaskId> taskId_;
 };
 } // namespace NativePreferences
@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PREFERENCES_EXECUTOR_QUEUE_H
+#define PREFERENCES_EXECUTOR_QUEUE_H
+#include <cstddef>
+
+namespace OHOS {
+namespace NativePreferences {
+// The queue an executor takes its tasks from. Pop blocks until a task is due, the executor calls Finish with the id
+// of the task once it has run.
+template<typename _Tsk, typename _Tid>
+class ExecutorQueue {
+public:
+    virtual ~ExecutorQueue() = default;
+    virtual _Tsk Pop() = 0;
+    virtual size_t Size() = 0;
+    virtual void Finish(_Tid id) = 0;
+};
+} // namespace NativePreferences
+} // namespace OHOS
+#endif // PREFERENCES_EXECUTOR_QUEUE_H
@@ -106,6 +106,42 @@ public:
         idle_ = cur;
     }
 
+    // Moves an idle item back to the busy ones, false if a Get took it meanwhile.
+    bool Reclaim(std::shared_ptr<T> data)
+    {
+        std::unique_lock<decltype(mutex_)> lock(mutex_);
+        Node *cur = idle_;
+        while (cur != nullptr && cur->data != data) {
+            cur = cur->next;
+        }
+        if (cur == nullptr) {
+            return false;
+        }
+        if (cur == idle_) {
+            idle_ = idle_->next;
+        }
+        if (cur->next != nullptr) {
+            cur->next->prev = cur->prev;
+        }
+        if (cur->prev != nullptr) {
+            cur->prev->next = cur->next;
+        }
+        cur->prev = nullptr;
+        cur->next = busy_;
+        if (busy_ != nullptr) {
+            busy_->prev = cur;
+        }
+        busy_ = cur;
+        return true;
+    }
+
+    // The items created and not released yet, the idle ones included.
+    uint32_t Size()
+    {
+        std::unique_lock<decltype(mutex_)> lock(mutex_);
+        return current_;
+    }
+
     int32_t Clean(std::function<void(std::shared_ptr<T>)> close) noexcept
     {
         auto temp = min_;
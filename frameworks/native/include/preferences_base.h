@@ -35,7 +35,6 @@ namespace OHOS {
 template <typename T> class sptr;
 class Uri;
 namespace NativePreferences {
-class ExecutorPool;
 class DataPreferencesObserverStub;
 /**
  * The function class of the preference. Various operations on preferences instances are provided in this class.
@@ -49,6 +48,8 @@ public:
 
     int Put(const std::string &key, const PreferencesValue &value) override;
 
+    int Put(std::string &&key, PreferencesValue &&value) override;
+
     int GetInt(const std::string &key, const int &defValue) override;
 
     std::string GetString(const std::string &key, const std::string &defValue) override;
@@ -119,7 +120,17 @@ public:
 
     virtual std::unordered_map<std::string, PreferencesValue> GetAllDatas() override;
 
+    // Iterates over a copy of the data taken by GetAllDatas.
+    std::pair<int, std::shared_ptr<PreferencesIterator>> CreateIterator() override;
+
+    int SetLoadingDefaults(const std::map<std::string, PreferencesValue> &defaults) override;
+
+    // True while an observer of any mode is registered, the observers do not hold a reference to the instance.
+    bool HasObservers();
+
 protected:
+    // The value of the key in the layer set by SetLoadingDefaults, defValue if the layer does not have it.
+    PreferencesValue GetLoadingDefault(const std::string &key, const PreferencesValue &defValue);
     Uri MakeUri(const std::string &key = "");
     void ReportObjectUsage(std::shared_ptr<PreferencesBase> pref, const PreferencesValue &value);
     struct WeakPtrCompare {
@@ -139,7 +150,8 @@ protected:
 
     const Options options_;
 
-    static ExecutorPool executorPool_;
+    std::mutex loadingDefaultsMutex_;
+    std::map<std::string, PreferencesValue> loadingDefaults_;
     std::atomic<bool> objectReported_ = false;
 };
 } // End of namespace NativePreferences
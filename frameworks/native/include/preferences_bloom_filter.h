@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PREFERENCES_BLOOM_FILTER_H
+#define PREFERENCES_BLOOM_FILTER_H
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace OHOS {
+namespace NativePreferences {
+
+// The keys of a store at a data version. A key it does not contain is not in the store, a key it contains may be.
+// The keys can not be removed, the filter is built again when it holds too many of them.
+class PreferencesBloomFilter {
+public:
+    PreferencesBloomFilter(size_t capacity, int64_t version);
+
+    static uint64_t Hash(std::string_view key);
+    void Add(uint64_t hash);
+    bool MightContain(uint64_t hash) const;
+
+    int64_t GetVersion() const;
+    void SetVersion(int64_t version);
+    // Whether more keys have been added than the filter is sized for.
+    bool IsOverloaded() const;
+
+private:
+    std::vector<uint64_t> bits_;
+    size_t bitNum_ = 0;
+    size_t capacity_ = 0;
+    size_t count_ = 0;
+    int64_t version_ = 0;
+};
+} // namespace NativePreferences
+} // namespace OHOS
+#endif // PREFERENCES_BLOOM_FILTER_H
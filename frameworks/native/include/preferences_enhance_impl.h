@@ -17,15 +17,22 @@
 #define PREFERENCES_ENHANCE_IMPL_H
 
 #include <any>
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <future>
 #include <list>
 #include <map>
+#include <mutex>
+#include <set>
 #include <string>
 #include <vector>
 #include <shared_mutex>
 
 #include "preferences_base.h"
+#include "preferences_bloom_filter.h"
 #include "preferences_db_adapter.h"
+#include "preferences_value_cache.h"
 
 namespace OHOS {
 namespace NativePreferences {
@@ -37,12 +44,18 @@ public:
     }
     virtual ~PreferencesEnhanceImpl();
 
+    // Loads the db api and starts opening the db in the background, the operations wait until it is opened.
     int Init();
 
+    // Whether the open started by Init is done and failed, false while it is in progress.
+    bool HasOpenFailed();
+
     PreferencesValue Get(const std::string &key, const PreferencesValue &defValue) override;
 
     int Put(const std::string &key, const PreferencesValue &value) override;
 
+    int Put(std::string &&key, PreferencesValue &&value) override;
+
     bool HasKey(const std::string &key) override;
 
     std::map<std::string, PreferencesValue> GetAll() override;
@@ -55,22 +68,149 @@ public:
 
     std::pair<int, PreferencesValue> GetValue(const std::string &key, const PreferencesValue &defValue) override;
 
+    std::pair<int, PreferencesValue> TryGet(const std::string &key, const PreferencesValue &defValue) override;
+
+    using PreferencesBase::GetAsync;
+
+    // Runs on the open pool when the store is still opening.
+    void GetAsync(const std::string &key, const PreferencesValue &defValue,
+        std::function<void(std::pair<int, PreferencesValue>)> callback, PreferencesResumer resumer) override;
+
+    // Runs FlushSync in the flush lane of the task processor.
+    void FlushAsync(std::function<void(int)> callback, PreferencesResumer resumer) override;
+
     std::pair<int, std::map<std::string, PreferencesValue>> GetAllData() override;
 
     std::unordered_map<std::string, PreferencesValue> GetAllDatas() override;
+
+    std::pair<int, std::shared_ptr<PreferencesIterator>> CreateIterator() override;
+
+    void Flush() override;
+
+    int FlushSync() override;
+
+    // Whether the memtable holds writes not in the db yet.
+    bool HasDirtyData();
+
+    // The bytes held by the value cache and the memtable.
+    int64_t GetMemoryBytes();
+
+    // Reads the keys into the value cache, without recording them.
+    void Prefetch(const std::vector<std::string> &keys);
+
+    // While enabled, the stores record the keys read by Get, GetValue and HasKey, for the prefetch manifest.
+    static void SetKeyRecordingEnabled(bool isEnabled);
+    std::vector<std::string> TakeRecordedKeys();
+
+    // The byte budget of the value cache of the stores opened afterwards.
+    static void SetValueCacheCapacity(size_t capacity);
+    static size_t GetValueCacheCapacity();
+    PreferencesValueCache::Stats GetValueCacheStats();
+    // The lookups of absent keys answered by the key filter without reading the db.
+    uint64_t GetKeyFilterHitCount();
+
+    // The reads reuse the data version checked within the interval instead of asking the db, so the writes of
+    // other processes may be seen that much later. The writes of this process are seen at once. 0 checks the
+    // version on every read, which is the default.
+    static void SetVersionCheckInterval(std::chrono::microseconds interval);
+    static std::chrono::microseconds GetVersionCheckInterval();
+    // The data versions read from the db.
+    uint64_t GetVersionCheckCount();
+
+    // The puts and deletes of the stores opened afterwards land in a memtable, which the reads consult first. It is
+    // written to the db in the background when it grows or ages, and on Flush, FlushSync and CloseDb.
+    static void SetWriteBehindEnabled(bool isEnabled);
+    static bool IsWriteBehindEnabled();
+
+    // A put or delete in the memtable, the later one to a key replaces the earlier.
+    struct PendingWrite {
+        PreferencesValue value;
+        bool isDeleted = false;
+        size_t size = 0;
+    };
+    using PendingWrites = std::map<std::string, PendingWrite>;
 private:
+    friend class PreferencesEnhanceIterator;
     explicit PreferencesEnhanceImpl(const Options &options);
+    int Open();
+    // Waits for the open started by Init and returns its result.
+    int WaitOpen();
+    bool IsOpenDone();
+    // Runs the task at once if the open is done, otherwise on the load lane once it is.
+    void RunAfterOpen(std::function<void()> task);
+    void RunOpenWaiters();
     static void NotifyPreferencesObserver(std::shared_ptr<PreferencesEnhanceImpl> pref, const std::string &key,
         const PreferencesValue &value);
+    // values holds the values before the change of the keys observed by the data observers.
     static void NotifyPreferencesObserverBatchKeys(std::shared_ptr<PreferencesEnhanceImpl> pref,
-        const std::unordered_map<std::string, PreferencesValue> &data);
-    std::pair<int, std::unordered_map<std::string, PreferencesValue>> GetAllInner();
-
+        const std::vector<std::string> &keys, const std::map<std::string, PreferencesValue> &values);
+    std::set<std::string> GetObservedKeys();
+    // Reads all the keys without decoding the values, except for the keys in valueKeys.
+    int GetAllKeys(const std::set<std::string> &valueKeys, std::vector<std::string> &keys,
+        std::map<std::string, PreferencesValue> &values);
+    // Decodes all the entries into data, which is left empty on failure.
+    template<typename Map>
+    int GetAllInner(Map &data);
+    template<typename K, typename V>
+    int PutInner(K &&key, V &&value);
+    // isExist reports whether the key is in the db, even when its value can not be decoded.
+    int GetInner(const std::string &key, PreferencesValue &value, bool &isExist);
+    int HasKeyInner(const std::string &key, bool &isExist);
+    int GetDataVersion(int64_t &dataVersion);
+    int CheckDataVersion(int64_t &dataVersion);
+    int PutToDb(const std::string &key, const PreferencesValue &value);
+    int DeleteFromDb(const std::string &key);
+    // value is null for a delete.
+    int BufferWrite(const std::string &key, const PreferencesValue *value);
+    // Returns false if the key has no pending write, otherwise isExist is false for a pending delete.
+    bool GetPendingWrite(const std::string &key, PreferencesValue *value, bool &isExist);
+    template<typename Map>
+    void ApplyPendingWrites(Map &data);
+    void ScheduleMemtableFlush(bool isUrgent);
+    // Writes the memtable to the db in key order, the caller holds dbMutex_ exclusively. The observers of the keys
+    // written are notified afterwards.
+    int FlushMemtable();
+    void NotifyWritten(std::vector<std::pair<std::string, PreferencesValue>> &&written);
+    // True only if the key filter is built under the version and does not contain the key.
+    bool IsKeyAbsent(const std::string &key, int64_t version);
+    // Read by the writers before the write, -1 if there is no key filter to update.
+    int64_t GetVersionBeforeWrite();
+    // Called by the writers with the data versions before and after the write, key is null for a delete.
+    void UpdateKeyFilter(const std::string *key, int64_t versionBefore, int64_t version);
+    void StartBuildKeyFilter();
+    void BuildKeyFilter();
+    void RecordKey(const std::string &key);
+
+    // The readers hold dbMutex_ shared, the writers exclusively. The value cache has a lock of its own.
     std::shared_mutex dbMutex_;
+    // set by Init before the preferences are shared, the users read their own copy.
+    std::shared_future<int> openFuture_;
+    // The tasks waiting for the open, run by the open task instead of holding a thread of the open pool.
+    std::mutex openMutex_;
+    bool isOpenDone_ = true;
+    std::vector<std::function<void()>> openWaiters_;
     std::shared_ptr<PreferencesDb> db_;
-    std::shared_mutex mapSharedMutex_;
-    int64_t cachedDataVersion_ = 0;
-    std::map<std::string, PreferencesValue> largeCachedData_;
+    PreferencesValueCache valueCache_;
+    // the version last read from the db and when, in microseconds of the steady clock, 0 if it must be read again.
+    std::atomic<int64_t> checkedDataVersion_ = 0;
+    std::atomic<int64_t> versionCheckTime_ = 0;
+    std::atomic<uint64_t> versionCheckCount_ = 0;
+    // The keys under a data version. The writers update it in place, the build replaces it, both hold dbMutex_,
+    // so the readers load it atomically.
+    std::shared_ptr<PreferencesBloomFilter> keyFilter_;
+    std::atomic<bool> isKeyFilterBuilding_ = false;
+    std::atomic<int64_t> keyFilterBuildTime_ = 0;
+    std::atomic<uint64_t> keyFilterHitCount_ = 0;
+    // The users of the memtable hold dbMutex_ shared and memtableMutex_, or dbMutex_ exclusively. The changes take
+    // memtableMutex_ in both cases, so HasDirtyData and GetMemoryBytes only take memtableMutex_.
+    bool isWriteBehind_ = false;
+    std::mutex memtableMutex_;
+    PendingWrites memtable_;
+    size_t memtableBytes_ = 0;
+    std::atomic<bool> isMemtableFlushScheduled_ = false;
+    std::atomic<bool> isMemtableFlushUrgent_ = false;
+    std::mutex recordMutex_;
+    std::set<std::string> recordedKeys_;
 };
 } // End of namespace NativePreferences
 } // End of namespace OHOS
@@ -17,6 +17,8 @@
 #define PREFERENCES_IMPL_H
 
 #include <any>
+#include <array>
+#include <atomic>
 #include <condition_variable>
 #include <list>
 #include <unordered_map>
@@ -33,6 +35,35 @@ namespace NativePreferences {
 
 class PreferencesImpl : public PreferencesBase, public std::enable_shared_from_this<PreferencesImpl> {
 public:
+    // Limits of the modified data which has not been written to the file yet, in bytes.
+    struct DirtyBytesBudget {
+        // past the soft limits, Put starts a flush without waiting for the caller.
+        int64_t softLimit;
+        int64_t globalSoftLimit;
+        // past the hard limits, Put waits at most waitTime (ms) for a flush, then fails.
+        int64_t hardLimit;
+        int64_t globalHardLimit;
+        int32_t waitTime;
+    };
+
+    struct WriteThrottleStats {
+        int64_t globalDirtyBytes = 0;
+        uint64_t earlyFlushCount = 0;
+        uint64_t throttledCount = 0;
+        uint64_t rejectedCount = 0;
+        // total time spent by the throttled writers, in microseconds.
+        uint64_t throttledTime = 0;
+    };
+
+    // The reads which found the file not loaded yet.
+    struct LoadWaitStats {
+        uint64_t waitCount = 0;
+        // the reads which ran the load themselves as it was still queued.
+        uint64_t stealCount = 0;
+        // the waits under 100us, 1ms, 10ms, 100ms, 1s, and the longer ones.
+        std::array<uint64_t, 6> waitTimeHistogram {};
+    };
+
     static std::shared_ptr<PreferencesImpl> GetPreferences(const Options &options)
     {
         return std::shared_ptr<PreferencesImpl>(new PreferencesImpl(options));
@@ -45,6 +76,8 @@ public:
 
     int Put(const std::string &key, const PreferencesValue &value) override;
 
+    int Put(std::string &&key, PreferencesValue &&value) override;
+
     bool HasKey(const std::string &key) override;
 
     std::map<std::string, PreferencesValue> GetAll() override;
@@ -63,26 +96,61 @@ public:
 
     std::pair<int, PreferencesValue> GetValue(const std::string &key, const PreferencesValue &defValue) override;
 
+    std::pair<int, PreferencesValue> TryGet(const std::string &key, const PreferencesValue &defValue) override;
+
+    using PreferencesBase::GetAsync;
+
+    // Runs after the queued load when the preferences are not loaded yet.
+    void GetAsync(const std::string &key, const PreferencesValue &defValue,
+        std::function<void(std::pair<int, PreferencesValue>)> callback, PreferencesResumer resumer) override;
+
+    // Runs FlushSync in the flush lane of the task processor.
+    void FlushAsync(std::function<void(int)> callback, PreferencesResumer resumer) override;
+
     std::pair<int, std::map<std::string, PreferencesValue>> GetAllData() override;
 
     std::unordered_map<std::string, PreferencesValue> GetAllDatas() override;
+
+    int64_t GetDirtyBytes();
+
+    bool HasDirtyData();
+
+    // The estimated bytes of the cached values, 0 until they are loaded.
+    int64_t GetMemoryBytes();
+
+    static int SetDirtyBytesBudget(const DirtyBytesBudget &budget);
+
+    static DirtyBytesBudget GetDirtyBytesBudget();
+
+    static WriteThrottleStats GetWriteThrottleStats();
+
+    static LoadWaitStats GetLoadWaitStats();
 private:
     explicit PreferencesImpl(const Options &options);
 
     static void NotifyPreferencesObserver(std::shared_ptr<PreferencesImpl> pref,
         std::shared_ptr<std::unordered_set<std::string>> keysModified,
         std::shared_ptr<std::unordered_map<std::string, PreferencesValue>> writeToDisk);
+    template<typename K, typename V>
+    int PutInner(K &&key, V &&value);
     bool StartLoadFromDisk();
     bool PreLoad();
 
     /* thread function */
     static void LoadFromDisk(std::shared_ptr<PreferencesImpl> pref);
+    // The caller holds mutex_.
+    void LoadFromDiskLocked();
     bool ReloadFromDisk();
     inline void AwaitLoadFile();
     static int WriteToDiskFile(std::shared_ptr<PreferencesImpl> pref);
     bool ReadSettingXml(std::unordered_map<std::string, PreferencesValue> &conMap);
     static void ExecuteNotifyChange(std::shared_ptr<PreferencesImpl> pref,
         std::shared_ptr<std::unordered_set<std::string>> keysModified);
+    int WaitForDirtyBudget();
+    void AddDirtyBytes(int64_t size);
+    void ResetDirtyBytes();
+    void ReleaseDirtyBytes(int64_t size);
+    void StartEarlyFlush();
 
     std::atomic<bool> loaded_;
     bool isNeverUnlock_;
@@ -94,6 +162,10 @@ private:
 
     std::atomic<bool> isActive_;
 
+    std::atomic<bool> isEarlyFlushPending_;
+
+    std::atomic<int64_t> dirtyBytes_;
+
     std::shared_mutex cacheMutex_;
 
     std::unordered_map<std::string, PreferencesValue> valuesCache_;
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PREFERENCES_PREFETCH_MANIFEST_H
+#define PREFERENCES_PREFETCH_MANIFEST_H
+
+#include <string>
+#include <vector>
+
+#include "preferences.h"
+
+namespace OHOS {
+namespace NativePreferences {
+
+// The preferences files opened, and the keys read, early in a launch. It is saved at the end of the recording and
+// loaded by the next launch to open the files and read the keys before they are asked for.
+class PreferencesPrefetchManifest {
+public:
+    struct Entry {
+        Options options = Options("");
+        // only recorded for the GSKV preferences, the XML ones load all their keys anyway.
+        std::vector<std::string> keys;
+    };
+
+    static constexpr size_t MAX_ENTRY_NUM = 64;
+    static constexpr size_t MAX_KEY_NUM = 256;
+
+    // The lines of a corrupted file are skipped, the rest is kept.
+    static int Load(const std::string &path, std::vector<Entry> &entries);
+    // Writes a temporary file and renames it over the manifest.
+    static int Save(const std::string &path, const std::vector<Entry> &entries);
+};
+} // namespace NativePreferences
+} // namespace OHOS
+#endif // PREFERENCES_PREFETCH_MANIFEST_H
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PREFERENCES_VALUE_CACHE_H
+#define PREFERENCES_VALUE_CACHE_H
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "preferences_value.h"
+
+namespace OHOS {
+namespace NativePreferences {
+
+// Caches the decoded values of a store, and the keys known to be absent, within a byte budget. The entries are
+// only valid for the data version they were read under, the cache drops all of them when it sees another one.
+// A new entry starts in the probation segment and moves to the protected segment when it is read again, so a scan
+// of cold keys only evicts other cold keys. An entry larger than the whole budget is held alone in a slot of its own,
+// outside of the budget, until the next such entry replaces it.
+class PreferencesValueCache {
+public:
+    struct Stats {
+        uint64_t hitCount = 0;
+        uint64_t missCount = 0;
+        uint64_t evictCount = 0;
+        size_t usedBytes = 0;
+        size_t entryCount = 0;
+    };
+
+    explicit PreferencesValueCache(size_t capacity);
+
+    // Returns false if the key is not cached under the version. isExist is false for a key cached as absent.
+    bool Get(const std::string &key, int64_t version, PreferencesValue &value, bool &isExist);
+
+    // Same as Get without copying the value.
+    bool Contains(const std::string &key, int64_t version, bool &isExist);
+
+    // Caches the value read under the version, size is the encoded size of the value.
+    void Put(const std::string &key, const PreferencesValue &value, size_t size, int64_t version);
+
+    // Caches the key as absent under the version.
+    void PutAbsent(const std::string &key, int64_t version);
+
+    // Called with the data version after a write of this process. The entries are kept if the write is the only
+    // change since the current version, that is the version is the next one.
+    void AdvanceVersion(int64_t version);
+
+    void Clear();
+
+    void SetCapacity(size_t capacity);
+
+    Stats GetStats();
+
+private:
+    struct Entry {
+        std::string key;
+        PreferencesValue value;
+        bool isExist = false;
+        bool isProtected = false;
+        bool isOversize = false;
+        size_t size = 0;
+    };
+    using EntryList = std::list<Entry>;
+
+    // Returns the end of probation_ on a miss, a hit is moved to the front of protected_.
+    EntryList::iterator Find(const std::string &key, int64_t version);
+    void Insert(Entry &&entry, int64_t version);
+    void Remove(EntryList::iterator it);
+    void Evict();
+    void ClearEntries();
+
+    std::mutex mutex_;
+    size_t capacity_ = 0;
+    size_t usedBytes_ = 0;
+    size_t protectedBytes_ = 0;
+    int64_t version_ = 0;
+    EntryList probation_;
+    EntryList protected_;
+    // at most one entry larger than capacity_, its size is not counted in usedBytes_.
+    EntryList oversize_;
+    std::unordered_map<std::string, EntryList::iterator> entries_;
+    uint64_t hitCount_ = 0;
+    uint64_t missCount_ = 0;
+    uint64_t evictCount_ = 0;
+};
+} // namespace NativePreferences
+} // namespace OHOS
+#endif // PREFERENCES_VALUE_CACHE_H
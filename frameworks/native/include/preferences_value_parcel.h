@@ -25,12 +25,21 @@
 namespace OHOS {
 namespace NativePreferences {
 
+// Encodes the values stored in the GSKV db. The values are written in the v2 format, which starts with
+// PARCEL_VERSION_V2, has varint lengths and packed arrays, and compresses large strings. The v1 format, which
+// starts with the type and has fixed width lengths, is still read.
 class PreferencesValueParcel {
 public:
     static uint8_t GetTypeIndex(const PreferencesValue &value);
-    static uint32_t CalSize(PreferencesValue value);
+    // The size of the buffer to marshall the value into, the encoded value may be smaller.
+    static uint32_t CalSize(const PreferencesValue &value);
+    // Encodes the value into data, which is at least CalSize large, and shrinks data to the encoded size.
     static int MarshallingPreferenceValue(const PreferencesValue &value, std::vector<uint8_t> &data);
     static std::pair<int, PreferencesValue> UnmarshallingPreferenceValue(const std::vector<uint8_t> &data);
+    // Decodes the value in place, such as from the memory of the db.
+    static std::pair<int, PreferencesValue> UnmarshallingPreferenceValue(const uint8_t *data, size_t len);
+
+    static constexpr uint8_t PARCEL_VERSION_V2 = 0xF2;
 
 private:
     enum ParcelTypeIndex {
@@ -46,32 +55,34 @@ private:
         DOUBLE_ARRAY_TYPE = 9,
         UINT8_ARRAY_TYPE = 10,
         OBJECT_TYPE = 11,
-        BIG_INT_TYPE = 12
+        BIG_INT_TYPE = 12,
+        INT_ARRAY_TYPE = 13,
+        INT64_ARRAY_TYPE = 14
     };
-    static int MarshallingBasicValue(const PreferencesValue &value, const uint8_t type, std::vector<uint8_t> &data);
-    static int MarshallingStringValue(const PreferencesValue &value, const uint8_t type, std::vector<uint8_t> &data);
-    static int MarshallingStringArrayValue(const PreferencesValue &value, const uint8_t type,
-        std::vector<uint8_t> &data);
-    static int MarshallingVecUInt8AfterType(const PreferencesValue &value, uint8_t *startAddr);
-    static int MarshallingVecBigIntAfterType(const PreferencesValue &value, uint8_t *startAddr);
-    static int MarshallingVecDoubleAfterType(const PreferencesValue &value, uint8_t *startAddr);
-    static int MarshallingVecBoolAfterType(const PreferencesValue &value, uint8_t *startAddr);
-    static int MarshallingBasicArrayValue(const PreferencesValue &value, const uint8_t type,
-        std::vector<uint8_t> &data);
+    class Writer;
+    class Reader;
+    static bool WriteValue(const PreferencesValue &value, uint8_t type, Writer &writer);
+    static bool WriteString(const std::string &str, uint8_t type, Writer &writer);
+    static bool WriteArray(const PreferencesValue &value, uint8_t type, Writer &writer);
+    static bool ReadValue(uint8_t type, Reader &reader, PreferencesValue &value);
+    static bool ReadString(uint8_t type, Reader &reader, PreferencesValue &value);
+    static bool ReadArray(uint8_t type, Reader &reader, PreferencesValue &value);
+    static bool CompressString(const std::string &str, Writer &writer);
+    static bool DecompressString(Reader &reader, size_t len, std::string &str);
+    static std::pair<int, PreferencesValue> UnmarshallingV2(const uint8_t *data, size_t len);
+
     static std::pair<int, PreferencesValue> UnmarshallingBasicValue(const uint8_t type,
-        const std::vector<uint8_t> &data);
+        const uint8_t *data);
     static std::pair<int, PreferencesValue> UnmarshallingStringValue(const uint8_t type,
-        const std::vector<uint8_t> &data);
+        const uint8_t *data);
     static std::pair<int, PreferencesValue> UnmarshallingStringArrayValue(const uint8_t type,
-        const std::vector<uint8_t> &data);
-    static std::pair<int, PreferencesValue> UnmarshallingVecUInt8(const std::vector<uint8_t> &data);
-    static std::pair<int, PreferencesValue> UnmarshallingVecDouble(const std::vector<uint8_t> &data);
-    static std::pair<int, PreferencesValue> UnmarshallingVecBool(const std::vector<uint8_t> &data);
-    static std::pair<int, PreferencesValue> UnmarshallingVecBigInt(const std::vector<uint8_t> &data);
+        const uint8_t *data);
+    static std::pair<int, PreferencesValue> UnmarshallingVecUInt8(const uint8_t *data);
+    static std::pair<int, PreferencesValue> UnmarshallingVecDouble(const uint8_t *data);
+    static std::pair<int, PreferencesValue> UnmarshallingVecBool(const uint8_t *data);
+    static std::pair<int, PreferencesValue> UnmarshallingVecBigInt(const uint8_t *data);
     static std::pair<int, PreferencesValue> UnmarshallingBasicArrayValue(const uint8_t type,
-        const std::vector<uint8_t> &data);
-    static int MarshallingBasicValueInner(const PreferencesValue &value, const uint8_t type,
-        std::vector<uint8_t> &data);
+        const uint8_t *data);
 };
 } // namespace NativePreferences
 } // namespace OHOS
@@ -22,10 +22,12 @@
 #include <set>
 #include <shared_mutex>
 
+#include "executor_queue.h"
+
 namespace OHOS {
 namespace NativePreferences {
 template<typename _Tsk, typename _Tme, typename _Tid>
-class PriorityQueue {
+class PriorityQueue : public ExecutorQueue<_Tsk, _Tid> {
 public:
     struct PQMatrix {
         _Tsk task_;
@@ -42,7 +44,7 @@ public:
             updater_ = [](_Tsk &) { return std::pair{false, _Tme()};};
         }
     }
-    _Tsk Pop()
+    _Tsk Pop() override
     {
         std::unique_lock<decltype(pqMtx_)> lock(pqMtx_);
         while (!tasks_.empty()) {
@@ -74,7 +76,7 @@ public:
         return true;
     }
 
-    size_t Size()
+    size_t Size() override
     {
         std::lock_guard<std::mutex> lock(pqMtx_);
         return tasks_.size();
@@ -138,7 +140,7 @@ public:
         popCv_.notify_all();
     }
 
-    void Finish(_Tid id)
+    void Finish(_Tid id) override
     {
         std::unique_lock<decltype(pqMtx_)> lock(pqMtx_);
         auto it = running_.find(id);
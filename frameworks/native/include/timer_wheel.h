@@ -0,0 +1,371 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PREFERENCES_TIMER_WHEEL_H
+#define PREFERENCES_TIMER_WHEEL_H
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+
+#include "executor_queue.h"
+
+namespace OHOS {
+namespace NativePreferences {
+// Keeps the tasks by the tick they are due in, a tick lasts 10 milliseconds by default. A task is never run before
+// its time and at most about two ticks after it, the tasks due in the same tick are popped in one wakeup.
+// Push, Remove and Update are O(1). Each level has 64 slots of 64 times the ticks of the level below, a slot is
+// moved down when the current tick reaches it, the tasks beyond the last level wait in a far list.
+template<typename _Tsk, typename _Tme, typename _Tid>
+class TimerWheel : public ExecutorQueue<_Tsk, _Tid> {
+public:
+    using TskUpdater = typename std::function<std::pair<bool, _Tme>(_Tsk &element)>;
+    static constexpr std::chrono::milliseconds DEFAULT_TICK = std::chrono::milliseconds(10);
+
+    TimerWheel(const _Tsk &task, TskUpdater updater = nullptr, std::chrono::milliseconds tick = DEFAULT_TICK)
+        : INVALID_TSK(task), updater_(std::move(updater)), tick_(tick), base_(std::chrono::steady_clock::now())
+    {
+        if (!updater_) {
+            updater_ = [](_Tsk &) { return std::pair{false, _Tme()};};
+        }
+    }
+
+    _Tsk Pop() override
+    {
+        std::unique_lock<decltype(mutex_)> lock(mutex_);
+        while (size_ > 0) {
+            Advance(ToTick(std::chrono::steady_clock::now(), false));
+            if (!ready_.empty()) {
+                Node node = std::move(ready_.front());
+                ready_.pop_front();
+                indexes_.erase(node.id);
+                size_--;
+                auto res = node.task;
+                running_.emplace(node.id, std::move(node));
+                return res;
+            }
+            uint64_t next = GetNextEventTick();
+            if (next == NO_TICK) {
+                popCv_.wait(lock);
+            } else {
+                popCv_.wait_until(lock, ToTime(next));
+            }
+            wakeupCount_++;
+        }
+        return INVALID_TSK;
+    }
+
+    bool Push(_Tsk tsk, _Tid id, _Tme tme)
+    {
+        std::unique_lock<decltype(mutex_)> lock(mutex_);
+        if (!tsk.Valid()) {
+            return false;
+        }
+        Place(MakeNode(std::move(tsk), id, tme));
+        size_++;
+        popCv_.notify_all();
+        return true;
+    }
+
+    size_t Size() override
+    {
+        std::lock_guard<decltype(mutex_)> lock(mutex_);
+        return size_;
+    }
+
+    _Tsk Find(_Tid id)
+    {
+        std::unique_lock<decltype(mutex_)> lock(mutex_);
+        auto index = indexes_.find(id);
+        if (index != indexes_.end()) {
+            return index->second.it->task;
+        }
+        return INVALID_TSK;
+    }
+
+    bool Update(_Tid id, TskUpdater updater)
+    {
+        std::unique_lock<decltype(mutex_)> lock(mutex_);
+        auto index = indexes_.find(id);
+        if (index != indexes_.end()) {
+            auto [updated, time] = updater(index->second.it->task);
+            if (!updated) {
+                return false;
+            }
+            Node node = Unlink(index->second);
+            indexes_.erase(index);
+            Place(MakeNode(std::move(node.task), id, time));
+            popCv_.notify_all();
+            return true;
+        }
+
+        auto running = running_.find(id);
+        if (running != running_.end()) {
+            auto [updated, time] = updater(running->second.task);
+            return updated;
+        }
+        return false;
+    }
+
+    bool Remove(_Tid id, bool wait)
+    {
+        std::unique_lock<decltype(mutex_)> lock(mutex_);
+        removeCv_.wait(lock, [this, id, wait] {
+            return !wait || running_.find(id) == running_.end();
+        });
+        auto index = indexes_.find(id);
+        if (index == indexes_.end()) {
+            return false;
+        }
+        Unlink(index->second);
+        indexes_.erase(index);
+        size_--;
+        popCv_.notify_all();
+        return true;
+    }
+
+    void Clean()
+    {
+        std::unique_lock<decltype(mutex_)> lock(mutex_);
+        for (size_t level = 0; level < LEVEL_NUM; level++) {
+            for (auto &slot : slots_[level]) {
+                slot.clear();
+            }
+            occupied_[level] = 0;
+        }
+        ready_.clear();
+        far_.clear();
+        indexes_.clear();
+        size_ = 0;
+        popCv_.notify_all();
+    }
+
+    // The times Pop woke up from waiting, for a task due, a task pushed or a slot to move down.
+    uint64_t GetWakeupCount() const
+    {
+        return wakeupCount_.load();
+    }
+
+    void Finish(_Tid id) override
+    {
+        std::unique_lock<decltype(mutex_)> lock(mutex_);
+        auto it = running_.find(id);
+        if (it == running_.end()) {
+            return;
+        }
+        auto [repeat, time] = updater_(it->second.task);
+        if (repeat) {
+            Place(MakeNode(std::move(it->second.task), id, time));
+            size_++;
+        }
+        running_.erase(it);
+        removeCv_.notify_all();
+    }
+
+private:
+    static constexpr size_t LEVEL_NUM = 3;
+    static constexpr uint32_t SLOT_BITS = 6;
+    static constexpr size_t SLOT_NUM = 1 << SLOT_BITS;
+    static constexpr uint64_t SLOT_MASK = SLOT_NUM - 1;
+    static constexpr size_t READY_LEVEL = LEVEL_NUM;
+    static constexpr size_t FAR_LEVEL = LEVEL_NUM + 1;
+    static constexpr uint64_t NO_TICK = UINT64_MAX;
+
+    struct Node {
+        _Tsk task;
+        _Tid id;
+        // 0 for a task due already.
+        uint64_t tick = 0;
+    };
+    using NodeList = std::list<Node>;
+    struct Location {
+        size_t level = READY_LEVEL;
+        size_t slot = 0;
+        typename NodeList::iterator it;
+    };
+
+    Node MakeNode(_Tsk &&task, _Tid id, _Tme time)
+    {
+        Node node{ std::move(task), id, 0 };
+        if (time > std::chrono::steady_clock::now()) {
+            node.tick = ToTick(time, true);
+        }
+        return node;
+    }
+
+    uint64_t ToTick(_Tme time, bool isRoundUp) const
+    {
+        if (time <= base_) {
+            return 0;
+        }
+        auto elapsed = time - base_;
+        uint64_t tick = static_cast<uint64_t>(elapsed / tick_);
+        if (isRoundUp && elapsed % tick_ != decltype(elapsed)::zero()) {
+            tick++;
+        }
+        return tick;
+    }
+
+    _Tme ToTime(uint64_t tick) const
+    {
+        return base_ + tick_ * static_cast<int64_t>(tick);
+    }
+
+    NodeList &GetList(const Location &location)
+    {
+        if (location.level == READY_LEVEL) {
+            return ready_;
+        }
+        if (location.level == FAR_LEVEL) {
+            return far_;
+        }
+        return slots_[location.level][location.slot];
+    }
+
+    // A task at a level is due 1 to 63 slots of the level after the current tick, so a slot holds the tasks of one
+    // stretch of time only, the one it reaches first.
+    void Place(Node &&node)
+    {
+        Location location;
+        if (node.tick <= current_) {
+            location.level = READY_LEVEL;
+        } else {
+            location.level = FAR_LEVEL;
+            for (size_t level = 0; level < LEVEL_NUM; level++) {
+                uint32_t shift = level * SLOT_BITS;
+                if ((node.tick >> shift) - (current_ >> shift) < SLOT_NUM) {
+                    location.level = level;
+                    location.slot = (node.tick >> shift) & SLOT_MASK;
+                    occupied_[level] |= (1ULL << location.slot);
+                    break;
+                }
+            }
+            if (location.level == FAR_LEVEL && node.tick < farTick_) {
+                farTick_ = node.tick;
+            }
+        }
+        _Tid id = node.id;
+        auto &list = GetList(location);
+        location.it = list.insert(list.end(), std::move(node));
+        indexes_[id] = location;
+    }
+
+    Node Unlink(const Location &location)
+    {
+        auto &list = GetList(location);
+        Node node = std::move(*location.it);
+        list.erase(location.it);
+        if (location.level < LEVEL_NUM && list.empty()) {
+            occupied_[location.level] &= ~(1ULL << location.slot);
+        }
+        return node;
+    }
+
+    // The first tick after the current one at which a slot or the far list is due to be moved down.
+    uint64_t GetNextMoveTick() const
+    {
+        uint64_t next = NO_TICK;
+        for (size_t level = 0; level < LEVEL_NUM; level++) {
+            if (occupied_[level] == 0) {
+                continue;
+            }
+            uint32_t shift = level * SLOT_BITS;
+            uint64_t group = current_ >> shift;
+            uint32_t offset = static_cast<uint32_t>(group & SLOT_MASK);
+            uint64_t rotated = offset == 0 ? occupied_[level] :
+                ((occupied_[level] >> offset) | (occupied_[level] << (SLOT_NUM - offset)));
+            rotated &= ~1ULL;
+            if (rotated != 0) {
+                uint64_t tick = (group + static_cast<uint64_t>(__builtin_ctzll(rotated))) << shift;
+                next = std::min(next, tick);
+            }
+        }
+        if (!far_.empty()) {
+            next = std::min(next, GetFarMoveTick());
+        }
+        return next;
+    }
+
+    // The tick at which the first task of the far list fits in the last level.
+    uint64_t GetFarMoveTick() const
+    {
+        constexpr uint32_t shift = (LEVEL_NUM - 1) * SLOT_BITS;
+        uint64_t group = farTick_ >> shift;
+        uint64_t tick = group >= SLOT_NUM ? (group - (SLOT_NUM - 1)) << shift : 0;
+        return std::max(tick, current_);
+    }
+
+    uint64_t GetNextEventTick() const
+    {
+        return ready_.empty() ? GetNextMoveTick() : current_;
+    }
+
+    void MoveDown(NodeList &list)
+    {
+        NodeList nodes;
+        nodes.swap(list);
+        for (auto &node : nodes) {
+            Place(std::move(node));
+        }
+    }
+
+    void Advance(uint64_t tick)
+    {
+        for (uint64_t next = GetNextMoveTick(); next != NO_TICK && next <= tick; next = GetNextMoveTick()) {
+            current_ = next;
+            if (!far_.empty() && GetFarMoveTick() <= current_) {
+                farTick_ = NO_TICK;
+                MoveDown(far_);
+            }
+            for (size_t level = LEVEL_NUM; level-- > 0;) {
+                uint32_t shift = level * SLOT_BITS;
+                size_t slot = (current_ >> shift) & SLOT_MASK;
+                if ((current_ & ((1ULL << shift) - 1)) != 0 || (occupied_[level] & (1ULL << slot)) == 0) {
+                    continue;
+                }
+                occupied_[level] &= ~(1ULL << slot);
+                MoveDown(slots_[level][slot]);
+            }
+        }
+        current_ = std::max(current_, tick);
+    }
+
+    const _Tsk INVALID_TSK;
+    TskUpdater updater_;
+    const std::chrono::milliseconds tick_;
+    const _Tme base_;
+    std::mutex mutex_;
+    std::condition_variable popCv_;
+    std::condition_variable removeCv_;
+    uint64_t current_ = 0;
+    size_t size_ = 0;
+    NodeList slots_[LEVEL_NUM][SLOT_NUM];
+    uint64_t occupied_[LEVEL_NUM] = { 0 };
+    NodeList ready_;
+    NodeList far_;
+    uint64_t farTick_ = NO_TICK;
+    std::unordered_map<_Tid, Location> indexes_;
+    std::map<_Tid, Node> running_;
+    std::atomic<uint64_t> wakeupCount_ = 0;
+};
+} // namespace NativePreferences
+} // namespace OHOS
+#endif // PREFERENCES_TIMER_WHEEL_H
@@ -0,0 +1,274 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PREFERENCES_FRAMEWORKS_WORK_STEALING_POOL_H
+#define PREFERENCES_FRAMEWORKS_WORK_STEALING_POOL_H
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "preferences_thread.h"
+
+namespace OHOS {
+namespace NativePreferences {
+// Runs the tasks on a fixed number of workers, each of them with its own deque. A task submitted by a worker goes
+// to its deque, a task submitted by another thread goes to a lock free ring shared by the workers. A worker without
+// tasks steals from the deques of the others, spins for a while and then parks until a task is submitted.
+// The workers start with the first task and stop with the pool, the tasks not started by then are dropped.
+class WorkStealingPool {
+public:
+    using Task = std::function<void()>;
+
+    explicit WorkStealingPool(size_t workerNum) : workerNum_(workerNum == 0 ? 1 : workerNum)
+    {
+        cells_ = std::make_unique<Cell[]>(RING_CAPACITY);
+        for (size_t i = 0; i < RING_CAPACITY; i++) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        for (size_t i = 0; i < workerNum_; i++) {
+            workers_.push_back(std::make_unique<Worker>());
+        }
+    }
+
+    ~WorkStealingPool()
+    {
+        isStopping_ = true;
+        {
+            std::lock_guard<decltype(parkMutex_)> lock(parkMutex_);
+            parkCv_.notify_all();
+        }
+        for (auto &worker : workers_) {
+            if (worker->thread.joinable()) {
+                worker->thread.join();
+            }
+        }
+    }
+
+    bool Submit(Task task)
+    {
+        if (isStopping_) {
+            return false;
+        }
+        std::call_once(startFlag_, [this] {
+            for (size_t i = 0; i < workerNum_; i++) {
+                workers_[i]->thread = std::thread([this, i] { Run(i); });
+            }
+            isStarted_ = true;
+        });
+        auto &current = GetCurrent();
+        if (current.first == this) {
+            auto &worker = *workers_[current.second];
+            std::lock_guard<decltype(worker.mutex)> lock(worker.mutex);
+            worker.tasks.push_back(std::move(task));
+        } else if (!PushRing(task)) {
+            std::lock_guard<decltype(overflowMutex_)> lock(overflowMutex_);
+            overflow_.push_back(std::move(task));
+            overflowSize_++;
+        }
+        Wake();
+        return true;
+    }
+
+    // The worker threads, 0 until the first task starts them.
+    size_t WorkerNum() const
+    {
+        return isStarted_ ? workerNum_ : 0;
+    }
+
+private:
+    static constexpr size_t RING_CAPACITY = 1024;
+    static constexpr size_t RING_MASK = RING_CAPACITY - 1;
+    static constexpr uint32_t SPIN_COUNT = 64;
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    struct alignas(CACHE_LINE_SIZE) Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+        std::thread thread;
+    };
+
+    struct Cell {
+        std::atomic<size_t> sequence;
+        Task task;
+    };
+
+    // The pool and the index of the worker running on this thread.
+    static std::pair<WorkStealingPool *, size_t> &GetCurrent()
+    {
+        static thread_local std::pair<WorkStealingPool *, size_t> current{ nullptr, 0 };
+        return current;
+    }
+
+    // The bounded queue of Dmitry Vyukov, a cell belongs to the thread that moved the position past it.
+    bool PushRing(Task &task)
+    {
+        Cell *cell = nullptr;
+        size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+        for (;;) {
+            cell = &cells_[pos & RING_MASK];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueuePos_.load(std::memory_order_relaxed);
+            }
+        }
+        cell->task = std::move(task);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool PopRing(Task &task)
+    {
+        Cell *cell = nullptr;
+        size_t pos = dequeuePos_.load(std::memory_order_relaxed);
+        for (;;) {
+            cell = &cells_[pos & RING_MASK];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = dequeuePos_.load(std::memory_order_relaxed);
+            }
+        }
+        task = std::move(cell->task);
+        cell->task = nullptr;
+        cell->sequence.store(pos + RING_CAPACITY, std::memory_order_release);
+        return true;
+    }
+
+    bool PopOverflow(Task &task)
+    {
+        if (overflowSize_.load() == 0) {
+            return false;
+        }
+        std::lock_guard<decltype(overflowMutex_)> lock(overflowMutex_);
+        if (overflow_.empty()) {
+            return false;
+        }
+        task = std::move(overflow_.front());
+        overflow_.pop_front();
+        overflowSize_--;
+        return true;
+    }
+
+    // A worker takes the newest task of its deque and steals the oldest task of the others.
+    bool FindTask(size_t index, Task &task)
+    {
+        auto &worker = *workers_[index];
+        {
+            std::lock_guard<decltype(worker.mutex)> lock(worker.mutex);
+            if (!worker.tasks.empty()) {
+                task = std::move(worker.tasks.back());
+                worker.tasks.pop_back();
+                return true;
+            }
+        }
+        if (PopRing(task) || PopOverflow(task)) {
+            return true;
+        }
+        // the deque of a busy worker is skipped, the worker empties it itself.
+        for (size_t i = 1; i < workerNum_; i++) {
+            auto &victim = *workers_[(index + i) % workerNum_];
+            std::unique_lock<decltype(victim.mutex)> lock(victim.mutex, std::try_to_lock);
+            if (lock.owns_lock() && !victim.tasks.empty()) {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // A worker parks after it read the epoch and found no task, so a task submitted later changes the epoch.
+    void Wake()
+    {
+        epoch_.fetch_add(1);
+        if (parkedNum_.load() > 0) {
+            std::lock_guard<decltype(parkMutex_)> lock(parkMutex_);
+            parkCv_.notify_one();
+        }
+    }
+
+    void Run(size_t index)
+    {
+        GetCurrent() = { this, index };
+        PthreadSetNameNp("WorkStealing");
+        uint32_t spinCount = 0;
+        while (!isStopping_) {
+            Task task;
+            if (FindTask(index, task)) {
+                task();
+                spinCount = 0;
+                continue;
+            }
+            if (spinCount < SPIN_COUNT) {
+                spinCount++;
+                std::this_thread::yield();
+                continue;
+            }
+            uint64_t epoch = epoch_.load();
+            parkedNum_++;
+            if (FindTask(index, task)) {
+                parkedNum_--;
+                task();
+                spinCount = 0;
+                continue;
+            }
+            {
+                std::unique_lock<decltype(parkMutex_)> lock(parkMutex_);
+                parkCv_.wait(lock, [this, epoch] { return isStopping_ || epoch_.load() != epoch; });
+            }
+            parkedNum_--;
+            spinCount = 0;
+        }
+        GetCurrent() = { nullptr, 0 };
+    }
+
+    const size_t workerNum_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::unique_ptr<Cell[]> cells_;
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> enqueuePos_ = 0;
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> dequeuePos_ = 0;
+    std::mutex overflowMutex_;
+    std::deque<Task> overflow_;
+    std::atomic<size_t> overflowSize_ = 0;
+    std::mutex parkMutex_;
+    std::condition_variable parkCv_;
+    std::atomic<uint64_t> epoch_ = 0;
+    std::atomic<size_t> parkedNum_ = 0;
+    std::atomic<bool> isStopping_ = false;
+    std::once_flag startFlag_;
+    std::atomic<bool> isStarted_ = false;
+};
+} // namespace NativePreferences
+} // namespace OHOS
+#endif // PREFERENCES_FRAMEWORKS_WORK_STEALING_POOL_H
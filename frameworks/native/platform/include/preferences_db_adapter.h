@@ -17,9 +17,11 @@
 #define PREFERENCES_DB_ADAPTER_H
 
 #include <atomic>
+#include <condition_variable>
 #include <vector>
 #include <shared_mutex>
 #include <list>
+#include <memory>
 #include <string>
 #include "preferences_dfx_adapter.h"
 
@@ -151,30 +153,72 @@ public:
     static thread_local std::string eventInfo_;
 };
 
+class PreferencesDb;
+
+// Reads the table from a result set, holding a read connection of the db until destroyed.
+class PreferencesDbIterator {
+public:
+    ~PreferencesDbIterator();
+    // The key and value point to memory of the result set, valid until the next call. Returns E_NO_DATA after the
+    // last entry.
+    int Next(GRD_KVItemT &key, GRD_KVItemT &value);
+
+private:
+    friend class PreferencesDb;
+    PreferencesDbIterator(PreferencesDb &db, GRD_DB *readDb, GRD_ResultSet *resultSet);
+    void FreeItems();
+
+    PreferencesDb &db_;
+    GRD_DB *readDb_ = nullptr;
+    GRD_ResultSet *resultSet_ = nullptr;
+    GRD_KVItemT key_ = { nullptr, 0 };
+    GRD_KVItemT value_ = { nullptr, 0 };
+    // used when the library has no fetch api, the entries are copied into them.
+    std::vector<uint8_t> keyBuffer_;
+    std::vector<uint8_t> valueBuffer_;
+};
+
 class PreferencesDb {
 public:
     PreferencesDb();
     ~PreferencesDb();
     int Init(const std::string &dbPath, const std::string &bundleName);
-    int Put(const std::vector<uint8_t> &key, const std::vector<uint8_t> &value);
-    int Delete(const std::vector<uint8_t> &key);
-    int Get(const std::vector<uint8_t> &key, std::vector<uint8_t> &value);
-    int GetAll(std::list<std::pair<std::vector<uint8_t>, std::vector<uint8_t>>> &data);
+    int Put(const std::string &key, const std::vector<uint8_t> &value);
+    int Delete(const std::string &key);
+    // The value points to the memory of the db, which must be released by FreeItem.
+    int Get(const std::string &key, GRD_KVItemT &value);
+    void FreeItem(GRD_KVItemT &item);
+    // The value of the key is released in the db, it is neither copied nor decoded.
+    int HasKey(const std::string &key, bool &isExist);
+    // Reads from beginKey on in key order, or all the table when it is null.
+    int CreateIterator(std::unique_ptr<PreferencesDbIterator> &iterator, const std::string *beginKey = nullptr);
     int DropCollection();
     int CreateCollection();
-    int GetAllInner(std::list<std::pair<std::vector<uint8_t>, std::vector<uint8_t>>> &data, GRD_ResultSet *resultSet);
     int OpenDb(bool isNeedRebuild);
     int CloseDb();
     int RepairDb();
     int TryRepairAndRebuild(int openCode);
     int GetKernelDataVersion(int64_t &dataVersion);
 private:
+    friend class PreferencesDbIterator;
     GRD_KVItemT BlobToKvItem(const std::vector<uint8_t> &blob);
-    std::vector<uint8_t> KvItemToBlob(GRD_KVItemT &item);
+    GRD_KVItemT StringToKvItem(const std::string &str);
     ReportParam GetReportParam(const std::string &info, uint32_t errCode);
+    int CreateCollection(GRD_DB *db);
+    GRD_DB *OpenReadDb();
+    // Get and GetKernelDataVersion run on a connection of their own, so the readers do not share a handle. The
+    // connection of the writes is one of them, the callers must not read while they write.
+    GRD_DB *AcquireReadDb();
+    void ReleaseReadDb(GRD_DB *db);
+    void CloseReadDbs();
     GRD_DB *db_ = nullptr;
     std::string dbPath_ = "";
     std::string bundleName_ = "";
+    std::mutex readDbMutex_;
+    std::condition_variable readDbCond_;
+    std::vector<GRD_DB *> idleReadDbs_;
+    std::vector<GRD_DB *> readDbs_;
+    bool isReadDbLimited_ = false;
 };
 
 // grd errcode
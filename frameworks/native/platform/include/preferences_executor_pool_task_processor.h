@@ -25,11 +25,16 @@ namespace OHOS {
 namespace NativePreferences {
 class PreferencesExecutorPoolTaskProcessor final : public PreferencesTaskProcessor {
 public:
-    bool Execute(const Task &task) override;
+    bool Execute(TaskLane lane, Task task) override;
+    bool Schedule(TaskLane lane, std::chrono::milliseconds delay, Task task) override;
     static bool Init();
 
+protected:
+    void FillBackendStats(TaskLane lane, TaskLaneStats &stats) override;
+
 private:
-    static ExecutorPool executorPool_;
+    // One pool for each lane, with as many threads as the concurrency of the lane.
+    static ExecutorPool &GetPool(TaskLane lane);
 };
 } // namespace NativePreferences
 } // namespace OHOS
@@ -25,8 +25,13 @@ namespace OHOS {
 namespace NativePreferences {
 class PreferencesFfrtTaskProcessor final : public PreferencesTaskProcessor {
 public:
-    bool Execute(const Task &task) override;
+    bool Execute(TaskLane lane, Task task) override;
+    bool Schedule(TaskLane lane, std::chrono::milliseconds delay, Task task) override;
     static bool Init();
+
+private:
+    // One queue for each lane, at the qos and with the concurrency of the lane.
+    static ffrt::queue &GetQueue(TaskLane lane);
 };
 } // namespace NativePreferences
 } // namespace OHOS
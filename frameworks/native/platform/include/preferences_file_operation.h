@@ -19,10 +19,13 @@
 #include <sys/stat.h>
 #include <unistd.h>
 
+#include <cerrno>
 #include <string>
+#include <vector>
 
 #include "visibility.h"
 #include "preferences_anonymous.h"
+#include "preferences_vfs.h"
 
 #ifndef _WIN32
 #include <dlfcn.h>
@@ -77,69 +80,94 @@ static UNUSED_FUNCTION void *DBDlOpen()
 
 static UNUSED_FUNCTION int Mkdir(const std::string &filePath)
 {
-#if defined(WINDOWS_PLATFORM)
-    return mkdir(filePath.c_str());
-#else
-    return mkdir(filePath.c_str(), FILE_MODE);
-#endif
+    return PreferencesVfs::GetInstance()->Mkdir(filePath);
 }
 
 static UNUSED_FUNCTION int Access(const std::string &filePath)
 {
-#if defined(WINDOWS_PLATFORM)
-    return _access(filePath.c_str(), FILE_EXIST);
-#else
-    return access(filePath.c_str(), FILE_EXIST);
-#endif
+    return PreferencesVfs::GetInstance()->Access(filePath);
 }
 
 static UNUSED_FUNCTION int Open(const std::string &filePath)
 {
 #if defined(WINDOWS_PLATFORM)
-    return _open(filePath.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC, _S_IREAD | _S_IWRITE);
+    return PreferencesVfs::GetInstance()->Open(filePath, _O_WRONLY | _O_CREAT | _O_TRUNC, _S_IREAD | _S_IWRITE);
 #else
-    return open(filePath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0660);
+    return PreferencesVfs::GetInstance()->Open(filePath, O_WRONLY | O_CREAT | O_TRUNC, 0660);
 #endif
 }
 
 static UNUSED_FUNCTION int Write(int fd, const unsigned char *buffer, ssize_t count)
 {
-#if defined(WINDOWS_PLATFORM)
-    HANDLE hFile = (HANDLE)_get_osfhandle(fd); // 转换文件描述符为 HANDLE
-    if (hFile == INVALID_HANDLE_VALUE) {
-        return -1;
-    }
-    DWORD bytesWritten = 0;
-    return WriteFile(hFile, buffer, (DWORD)count, &bytesWritten, NULL) ? (int)bytesWritten : -1;
-#else
-    return write(fd, buffer, count);
-#endif
+    return static_cast<int>(PreferencesVfs::GetInstance()->Write(fd, buffer, count));
 }
 
 static UNUSED_FUNCTION int Close(int fd)
 {
-#if defined(WINDOWS_PLATFORM)
-    return _close(fd);
-#else
-    return close(fd);
-#endif
+    return PreferencesVfs::GetInstance()->Close(fd);
 }
 
 static UNUSED_FUNCTION bool Fsync(int fd)
 {
+    return PreferencesVfs::GetInstance()->Fsync(fd) == 0;
+}
+
+static UNUSED_FUNCTION int WriteAndSync(int fd, const unsigned char *buffer, ssize_t count, bool &isSynced)
+{
+    return static_cast<int>(PreferencesVfs::GetInstance()->WriteAndSync(fd, buffer, count, isSynced));
+}
+
+static UNUSED_FUNCTION int Rename(const std::string &oldPath, const std::string &newPath)
+{
+    return PreferencesVfs::GetInstance()->Rename(oldPath, newPath);
+}
+
+static UNUSED_FUNCTION int Remove(const std::string &filePath)
+{
+    return PreferencesVfs::GetInstance()->Remove(filePath);
+}
+
+static UNUSED_FUNCTION int Stat(const std::string &filePath, struct stat &buffer)
+{
+    return PreferencesVfs::GetInstance()->Stat(filePath, buffer);
+}
+
+static UNUSED_FUNCTION bool ReadFileContent(const std::string &filePath, std::vector<uint8_t> &content)
+{
+    auto vfs = PreferencesVfs::GetInstance();
 #if defined(WINDOWS_PLATFORM)
-    HANDLE handle = (HANDLE)_get_osfhandle(fd);
-    if (handle == INVALID_HANDLE_VALUE || !FlushFileBuffers(handle)) {
-        return false;
-    }
+    int fd = vfs->Open(filePath, _O_RDONLY, 0);
 #else
+    int fd = vfs->Open(filePath, O_RDONLY, 0);
+#endif
     if (fd == -1) {
         return false;
     }
-    if (fsync(fd) == -1) {
-        return false;
+    struct stat buffer;
+    size_t size = (vfs->Stat(filePath, buffer) == 0 && buffer.st_size > 0) ? static_cast<size_t>(buffer.st_size) : 0;
+    content.resize(size + 1);
+    size_t offset = 0;
+    while (true) {
+        if (offset == content.size()) {
+            content.resize(content.size() * 2);
+        }
+        ssize_t ret = vfs->Read(fd, content.data() + offset, content.size() - offset);
+        if (ret < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ret < 0) {
+            int errCode = errno;
+            vfs->Close(fd);
+            errno = errCode;
+            return false;
+        }
+        if (ret == 0) {
+            break;
+        }
+        offset += static_cast<size_t>(ret);
     }
-#endif
+    content.resize(offset);
+    vfs->Close(fd);
     return true;
 }
 
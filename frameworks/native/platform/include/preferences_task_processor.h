@@ -16,20 +16,98 @@
 #ifndef PREFERENCES_TASK_PROCESSOR_H
 #define PREFERENCES_TASK_PROCESSOR_H
  
+#include <array>
+#include <chrono>
+#include <cstdint>
 #include <functional>
+#include <vector>
  
 namespace OHOS {
 namespace NativePreferences {
 using Task = std::function<void()>;
+
+// The lanes run their tasks apart, so a slow task of a lane only delays the tasks of the same lane.
+enum class TaskLane : uint8_t {
+    LOAD = 0,
+    FLUSH,
+    NOTIFY,
+    DFX,
+    BUTT
+};
+
+struct TaskLaneConfig {
+    const char *name;
+    // The tasks of a lane with a concurrency of 1 run in the order they are due.
+    int32_t concurrency;
+    // The FFRT qos of the lane.
+    int32_t qos;
+};
+
+// The latency buckets are below 0.1, 1, 10, 100 and 1000 milliseconds, the last one holds the longer latencies.
+constexpr size_t LATENCY_BUCKET_NUM = 6;
+using LatencyHistogram = std::array<uint64_t, LATENCY_BUCKET_NUM>;
+
+struct TaskLaneStats {
+    uint64_t submitCount = 0;
+    uint64_t finishCount = 0;
+    // The tasks submitted but not started yet, the delayed ones included.
+    uint64_t queueDepth = 0;
+    uint64_t maxQueueDepth = 0;
+    // The time in microseconds from the due time of the tasks to their start.
+    uint64_t totalWaitTime = 0;
+    uint64_t maxWaitTime = 0;
+    LatencyHistogram waitTimeHistogram = {};
+    // The time in microseconds the finished tasks took to run.
+    uint64_t totalRunTime = 0;
+    uint64_t maxRunTime = 0;
+    LatencyHistogram runTimeHistogram = {};
+    // The threads running the lane and the wakeups of its delay scheduler, 0 when the backend does not expose them.
+    uint64_t executorNum = 0;
+    uint64_t schedulerWakeupCount = 0;
+};
+
+// The stats of a pool of the module that runs its tasks apart from the lanes.
+struct TaskPoolStats {
+    const char *name = "";
+    uint64_t executorNum = 0;
+    // The tasks waiting to start and the delayed ones not due yet.
+    uint64_t queuedTaskNum = 0;
+    uint64_t delayedTaskNum = 0;
+    uint64_t schedulerWakeupCount = 0;
+};
+using TaskPoolStatsGetter = std::function<TaskPoolStats()>;
+
 class PreferencesTaskProcessor {
 public:
     static PreferencesTaskProcessor *GetInstance();
     virtual ~PreferencesTaskProcessor() = default;
-    virtual bool Execute(const Task &task) = 0;
+    // Runs the task in the load lane.
+    bool Execute(const Task &task);
+    virtual bool Execute(TaskLane lane, Task task) = 0;
+    virtual bool Schedule(TaskLane lane, std::chrono::milliseconds delay, Task task) = 0;
     static bool RegisterTaskProcessor(PreferencesTaskProcessor *instance);
+    static const TaskLaneConfig &GetLaneConfig(TaskLane lane);
+    static TaskLaneStats GetLaneStats(TaskLane lane);
+    // The lane of the task running on the calling thread, BUTT when the thread is not running one.
+    static TaskLane GetCurrentLane();
+    // Logs the stats of all the lanes at the interval from the dfx lane, an interval of 0 stops it.
+    static void SetStatsDumpInterval(std::chrono::milliseconds interval);
+    static void DumpStats();
+    // Adds the pool to GetPoolStats and DumpStats, the getter fills all the stats but the name.
+    static bool RegisterPoolStats(const char *name, TaskPoolStatsGetter getter);
+    static std::vector<TaskPoolStats> GetPoolStats();
+
+protected:
+    // Fills the stats kept by the backend, the executorNum and schedulerWakeupCount.
+    virtual void FillBackendStats(TaskLane lane, TaskLaneStats &stats) {}
+
+    // Counts the task in the stats of the lane until it finishes, Untrack undoes it when the task is not submitted.
+    static Task Track(TaskLane lane, Task task, std::chrono::milliseconds delay = std::chrono::milliseconds(0));
+    static void Untrack(TaskLane lane);
+
 private:
     static PreferencesTaskProcessor *instance_;
 };
 } // namespace NativePreferences
 } // namespace OHOS
-#endif
\ No newline at end of file
+#endif
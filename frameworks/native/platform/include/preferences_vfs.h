@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PREFERENCES_VFS_H
+#define PREFERENCES_VFS_H
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include <array>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace OHOS {
+namespace NativePreferences {
+
+enum class VfsOperation {
+    OPEN,
+    READ,
+    WRITE,
+    FSYNC,
+    CLOSE,
+    RENAME,
+    REMOVE,
+    STAT,
+    ACCESS,
+    MKDIR,
+    LOCK,
+    BUTT
+};
+
+// All the file accesses of preferences go through this interface. The functions follow the POSIX conventions:
+// -1 is returned with errno set on failure.
+class PreferencesVfs {
+public:
+    virtual ~PreferencesVfs() = default;
+    virtual int Open(const std::string &path, int flags, mode_t mode) = 0;
+    virtual ssize_t Read(int fd, void *buffer, size_t count) = 0;
+    virtual ssize_t Write(int fd, const void *buffer, size_t count) = 0;
+    virtual int Fsync(int fd) = 0;
+    virtual int Close(int fd) = 0;
+    virtual int Rename(const std::string &oldPath, const std::string &newPath) = 0;
+    virtual int Remove(const std::string &path) = 0;
+    virtual int Stat(const std::string &path, struct stat &buffer) = 0;
+    virtual int Access(const std::string &path) = 0;
+    virtual int Mkdir(const std::string &path) = 0;
+    // Sets or releases (F_UNLCK) an advisory lock on the whole file without waiting.
+    virtual int Lock(int fd, short lockType) = 0;
+    // Writes the buffer and syncs the data, isSynced reports the result of the sync.
+    virtual ssize_t WriteAndSync(int fd, const void *buffer, size_t count, bool &isSynced);
+
+    static std::shared_ptr<PreferencesVfs> GetInstance();
+    // Replaces the file system of the process, nullptr restores the real one. It must be called while no file
+    // of preferences is open.
+    static void SetInstance(std::shared_ptr<PreferencesVfs> vfs);
+};
+
+class PreferencesPosixVfs final : public PreferencesVfs {
+public:
+    int Open(const std::string &path, int flags, mode_t mode) override;
+    ssize_t Read(int fd, void *buffer, size_t count) override;
+    ssize_t Write(int fd, const void *buffer, size_t count) override;
+    int Fsync(int fd) override;
+    int Close(int fd) override;
+    int Rename(const std::string &oldPath, const std::string &newPath) override;
+    int Remove(const std::string &path) override;
+    int Stat(const std::string &path, struct stat &buffer) override;
+    int Access(const std::string &path) override;
+    int Mkdir(const std::string &path) override;
+    int Lock(int fd, short lockType) override;
+};
+
+// Keeps the files in memory, used to measure the costs which do not come from the storage.
+class PreferencesMemoryVfs final : public PreferencesVfs {
+public:
+    int Open(const std::string &path, int flags, mode_t mode) override;
+    ssize_t Read(int fd, void *buffer, size_t count) override;
+    ssize_t Write(int fd, const void *buffer, size_t count) override;
+    int Fsync(int fd) override;
+    int Close(int fd) override;
+    int Rename(const std::string &oldPath, const std::string &newPath) override;
+    int Remove(const std::string &path) override;
+    int Stat(const std::string &path, struct stat &buffer) override;
+    int Access(const std::string &path) override;
+    int Mkdir(const std::string &path) override;
+    int Lock(int fd, short lockType) override;
+
+private:
+    using Content = std::shared_ptr<std::vector<uint8_t>>;
+    struct OpenFile {
+        Content content;
+        size_t offset = 0;
+    };
+    bool IsDirectory(const std::string &path);
+
+    std::mutex mutex_;
+    std::map<std::string, Content> files_;
+    std::set<std::string> directories_;
+    std::map<int, OpenFile> openFiles_;
+    int nextFd_ = 1;
+};
+
+// Forwards to another file system after the configured latency, or fails with the configured errno.
+class PreferencesFaultVfs final : public PreferencesVfs {
+public:
+    explicit PreferencesFaultVfs(std::shared_ptr<PreferencesVfs> base);
+    void SetFault(VfsOperation operation, std::chrono::microseconds latency, int errCode = 0);
+    void ClearFaults();
+
+    int Open(const std::string &path, int flags, mode_t mode) override;
+    ssize_t Read(int fd, void *buffer, size_t count) override;
+    ssize_t Write(int fd, const void *buffer, size_t count) override;
+    int Fsync(int fd) override;
+    int Close(int fd) override;
+    int Rename(const std::string &oldPath, const std::string &newPath) override;
+    int Remove(const std::string &path) override;
+    int Stat(const std::string &path, struct stat &buffer) override;
+    int Access(const std::string &path) override;
+    int Mkdir(const std::string &path) override;
+    int Lock(int fd, short lockType) override;
+
+private:
+    struct Fault {
+        std::chrono::microseconds latency{ 0 };
+        int errCode = 0;
+    };
+    // Sleeps for the latency, returns false with errno set if the operation must fail.
+    bool Inject(VfsOperation operation);
+
+    std::shared_ptr<PreferencesVfs> base_;
+    std::mutex mutex_;
+    std::array<Fault, static_cast<size_t>(VfsOperation::BUTT)> faults_;
+};
+} // namespace NativePreferences
+} // namespace OHOS
+#endif // PREFERENCES_VFS_H
@@ -44,6 +44,7 @@ const char * const CONFIG_STR =
     "\"sharedModeEnable\" : 1, \"MetaInfoBak\": 1}";
 const int CREATE_COLLECTION_RETRY_TIMES = 2;
 const int DB_REPAIR_RETRY_TIMES = 3;
+const size_t MAX_READ_DB_NUM = 4;
 
 void GRDDBApiInitEnhance(GRD_APIInfo &GRD_DBApiInfo)
 {
@@ -165,6 +166,7 @@ PreferencesDb::PreferencesDb()
 
 PreferencesDb::~PreferencesDb()
 {
+    CloseReadDbs();
     if (db_ != nullptr || PreferenceDbAdapter::GetApiInstance().DbCloseApi != nullptr) {
         PreferenceDbAdapter::GetApiInstance().DbCloseApi(db_, GRD_DB_CLOSE_IGNORE_ERROR);
         db_ = nullptr;
@@ -194,10 +196,13 @@ int PreferencesDb::CloseDb()
             LOG_ERROR("api load failed: DbCloseApi");
             return E_ERROR;
         }
+        CloseReadDbs();
         int errCode = PreferenceDbAdapter::GetApiInstance().DbCloseApi(db_, GRD_DB_CLOSE_IGNORE_ERROR);
         if (errCode != E_OK) {
             LOG_ERROR("close db failed, errcode=%{public}d, file: %{public}s", errCode,
                 ExtractFileName(dbPath_).c_str());
+            std::lock_guard<std::mutex> lock(readDbMutex_);
+            idleReadDbs_.push_back(db_);
             return TransferGrdErrno(errCode);
         }
         LOG_INFO("db has been closed.");
@@ -209,12 +214,17 @@ int PreferencesDb::CloseDb()
 }
 
 int PreferencesDb::CreateCollection()
+{
+    return CreateCollection(db_);
+}
+
+int PreferencesDb::CreateCollection(GRD_DB *db)
 {
     if (PreferenceDbAdapter::GetApiInstance().DbCreateCollectionApi == nullptr) {
         LOG_ERROR("api load failed: DbCreateCollectionApi");
         return E_ERROR;
     }
-    int errCode = PreferenceDbAdapter::GetApiInstance().DbCreateCollectionApi(db_, TABLENAME,
+    int errCode = PreferenceDbAdapter::GetApiInstance().DbCreateCollectionApi(db, TABLENAME,
         TABLE_MODE, 0);
     if (errCode != GRD_OK) {
         LOG_ERROR("rd create table failed:%{public}d", errCode);
@@ -330,10 +340,68 @@ int PreferencesDb::Init(const std::string &dbPath, const std::string &bundleName
         LOG_ERROR("Init: Index preload FAILED %{public}d", errCode);
         return errCode;
     }
+    std::lock_guard<std::mutex> lock(readDbMutex_);
+    idleReadDbs_ = { db_ };
     return errCode;
 }
 
-int PreferencesDb::Put(const std::vector<uint8_t> &key, const std::vector<uint8_t> &value)
+GRD_DB *PreferencesDb::OpenReadDb()
+{
+    GRD_DB *readDb = nullptr;
+    int errCode = PreferenceDbAdapter::GetApiInstance().DbOpenApi(dbPath_.c_str(), CONFIG_STR,
+        GRD_DB_OPEN_CREATE, &readDb);
+    if (errCode != GRD_OK || readDb == nullptr) {
+        LOG_WARN("open read db failed, errCode: %{public}d, readers share %{public}zu connections.", errCode,
+            readDbs_.size() + 1);
+        return nullptr;
+    }
+    (void)PreferenceDbAdapter::GetApiInstance().DbIndexPreloadApi(readDb, TABLENAME);
+    return readDb;
+}
+
+GRD_DB *PreferencesDb::AcquireReadDb()
+{
+    std::unique_lock<std::mutex> lock(readDbMutex_);
+    while (idleReadDbs_.empty()) {
+        if (!isReadDbLimited_ && readDbs_.size() + 1 < MAX_READ_DB_NUM) {
+            GRD_DB *readDb = OpenReadDb();
+            if (readDb != nullptr) {
+                readDbs_.push_back(readDb);
+                return readDb;
+            }
+            isReadDbLimited_ = true;
+            continue;
+        }
+        readDbCond_.wait(lock);
+    }
+    GRD_DB *readDb = idleReadDbs_.back();
+    idleReadDbs_.pop_back();
+    return readDb;
+}
+
+void PreferencesDb::ReleaseReadDb(GRD_DB *db)
+{
+    {
+        std::lock_guard<std::mutex> lock(readDbMutex_);
+        idleReadDbs_.push_back(db);
+    }
+    readDbCond_.notify_one();
+}
+
+void PreferencesDb::CloseReadDbs()
+{
+    std::lock_guard<std::mutex> lock(readDbMutex_);
+    if (PreferenceDbAdapter::GetApiInstance().DbCloseApi != nullptr) {
+        for (GRD_DB *readDb : readDbs_) {
+            (void)PreferenceDbAdapter::GetApiInstance().DbCloseApi(readDb, GRD_DB_CLOSE_IGNORE_ERROR);
+        }
+    }
+    readDbs_.clear();
+    idleReadDbs_.clear();
+    isReadDbLimited_ = false;
+}
+
+int PreferencesDb::Put(const std::string &key, const std::vector<uint8_t> &value)
 {
     if (db_ == nullptr) {
         LOG_ERROR("Put failed, db has been closed.");
@@ -343,7 +411,7 @@ int PreferencesDb::Put(const std::vector<uint8_t> &key, const std::vector<uint8_
         return E_ERROR;
     }
 
-    GRD_KVItemT innerKey = BlobToKvItem(key);
+    GRD_KVItemT innerKey = StringToKvItem(key);
     GRD_KVItemT innerVal = BlobToKvItem(value);
 
     int retryTimes = CREATE_COLLECTION_RETRY_TIMES;
@@ -367,7 +435,7 @@ int PreferencesDb::Put(const std::vector<uint8_t> &key, const std::vector<uint8_
     return TransferGrdErrno(ret);
 }
 
-int PreferencesDb::Delete(const std::vector<uint8_t> &key)
+int PreferencesDb::Delete(const std::string &key)
 {
     if (db_ == nullptr) {
         LOG_ERROR("Delete failed, db has been closed.");
@@ -377,7 +445,7 @@ int PreferencesDb::Delete(const std::vector<uint8_t> &key)
         return E_ERROR;
     }
 
-    GRD_KVItemT innerKey = BlobToKvItem(key);
+    GRD_KVItemT innerKey = StringToKvItem(key);
 
     int retryTimes = CREATE_COLLECTION_RETRY_TIMES;
     int ret = E_OK;
@@ -400,7 +468,7 @@ int PreferencesDb::Delete(const std::vector<uint8_t> &key)
     return TransferGrdErrno(ret);
 }
 
-int PreferencesDb::Get(const std::vector<uint8_t> &key, std::vector<uint8_t> &value)
+int PreferencesDb::Get(const std::string &key, GRD_KVItemT &value)
 {
     if (db_ == nullptr) {
         LOG_ERROR("Get failed, db has been closed.");
@@ -411,16 +479,17 @@ int PreferencesDb::Get(const std::vector<uint8_t> &key, std::vector<uint8_t> &va
         return E_ERROR;
     }
 
-    GRD_KVItemT innerKey = BlobToKvItem(key);
+    GRD_KVItemT innerKey = StringToKvItem(key);
     GRD_KVItemT innerVal = { NULL, 0 };
 
+    GRD_DB *readDb = AcquireReadDb();
     int retryTimes = CREATE_COLLECTION_RETRY_TIMES;
     int ret = GRD_OK;
     do {
-        ret = PreferenceDbAdapter::GetApiInstance().DbKvGetApi(db_, TABLENAME, &innerKey, &innerVal);
+        ret = PreferenceDbAdapter::GetApiInstance().DbKvGetApi(readDb, TABLENAME, &innerKey, &innerVal);
         if (ret == GRD_UNDEFINED_TABLE) {
             LOG_INFO("CreateCollection called when Get, file: %{public}s", ExtractFileName(dbPath_).c_str());
-            (void)CreateCollection();
+            (void)CreateCollection(readDb);
         } else {
             if (ret == GRD_OK) {
                 break;
@@ -428,44 +497,44 @@ int PreferencesDb::Get(const std::vector<uint8_t> &key, std::vector<uint8_t> &va
             if (ret != GRD_NO_DATA) {
                 LOG_ERROR("rd get failed:%{public}d", ret);
             }
+            ReleaseReadDb(readDb);
             return TransferGrdErrno(ret);
         }
         retryTimes--;
     } while (retryTimes > 0);
 
     if (retryTimes == 0) {
+        ReleaseReadDb(readDb);
         return TransferGrdErrno(ret);
     }
-    value.resize(innerVal.dataLen);
-    value = KvItemToBlob(innerVal);
-    (void)PreferenceDbAdapter::GetApiInstance().FreeItemApi(&innerVal);
+    value = innerVal;
+    ReleaseReadDb(readDb);
     return TransferGrdErrno(ret);
 }
 
-int PreferencesDb::GetAllInner(std::list<std::pair<std::vector<uint8_t>, std::vector<uint8_t>>> &data,
-    GRD_ResultSet *resultSet)
+void PreferencesDb::FreeItem(GRD_KVItemT &item)
 {
-    int ret = E_OK;
-    while (TransferGrdErrno(PreferenceDbAdapter::GetApiInstance().NextApi(resultSet)) == E_OK) {
-        std::pair<std::vector<uint8_t>, std::vector<uint8_t>> dataItem;
-        uint32_t keySize = 0;
-        uint32_t valueSize = 0;
-        ret = PreferenceDbAdapter::GetApiInstance().GetItemSizeApi(resultSet, &keySize, &valueSize);
-        if (ret != GRD_OK) {
-            LOG_ERROR("ger reulstSet kv size failed %{public}d", ret);
-            return TransferGrdErrno(ret);
-        }
-        dataItem.first.resize(keySize);
-        dataItem.second.resize(valueSize);
-        ret = PreferenceDbAdapter::GetApiInstance().GetItemApi(resultSet, dataItem.first.data(),
-            dataItem.second.data());
-        if (ret != E_OK) {
-            LOG_ERROR("ger reulstSet failed %{public}d", ret);
-            return TransferGrdErrno(ret);
-        }
-        data.emplace_back(std::move(dataItem));
+    if (item.data == nullptr) {
+        return;
     }
-    return TransferGrdErrno(ret);
+    (void)PreferenceDbAdapter::GetApiInstance().FreeItemApi(&item);
+    item = { nullptr, 0 };
+}
+
+int PreferencesDb::HasKey(const std::string &key, bool &isExist)
+{
+    GRD_KVItemT value = { nullptr, 0 };
+    int errCode = Get(key, value);
+    if (errCode == E_NO_DATA) {
+        isExist = false;
+        return E_OK;
+    }
+    if (errCode != E_OK) {
+        return errCode;
+    }
+    FreeItem(value);
+    isExist = true;
+    return E_OK;
 }
 
 static inline bool IsApiValid()
@@ -476,43 +545,105 @@ static inline bool IsApiValid()
         apiInstance.FreeResultSetApi != nullptr);
 }
 
-int PreferencesDb::GetAll(std::list<std::pair<std::vector<uint8_t>, std::vector<uint8_t>>> &data)
+int PreferencesDb::CreateIterator(std::unique_ptr<PreferencesDbIterator> &iterator, const std::string *beginKey)
 {
     if (db_ == nullptr) {
-        LOG_ERROR("GetAll failed, db has been closed.");
+        LOG_ERROR("CreateIterator failed, db has been closed.");
         return E_ALREADY_CLOSED;
     }
     if (!IsApiValid()) {
-        LOG_ERROR("api load failed when get all");
+        LOG_ERROR("api load failed when create iterator");
         return E_ERROR;
     }
 
-    GRD_FilterOptionT param;
+    GRD_FilterOptionT param = {};
     param.mode = KV_SCAN_ALL;
+    if (beginKey != nullptr) {
+        param.mode = KV_SCAN_EQUAL_OR_GREATER_KEY;
+        param.begin = StringToKvItem(*beginKey);
+    }
     GRD_ResultSet *resultSet = nullptr;
-
+    GRD_DB *readDb = AcquireReadDb();
     int retryTimes = CREATE_COLLECTION_RETRY_TIMES;
     int ret = E_OK;
-
     do {
-        ret = PreferenceDbAdapter::GetApiInstance().DbKvFilterApi(db_, TABLENAME, &param, &resultSet);
+        ret = PreferenceDbAdapter::GetApiInstance().DbKvFilterApi(readDb, TABLENAME, &param, &resultSet);
         if (ret == GRD_UNDEFINED_TABLE) {
-            LOG_INFO("CreateCollection called when GetAll, file: %{public}s", ExtractFileName(dbPath_).c_str());
-            (void)CreateCollection();
+            LOG_INFO("CreateCollection called when CreateIterator, file: %{public}s",
+                ExtractFileName(dbPath_).c_str());
+            (void)CreateCollection(readDb);
         } else if (ret == GRD_OK) {
-            int innerErr = GetAllInner(data, resultSet); // log inside when failed
-            PreferenceDbAdapter::GetApiInstance().FreeResultSetApi(resultSet);
-            return innerErr;
+            iterator.reset(new PreferencesDbIterator(*this, readDb, resultSet));
+            return E_OK;
         } else {
             LOG_ERROR("rd kv filter failed:%{public}d", ret);
-            return TransferGrdErrno(ret);
+            break;
         }
         retryTimes--;
     } while (retryTimes > 0);
 
+    ReleaseReadDb(readDb);
     return TransferGrdErrno(ret);
 }
 
+PreferencesDbIterator::PreferencesDbIterator(PreferencesDb &db, GRD_DB *readDb, GRD_ResultSet *resultSet)
+    : db_(db), readDb_(readDb), resultSet_(resultSet)
+{
+}
+
+PreferencesDbIterator::~PreferencesDbIterator()
+{
+    FreeItems();
+    (void)PreferenceDbAdapter::GetApiInstance().FreeResultSetApi(resultSet_);
+    db_.ReleaseReadDb(readDb_);
+}
+
+void PreferencesDbIterator::FreeItems()
+{
+    db_.FreeItem(key_);
+    db_.FreeItem(value_);
+}
+
+int PreferencesDbIterator::Next(GRD_KVItemT &key, GRD_KVItemT &value)
+{
+    FreeItems();
+    auto &api = PreferenceDbAdapter::GetApiInstance();
+    int ret = api.NextApi(resultSet_);
+    if (ret != GRD_OK) {
+        if (ret != GRD_NO_DATA) {
+            LOG_ERROR("rd next failed:%{public}d", ret);
+        }
+        return TransferGrdErrno(ret);
+    }
+    if (api.FetchApi != nullptr && api.FreeItemApi != nullptr) {
+        ret = api.FetchApi(resultSet_, &key_, &value_);
+        if (ret != GRD_OK) {
+            LOG_ERROR("rd fetch failed:%{public}d", ret);
+            return TransferGrdErrno(ret);
+        }
+        key = key_;
+        value = value_;
+        return E_OK;
+    }
+    uint32_t keySize = 0;
+    uint32_t valueSize = 0;
+    ret = api.GetItemSizeApi(resultSet_, &keySize, &valueSize);
+    if (ret != GRD_OK) {
+        LOG_ERROR("ger reulstSet kv size failed %{public}d", ret);
+        return TransferGrdErrno(ret);
+    }
+    keyBuffer_.resize(keySize);
+    valueBuffer_.resize(valueSize);
+    ret = api.GetItemApi(resultSet_, keyBuffer_.data(), valueBuffer_.data());
+    if (ret != GRD_OK) {
+        LOG_ERROR("ger reulstSet failed %{public}d", ret);
+        return TransferGrdErrno(ret);
+    }
+    key = { keyBuffer_.data(), keySize };
+    value = { valueBuffer_.data(), valueSize };
+    return E_OK;
+}
+
 int PreferencesDb::DropCollection()
 {
     if (db_ == nullptr) {
@@ -538,10 +669,12 @@ GRD_KVItemT PreferencesDb::BlobToKvItem(const std::vector<uint8_t> &blob)
     };
 }
 
-std::vector<uint8_t> PreferencesDb::KvItemToBlob(GRD_KVItemT &item)
+GRD_KVItemT PreferencesDb::StringToKvItem(const std::string &str)
 {
-    return std::vector<uint8_t>(static_cast<uint8_t *>(item.data),
-        static_cast<uint8_t *>(item.data) + item.dataLen);
+    return {
+        .data = const_cast<char *>(str.data()),
+        .dataLen = static_cast<uint32_t>(str.size())
+    };
 }
 
 int PreferencesDb::GetKernelDataVersion(int64_t &dataVersion)
@@ -554,8 +687,10 @@ int PreferencesDb::GetKernelDataVersion(int64_t &dataVersion)
         return E_ERROR;
     }
 
-    GRD_DbValueT kernelDataVersion = PreferenceDbAdapter::GetApiInstance().DbGetConfigApi(db_,
+    GRD_DB *readDb = AcquireReadDb();
+    GRD_DbValueT kernelDataVersion = PreferenceDbAdapter::GetApiInstance().DbGetConfigApi(readDb,
         GRD_ConfigTypeE::GRD_CONFIG_DATA_VERSION);
+    ReleaseReadDb(readDb);
     if (kernelDataVersion.type != GRD_DbDataTypeE::GRD_DB_DATATYPE_INTEGER) {
         LOG_ERROR("get wrong data version type: %d", kernelDataVersion.type);
         return E_ERROR;
@@ -18,13 +18,44 @@
 namespace OHOS {
 namespace NativePreferences {
 __attribute__((used)) static bool g_isInit = PreferencesExecutorPoolTaskProcessor::Init();
-constexpr int32_t MAX_THREADS = 1;
 constexpr int32_t MIN_THREADS = 0;
-ExecutorPool PreferencesExecutorPoolTaskProcessor::executorPool_ = ExecutorPool(MAX_THREADS, MIN_THREADS);
 
-bool PreferencesExecutorPoolTaskProcessor::Execute(const Task &task)
+ExecutorPool &PreferencesExecutorPoolTaskProcessor::GetPool(TaskLane lane)
 {
-    return !(executorPool_.Execute(std::move(task)) == ExecutorPool::INVALID_TASK_ID);
+    static ExecutorPool pools[] = {
+        ExecutorPool(GetLaneConfig(TaskLane::LOAD).concurrency, MIN_THREADS),
+        ExecutorPool(GetLaneConfig(TaskLane::FLUSH).concurrency, MIN_THREADS),
+        ExecutorPool(GetLaneConfig(TaskLane::NOTIFY).concurrency, MIN_THREADS),
+        ExecutorPool(GetLaneConfig(TaskLane::DFX).concurrency, MIN_THREADS),
+    };
+    static_assert(sizeof(pools) / sizeof(pools[0]) == static_cast<size_t>(TaskLane::BUTT));
+    size_t index = static_cast<size_t>(lane);
+    return pools[index < static_cast<size_t>(TaskLane::BUTT) ? index : 0];
+}
+
+bool PreferencesExecutorPoolTaskProcessor::Execute(TaskLane lane, Task task)
+{
+    if (GetPool(lane).Execute(Track(lane, std::move(task))) == ExecutorPool::INVALID_TASK_ID) {
+        Untrack(lane);
+        return false;
+    }
+    return true;
+}
+
+bool PreferencesExecutorPoolTaskProcessor::Schedule(TaskLane lane, std::chrono::milliseconds delay, Task task)
+{
+    if (GetPool(lane).Schedule(delay, Track(lane, std::move(task), delay)) == ExecutorPool::INVALID_TASK_ID) {
+        Untrack(lane);
+        return false;
+    }
+    return true;
+}
+
+void PreferencesExecutorPoolTaskProcessor::FillBackendStats(TaskLane lane, TaskLaneStats &stats)
+{
+    auto poolStats = GetPool(lane).GetStats();
+    stats.executorNum = poolStats.executorNum;
+    stats.schedulerWakeupCount = poolStats.schedulerWakeupCount;
 }
 
 bool PreferencesExecutorPoolTaskProcessor::Init()
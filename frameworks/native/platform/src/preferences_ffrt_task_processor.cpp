@@ -17,12 +17,45 @@
 
 namespace OHOS {
 namespace NativePreferences {
-constexpr int32_t FFRT_QOS_USER_INTERACTIVE = 5;
-constexpr const char *FFRT_FLAG = "PreferencesFFRTFlag";
 __attribute__((used)) static bool g_isInit = PreferencesFfrtTaskProcessor::Init();
-bool PreferencesFfrtTaskProcessor::Execute(const Task &task)
+
+static ffrt::queue *CreateQueue(TaskLane lane)
+{
+    const TaskLaneConfig &config = PreferencesTaskProcessor::GetLaneConfig(lane);
+    ffrt::queue_attr attr;
+    attr.qos(config.qos);
+    if (config.concurrency > 1) {
+        attr.max_concurrency(config.concurrency);
+        return new ffrt::queue(ffrt::queue_concurrent, config.name, attr);
+    }
+    return new ffrt::queue(config.name, attr);
+}
+
+ffrt::queue &PreferencesFfrtTaskProcessor::GetQueue(TaskLane lane)
+{
+    // the queues live as long as the process, the tasks of other static objects may still use them at exit.
+    static ffrt::queue *queues[] = {
+        CreateQueue(TaskLane::LOAD),
+        CreateQueue(TaskLane::FLUSH),
+        CreateQueue(TaskLane::NOTIFY),
+        CreateQueue(TaskLane::DFX),
+    };
+    static_assert(sizeof(queues) / sizeof(queues[0]) == static_cast<size_t>(TaskLane::BUTT));
+    size_t index = static_cast<size_t>(lane);
+    return *queues[index < static_cast<size_t>(TaskLane::BUTT) ? index : 0];
+}
+
+bool PreferencesFfrtTaskProcessor::Execute(TaskLane lane, Task task)
+{
+    GetQueue(lane).submit(Track(lane, std::move(task)));
+    return true;
+}
+
+bool PreferencesFfrtTaskProcessor::Schedule(TaskLane lane, std::chrono::milliseconds delay, Task task)
 {
-    ffrt::submit(task, {}, { FFRT_FLAG }, ffrt::task_attr().qos(FFRT_QOS_USER_INTERACTIVE));
+    auto delayUs = std::chrono::duration_cast<std::chrono::microseconds>(delay).count();
+    GetQueue(lane).submit(Track(lane, std::move(task), delay),
+        ffrt::task_attr().delay(static_cast<uint64_t>(delayUs)));
     return true;
 }
 
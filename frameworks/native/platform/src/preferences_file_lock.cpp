@@ -57,15 +57,11 @@ PreferencesFileLock::~PreferencesFileLock()
 {
     inProcessMutex_->unlock();
     if (fd_ > 0) {
-        struct flock fileLockInfo = { 0 };
-        fileLockInfo.l_type = F_UNLCK;
-        fileLockInfo.l_whence = SEEK_SET;
-        fileLockInfo.l_start = 0;
-        fileLockInfo.l_len = 0;
-        if (fcntl(fd_, F_SETLK, &fileLockInfo) == -1) {
+        auto vfs = PreferencesVfs::GetInstance();
+        if (vfs->Lock(fd_, F_UNLCK) == -1) {
             LOG_ERROR("failed to release file lock error %{public}d.", errno);
         }
-        close(fd_);
+        vfs->Close(fd_);
         fd_ = -1;
     }
 }
@@ -85,19 +81,14 @@ void PreferencesFileLock::WriteLock(bool &isMultiProcessing)
 
 void PreferencesFileLock::Lock(short lockType, bool &isMultiProcessing)
 {
-    fd_ = open(filePath_.c_str(), O_RDWR | O_CREAT, S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP);
+    auto vfs = PreferencesVfs::GetInstance();
+    fd_ = vfs->Open(filePath_, O_RDWR | O_CREAT, S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP);
     if (fd_ == -1) {
         LOG_ERROR("Couldn't open file %{public}s errno %{public}d.", ExtractFileName(filePath_).c_str(), errno);
         return;
     }
-    struct flock fileLockInfo = { 0 };
-    fileLockInfo.l_type = lockType;
-    fileLockInfo.l_whence = SEEK_SET;
-    fileLockInfo.l_start = 0;
-    fileLockInfo.l_len = 0;
-
     for (size_t i = 0; i < ATTEMPTS; ++i) {
-        if (fcntl(fd_, F_SETLK, &fileLockInfo) != -1) {
+        if (vfs->Lock(fd_, lockType) != -1) {
             LOG_DEBUG("successfully obtained file lock");
             return;
         }
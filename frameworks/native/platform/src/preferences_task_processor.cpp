@@ -15,8 +15,54 @@
 
 #include "preferences_task_processor.h"
 
+#include <atomic>
+#include <mutex>
+#include <string>
+
+#include "log_print.h"
+
 namespace OHOS {
 namespace NativePreferences {
+constexpr size_t LANE_NUM = static_cast<size_t>(TaskLane::BUTT);
+// the qos are the ones of FFRT, from 0 for background to 5 for user interactive.
+static const TaskLaneConfig LANE_CONFIGS[LANE_NUM] = {
+    { "PreferencesLoad", 1, 5 },
+    { "PreferencesFlush", 2, 2 },
+    { "PreferencesNotify", 1, 3 },
+    { "PreferencesDfx", 1, 0 },
+};
+
+struct LaneCounter {
+    std::atomic<uint64_t> submitCount = 0;
+    std::atomic<uint64_t> startCount = 0;
+    std::atomic<uint64_t> finishCount = 0;
+    std::atomic<uint64_t> maxQueueDepth = 0;
+    std::atomic<uint64_t> totalWaitTime = 0;
+    std::atomic<uint64_t> maxWaitTime = 0;
+    std::atomic<uint64_t> waitTimeHistogram[LATENCY_BUCKET_NUM] = {};
+    std::atomic<uint64_t> totalRunTime = 0;
+    std::atomic<uint64_t> maxRunTime = 0;
+    std::atomic<uint64_t> runTimeHistogram[LATENCY_BUCKET_NUM] = {};
+};
+static LaneCounter g_laneCounters[LANE_NUM];
+// the upper bounds in microseconds of the latency buckets but the last one.
+static constexpr uint64_t LATENCY_BUCKET_BOUNDS[LATENCY_BUCKET_NUM - 1] = { 100, 1000, 10000, 100000, 1000000 };
+static thread_local TaskLane g_currentLane = TaskLane::BUTT;
+// a dump task stops when the interval is set again.
+static std::atomic<uint64_t> g_dumpGeneration = 0;
+
+struct PoolStatsRegistry {
+    std::mutex mutex;
+    std::vector<std::pair<const char *, TaskPoolStatsGetter>> getters;
+};
+
+// the pools register from the static initialization of other files, so the registry is created on first use.
+static PoolStatsRegistry &GetPoolStatsRegistry()
+{
+    static PoolStatsRegistry registry;
+    return registry;
+}
+
 PreferencesTaskProcessor *PreferencesTaskProcessor::instance_ = nullptr;
 PreferencesTaskProcessor *PreferencesTaskProcessor::GetInstance()
 {
@@ -31,5 +77,191 @@ bool PreferencesTaskProcessor::RegisterTaskProcessor(PreferencesTaskProcessor *i
     instance_ = instance;
     return true;
 }
+
+bool PreferencesTaskProcessor::Execute(const Task &task)
+{
+    return Execute(TaskLane::LOAD, task);
+}
+
+static size_t GetLaneIndex(TaskLane lane)
+{
+    size_t index = static_cast<size_t>(lane);
+    return index < LANE_NUM ? index : 0;
+}
+
+static void UpdateMax(std::atomic<uint64_t> &max, uint64_t value)
+{
+    uint64_t current = max.load();
+    while (value > current && !max.compare_exchange_weak(current, value)) {
+    }
+}
+
+static void AddLatency(std::atomic<uint64_t> (&histogram)[LATENCY_BUCKET_NUM], std::atomic<uint64_t> &total,
+    std::atomic<uint64_t> &max, uint64_t latency)
+{
+    size_t bucket = 0;
+    while (bucket < LATENCY_BUCKET_NUM - 1 && latency >= LATENCY_BUCKET_BOUNDS[bucket]) {
+        bucket++;
+    }
+    histogram[bucket]++;
+    total += latency;
+    UpdateMax(max, latency);
+}
+
+static LatencyHistogram LoadHistogram(const std::atomic<uint64_t> (&histogram)[LATENCY_BUCKET_NUM])
+{
+    LatencyHistogram result;
+    for (size_t i = 0; i < LATENCY_BUCKET_NUM; i++) {
+        result[i] = histogram[i].load();
+    }
+    return result;
+}
+
+static uint64_t ElapsedUs(std::chrono::steady_clock::time_point from)
+{
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - from).count();
+    return elapsed > 0 ? static_cast<uint64_t>(elapsed) : 0;
+}
+
+const TaskLaneConfig &PreferencesTaskProcessor::GetLaneConfig(TaskLane lane)
+{
+    return LANE_CONFIGS[GetLaneIndex(lane)];
+}
+
+TaskLaneStats PreferencesTaskProcessor::GetLaneStats(TaskLane lane)
+{
+    auto &counter = g_laneCounters[GetLaneIndex(lane)];
+    TaskLaneStats stats;
+    stats.finishCount = counter.finishCount.load();
+    uint64_t startCount = counter.startCount.load();
+    stats.submitCount = counter.submitCount.load();
+    stats.queueDepth = stats.submitCount > startCount ? stats.submitCount - startCount : 0;
+    stats.maxQueueDepth = counter.maxQueueDepth.load();
+    stats.totalWaitTime = counter.totalWaitTime.load();
+    stats.maxWaitTime = counter.maxWaitTime.load();
+    stats.waitTimeHistogram = LoadHistogram(counter.waitTimeHistogram);
+    stats.totalRunTime = counter.totalRunTime.load();
+    stats.maxRunTime = counter.maxRunTime.load();
+    stats.runTimeHistogram = LoadHistogram(counter.runTimeHistogram);
+    if (instance_ != nullptr) {
+        instance_->FillBackendStats(lane, stats);
+    }
+    return stats;
+}
+
+static std::string ToString(const LatencyHistogram &histogram)
+{
+    std::string result;
+    for (size_t i = 0; i < LATENCY_BUCKET_NUM; i++) {
+        result += (i == 0 ? "[" : "/") + std::to_string(histogram[i]);
+    }
+    return result + "]";
+}
+
+void PreferencesTaskProcessor::DumpStats()
+{
+    for (size_t i = 0; i < LANE_NUM; i++) {
+        auto lane = static_cast<TaskLane>(i);
+        auto stats = GetLaneStats(lane);
+        uint64_t startCount = stats.submitCount - stats.queueDepth;
+        std::string info = "submit " + std::to_string(stats.submitCount) + ", finish " +
+            std::to_string(stats.finishCount) + ", depth " + std::to_string(stats.queueDepth) + "/" +
+            std::to_string(stats.maxQueueDepth) + ", wait avg " +
+            std::to_string(startCount == 0 ? 0 : stats.totalWaitTime / startCount) + "us max " +
+            std::to_string(stats.maxWaitTime) + "us " + ToString(stats.waitTimeHistogram) + ", run avg " +
+            std::to_string(stats.finishCount == 0 ? 0 : stats.totalRunTime / stats.finishCount) + "us max " +
+            std::to_string(stats.maxRunTime) + "us " + ToString(stats.runTimeHistogram) + ", executors " +
+            std::to_string(stats.executorNum) + ", wakeups " + std::to_string(stats.schedulerWakeupCount);
+        LOG_INFO("%{public}s: %{public}s.", GetLaneConfig(lane).name, info.c_str());
+    }
+    for (const auto &stats : GetPoolStats()) {
+        std::string info = "executors " + std::to_string(stats.executorNum) + ", queued " +
+            std::to_string(stats.queuedTaskNum) + ", delayed " + std::to_string(stats.delayedTaskNum) +
+            ", wakeups " + std::to_string(stats.schedulerWakeupCount);
+        LOG_INFO("%{public}s: %{public}s.", stats.name, info.c_str());
+    }
+}
+
+bool PreferencesTaskProcessor::RegisterPoolStats(const char *name, TaskPoolStatsGetter getter)
+{
+    if (name == nullptr || getter == nullptr) {
+        return false;
+    }
+    auto &registry = GetPoolStatsRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.getters.emplace_back(name, std::move(getter));
+    return true;
+}
+
+std::vector<TaskPoolStats> PreferencesTaskProcessor::GetPoolStats()
+{
+    auto &registry = GetPoolStatsRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    std::vector<TaskPoolStats> result;
+    for (const auto &[name, getter] : registry.getters) {
+        auto stats = getter();
+        stats.name = name;
+        result.push_back(stats);
+    }
+    return result;
+}
+
+static void ScheduleDump(uint64_t generation, std::chrono::milliseconds interval)
+{
+    auto instance = PreferencesTaskProcessor::GetInstance();
+    if (instance == nullptr) {
+        LOG_WARN("no task processor to dump the stats.");
+        return;
+    }
+    instance->Schedule(TaskLane::DFX, interval, [generation, interval] {
+        if (g_dumpGeneration.load() != generation) {
+            return;
+        }
+        PreferencesTaskProcessor::DumpStats();
+        ScheduleDump(generation, interval);
+    });
+}
+
+void PreferencesTaskProcessor::SetStatsDumpInterval(std::chrono::milliseconds interval)
+{
+    uint64_t generation = ++g_dumpGeneration;
+    if (interval.count() > 0) {
+        ScheduleDump(generation, interval);
+    }
+}
+
+Task PreferencesTaskProcessor::Track(TaskLane lane, Task task, std::chrono::milliseconds delay)
+{
+    size_t index = GetLaneIndex(lane);
+    auto &counter = g_laneCounters[index];
+    uint64_t submitCount = counter.submitCount.fetch_add(1) + 1;
+    uint64_t startCount = counter.startCount.load();
+    UpdateMax(counter.maxQueueDepth, submitCount > startCount ? submitCount - startCount : 0);
+    auto dueTime = std::chrono::steady_clock::now() + delay;
+    return [index, task = std::move(task), dueTime] {
+        auto &counter = g_laneCounters[index];
+        counter.startCount++;
+        AddLatency(counter.waitTimeHistogram, counter.totalWaitTime, counter.maxWaitTime, ElapsedUs(dueTime));
+        auto startTime = std::chrono::steady_clock::now();
+        // a task may run another one inline, the lane of the outer one is restored after it.
+        TaskLane outerLane = g_currentLane;
+        g_currentLane = static_cast<TaskLane>(index);
+        task();
+        g_currentLane = outerLane;
+        AddLatency(counter.runTimeHistogram, counter.totalRunTime, counter.maxRunTime, ElapsedUs(startTime));
+        counter.finishCount++;
+    };
+}
+
+TaskLane PreferencesTaskProcessor::GetCurrentLane()
+{
+    return g_currentLane;
+}
+
+void PreferencesTaskProcessor::Untrack(TaskLane lane)
+{
+    g_laneCounters[GetLaneIndex(lane)].submitCount--;
+}
 } // namespace NativePreferences
-} // namespace OHOS
\ No newline at end of file
+} // namespace OHOS
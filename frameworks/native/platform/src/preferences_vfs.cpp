@@ -0,0 +1,433 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "preferences_vfs.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+#if defined(WINDOWS_PLATFORM)
+#include <io.h>
+#include <windows.h>
+#endif
+
+namespace OHOS {
+namespace NativePreferences {
+#ifndef FILE_MODE
+#define FILE_MODE 0770
+#endif
+
+#ifndef FILE_EXIST
+#define FILE_EXIST 0
+#endif
+
+static std::shared_ptr<PreferencesVfs> &GetVfsHolder()
+{
+    static std::shared_ptr<PreferencesVfs> vfs = std::make_shared<PreferencesPosixVfs>();
+    return vfs;
+}
+
+std::shared_ptr<PreferencesVfs> PreferencesVfs::GetInstance()
+{
+    return std::atomic_load(&GetVfsHolder());
+}
+
+void PreferencesVfs::SetInstance(std::shared_ptr<PreferencesVfs> vfs)
+{
+    if (vfs == nullptr) {
+        vfs = std::make_shared<PreferencesPosixVfs>();
+    }
+    std::atomic_store(&GetVfsHolder(), std::move(vfs));
+}
+
+ssize_t PreferencesVfs::WriteAndSync(int fd, const void *buffer, size_t count, bool &isSynced)
+{
+    ssize_t ret = Write(fd, buffer, count);
+    isSynced = (ret >= 0) && (Fsync(fd) == 0);
+    return ret;
+}
+
+int PreferencesPosixVfs::Open(const std::string &path, int flags, mode_t mode)
+{
+#if defined(WINDOWS_PLATFORM)
+    return _open(path.c_str(), flags, _S_IREAD | _S_IWRITE);
+#else
+    return open(path.c_str(), flags, mode);
+#endif
+}
+
+ssize_t PreferencesPosixVfs::Read(int fd, void *buffer, size_t count)
+{
+#if defined(WINDOWS_PLATFORM)
+    return _read(fd, buffer, static_cast<unsigned int>(count));
+#else
+    return read(fd, buffer, count);
+#endif
+}
+
+ssize_t PreferencesPosixVfs::Write(int fd, const void *buffer, size_t count)
+{
+#if defined(WINDOWS_PLATFORM)
+    HANDLE hFile = (HANDLE)_get_osfhandle(fd);
+    if (hFile == INVALID_HANDLE_VALUE) {
+        return -1;
+    }
+    DWORD bytesWritten = 0;
+    return WriteFile(hFile, buffer, (DWORD)count, &bytesWritten, NULL) ? (ssize_t)bytesWritten : -1;
+#else
+    return write(fd, buffer, count);
+#endif
+}
+
+int PreferencesPosixVfs::Fsync(int fd)
+{
+#if defined(WINDOWS_PLATFORM)
+    HANDLE handle = (HANDLE)_get_osfhandle(fd);
+    if (handle == INVALID_HANDLE_VALUE || !FlushFileBuffers(handle)) {
+        return -1;
+    }
+    return 0;
+#else
+    if (fd == -1) {
+        errno = EBADF;
+        return -1;
+    }
+    return fsync(fd);
+#endif
+}
+
+int PreferencesPosixVfs::Close(int fd)
+{
+#if defined(WINDOWS_PLATFORM)
+    return _close(fd);
+#else
+    return close(fd);
+#endif
+}
+
+int PreferencesPosixVfs::Rename(const std::string &oldPath, const std::string &newPath)
+{
+    return std::rename(oldPath.c_str(), newPath.c_str());
+}
+
+int PreferencesPosixVfs::Remove(const std::string &path)
+{
+    return std::remove(path.c_str());
+}
+
+int PreferencesPosixVfs::Stat(const std::string &path, struct stat &buffer)
+{
+    return stat(path.c_str(), &buffer);
+}
+
+int PreferencesPosixVfs::Access(const std::string &path)
+{
+#if defined(WINDOWS_PLATFORM)
+    return _access(path.c_str(), FILE_EXIST);
+#else
+    return access(path.c_str(), FILE_EXIST);
+#endif
+}
+
+int PreferencesPosixVfs::Mkdir(const std::string &path)
+{
+#if defined(WINDOWS_PLATFORM)
+    return mkdir(path.c_str());
+#else
+    return mkdir(path.c_str(), FILE_MODE);
+#endif
+}
+
+int PreferencesPosixVfs::Lock(int fd, short lockType)
+{
+#if defined(WINDOWS_PLATFORM)
+    return 0;
+#else
+    struct flock fileLockInfo = { 0 };
+    fileLockInfo.l_type = lockType;
+    fileLockInfo.l_whence = SEEK_SET;
+    fileLockInfo.l_start = 0;
+    fileLockInfo.l_len = 0;
+    return fcntl(fd, F_SETLK, &fileLockInfo);
+#endif
+}
+
+bool PreferencesMemoryVfs::IsDirectory(const std::string &path)
+{
+    if (directories_.find(path) != directories_.end()) {
+        return true;
+    }
+    // the parent directories of the existing files exist implicitly.
+    std::string prefix = path + "/";
+    auto it = files_.lower_bound(prefix);
+    return it != files_.end() && it->first.compare(0, prefix.size(), prefix) == 0;
+}
+
+int PreferencesMemoryVfs::Open(const std::string &path, int flags, mode_t mode)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = files_.find(path);
+    if (it == files_.end()) {
+        if ((flags & O_CREAT) == 0) {
+            errno = ENOENT;
+            return -1;
+        }
+        it = files_.emplace(path, std::make_shared<std::vector<uint8_t>>()).first;
+    } else if ((flags & O_TRUNC) != 0) {
+        it->second->clear();
+    }
+    int fd = nextFd_++;
+    openFiles_[fd] = { it->second, 0 };
+    return fd;
+}
+
+ssize_t PreferencesMemoryVfs::Read(int fd, void *buffer, size_t count)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = openFiles_.find(fd);
+    if (it == openFiles_.end()) {
+        errno = EBADF;
+        return -1;
+    }
+    OpenFile &file = it->second;
+    size_t size = file.content->size();
+    size_t readSize = (file.offset >= size) ? 0 : std::min(count, size - file.offset);
+    if (readSize > 0) {
+        (void)memcpy(buffer, file.content->data() + file.offset, readSize);
+    }
+    file.offset += readSize;
+    return static_cast<ssize_t>(readSize);
+}
+
+ssize_t PreferencesMemoryVfs::Write(int fd, const void *buffer, size_t count)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = openFiles_.find(fd);
+    if (it == openFiles_.end()) {
+        errno = EBADF;
+        return -1;
+    }
+    OpenFile &file = it->second;
+    if (file.content->size() < file.offset + count) {
+        file.content->resize(file.offset + count);
+    }
+    if (count > 0) {
+        (void)memcpy(file.content->data() + file.offset, buffer, count);
+    }
+    file.offset += count;
+    return static_cast<ssize_t>(count);
+}
+
+int PreferencesMemoryVfs::Fsync(int fd)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (openFiles_.find(fd) == openFiles_.end()) {
+        errno = EBADF;
+        return -1;
+    }
+    return 0;
+}
+
+int PreferencesMemoryVfs::Close(int fd)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (openFiles_.erase(fd) == 0) {
+        errno = EBADF;
+        return -1;
+    }
+    return 0;
+}
+
+int PreferencesMemoryVfs::Rename(const std::string &oldPath, const std::string &newPath)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = files_.find(oldPath);
+    if (it == files_.end()) {
+        errno = ENOENT;
+        return -1;
+    }
+    Content content = it->second;
+    files_.erase(it);
+    files_[newPath] = content;
+    return 0;
+}
+
+int PreferencesMemoryVfs::Remove(const std::string &path)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (files_.erase(path) == 0 && directories_.erase(path) == 0) {
+        errno = ENOENT;
+        return -1;
+    }
+    return 0;
+}
+
+int PreferencesMemoryVfs::Stat(const std::string &path, struct stat &buffer)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    (void)memset(&buffer, 0, sizeof(buffer));
+    auto it = files_.find(path);
+    if (it != files_.end()) {
+        buffer.st_mode = S_IFREG | 0660;
+        buffer.st_size = static_cast<off_t>(it->second->size());
+        return 0;
+    }
+    if (IsDirectory(path)) {
+        buffer.st_mode = S_IFDIR | FILE_MODE;
+        return 0;
+    }
+    errno = ENOENT;
+    return -1;
+}
+
+int PreferencesMemoryVfs::Access(const std::string &path)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (files_.find(path) != files_.end() || IsDirectory(path)) {
+        return 0;
+    }
+    errno = ENOENT;
+    return -1;
+}
+
+int PreferencesMemoryVfs::Mkdir(const std::string &path)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (files_.find(path) != files_.end() || !directories_.insert(path).second) {
+        errno = EEXIST;
+        return -1;
+    }
+    return 0;
+}
+
+int PreferencesMemoryVfs::Lock(int fd, short lockType)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (openFiles_.find(fd) == openFiles_.end()) {
+        errno = EBADF;
+        return -1;
+    }
+    // there is no other process sharing the files.
+    return 0;
+}
+
+PreferencesFaultVfs::PreferencesFaultVfs(std::shared_ptr<PreferencesVfs> base) : base_(std::move(base))
+{
+    if (base_ == nullptr) {
+        base_ = std::make_shared<PreferencesPosixVfs>();
+    }
+}
+
+void PreferencesFaultVfs::SetFault(VfsOperation operation, std::chrono::microseconds latency, int errCode)
+{
+    if (operation >= VfsOperation::BUTT) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    faults_[static_cast<size_t>(operation)] = { latency, errCode };
+}
+
+void PreferencesFaultVfs::ClearFaults()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    faults_.fill(Fault());
+}
+
+bool PreferencesFaultVfs::Inject(VfsOperation operation)
+{
+    Fault fault;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        fault = faults_[static_cast<size_t>(operation)];
+    }
+    if (fault.latency.count() > 0) {
+        std::this_thread::sleep_for(fault.latency);
+    }
+    if (fault.errCode != 0) {
+        errno = fault.errCode;
+        return false;
+    }
+    return true;
+}
+
+int PreferencesFaultVfs::Open(const std::string &path, int flags, mode_t mode)
+{
+    return Inject(VfsOperation::OPEN) ? base_->Open(path, flags, mode) : -1;
+}
+
+ssize_t PreferencesFaultVfs::Read(int fd, void *buffer, size_t count)
+{
+    return Inject(VfsOperation::READ) ? base_->Read(fd, buffer, count) : -1;
+}
+
+ssize_t PreferencesFaultVfs::Write(int fd, const void *buffer, size_t count)
+{
+    return Inject(VfsOperation::WRITE) ? base_->Write(fd, buffer, count) : -1;
+}
+
+int PreferencesFaultVfs::Fsync(int fd)
+{
+    return Inject(VfsOperation::FSYNC) ? base_->Fsync(fd) : -1;
+}
+
+int PreferencesFaultVfs::Close(int fd)
+{
+    // the descriptor is released even if the failure is injected, as close(2) does.
+    if (!Inject(VfsOperation::CLOSE)) {
+        int errCode = errno;
+        base_->Close(fd);
+        errno = errCode;
+        return -1;
+    }
+    return base_->Close(fd);
+}
+
+int PreferencesFaultVfs::Rename(const std::string &oldPath, const std::string &newPath)
+{
+    return Inject(VfsOperation::RENAME) ? base_->Rename(oldPath, newPath) : -1;
+}
+
+int PreferencesFaultVfs::Remove(const std::string &path)
+{
+    return Inject(VfsOperation::REMOVE) ? base_->Remove(path) : -1;
+}
+
+int PreferencesFaultVfs::Stat(const std::string &path, struct stat &buffer)
+{
+    return Inject(VfsOperation::STAT) ? base_->Stat(path, buffer) : -1;
+}
+
+int PreferencesFaultVfs::Access(const std::string &path)
+{
+    return Inject(VfsOperation::ACCESS) ? base_->Access(path) : -1;
+}
+
+int PreferencesFaultVfs::Mkdir(const std::string &path)
+{
+    return Inject(VfsOperation::MKDIR) ? base_->Mkdir(path) : -1;
+}
+
+int PreferencesFaultVfs::Lock(int fd, short lockType)
+{
+    return Inject(VfsOperation::LOCK) ? base_->Lock(fd, lockType) : -1;
+}
+} // namespace NativePreferences
+} // namespace OHOS
@@ -22,17 +22,16 @@
 #include <functional>
 #include <sstream>
 
-#include "executor_pool.h"
 #include "log_print.h"
 #include "preferences_utils.h"
 #include "preferences_dfx_adapter.h"
 #include "preferences_file_operation.h"
 #include "preferences_observer_stub.h"
+#include "preferences_task_processor.h"
 
 namespace OHOS {
 namespace NativePreferences {
 
-ExecutorPool PreferencesBase::executorPool_ = ExecutorPool(1, 0);
 
 PreferencesBase::PreferencesBase(const Options &options) : options_(options)
 {
@@ -52,6 +51,11 @@ int PreferencesBase::Put(const std::string &key, const PreferencesValue &value)
     return E_OK;
 }
 
+int PreferencesBase::Put(std::string &&key, PreferencesValue &&value)
+{
+    return E_OK;
+}
+
 int PreferencesBase::GetInt(const std::string &key, const int &defValue = {})
 {
     PreferencesValue preferencesValue = Get(key, defValue);
@@ -116,31 +120,31 @@ bool PreferencesBase::HasKey(const std::string &key)
 
 int PreferencesBase::PutInt(const std::string &key, int value)
 {
-    return Put(key, value);
+    return Put(std::string(key), PreferencesValue(value));
 }
 
 int PreferencesBase::PutString(const std::string &key, const std::string &value)
 {
-    return Put(key, value);
+    return Put(std::string(key), PreferencesValue(value));
 }
 
 int PreferencesBase::PutBool(const std::string &key, bool value)
 {
-    return Put(key, value);
+    return Put(std::string(key), PreferencesValue(value));
 }
 
 int PreferencesBase::PutLong(const std::string &key, int64_t value)
 {
-    return Put(key, value);
+    return Put(std::string(key), PreferencesValue(value));
 }
 
 int PreferencesBase::PutFloat(const std::string &key, float value)
 {
-    return Put(key, value);
+    return Put(std::string(key), PreferencesValue(value));
 }
 int PreferencesBase::PutDouble(const std::string &key, double value)
 {
-    return Put(key, value);
+    return Put(std::string(key), PreferencesValue(value));
 }
 int PreferencesBase::Delete(const std::string &key)
 {
@@ -192,6 +196,25 @@ int PreferencesBase::RegisterObserver(std::shared_ptr<PreferencesObserver> prefe
     return E_OK;
 }
 
+bool PreferencesBase::HasObservers()
+{
+    std::shared_lock<std::shared_mutex> readLock(observerMutex_);
+    if (!multiProcessObservers_.empty()) {
+        return true;
+    }
+    for (const auto &observer : localObservers_) {
+        if (!observer.expired()) {
+            return true;
+        }
+    }
+    for (const auto &[observer, keys] : dataObserversMap_) {
+        if (!observer.expired()) {
+            return true;
+        }
+    }
+    return false;
+}
+
 int PreferencesBase::UnRegisterDataObserver(std::shared_ptr<PreferencesObserver> preferencesObserver,
     const std::vector<std::string> &keys)
 {
@@ -266,6 +289,48 @@ std::unordered_map<std::string, PreferencesValue> PreferencesBase::GetAllDatas()
     return {};
 }
 
+class PreferencesMapIterator : public PreferencesIterator {
+public:
+    explicit PreferencesMapIterator(std::unordered_map<std::string, PreferencesValue> &&data)
+        : data_(std::move(data)), pos_(data_.begin())
+    {
+    }
+
+    int Next(std::string &key, PreferencesValue &value) override
+    {
+        if (pos_ == data_.end()) {
+            return E_NO_DATA;
+        }
+        key = pos_->first;
+        value = pos_->second;
+        ++pos_;
+        return E_OK;
+    }
+
+private:
+    std::unordered_map<std::string, PreferencesValue> data_;
+    std::unordered_map<std::string, PreferencesValue>::iterator pos_;
+};
+
+std::pair<int, std::shared_ptr<PreferencesIterator>> PreferencesBase::CreateIterator()
+{
+    return { E_OK, std::make_shared<PreferencesMapIterator>(GetAllDatas()) };
+}
+
+int PreferencesBase::SetLoadingDefaults(const std::map<std::string, PreferencesValue> &defaults)
+{
+    std::lock_guard<std::mutex> lock(loadingDefaultsMutex_);
+    loadingDefaults_ = defaults;
+    return E_OK;
+}
+
+PreferencesValue PreferencesBase::GetLoadingDefault(const std::string &key, const PreferencesValue &defValue)
+{
+    std::lock_guard<std::mutex> lock(loadingDefaultsMutex_);
+    auto it = loadingDefaults_.find(key);
+    return it == loadingDefaults_.end() ? defValue : it->second;
+}
+
 int PreferencesBase::UnRegisterObserver(std::shared_ptr<PreferencesObserver> preferencesObserver, RegisterMode mode)
 {
     IsClose(std::string(__FUNCTION__));
@@ -321,7 +386,7 @@ void PreferencesBase::ReportObjectUsage(std::shared_ptr<PreferencesBase> pref, c
     if (!value.IsObject() || pref == nullptr || pref->objectReported_.exchange(true)) {
         return;
     }
-    ExecutorPool::Task task = [weakPref = std::weak_ptr<PreferencesBase>(pref)] {
+    Task task = [weakPref = std::weak_ptr<PreferencesBase>(pref)] {
         auto pref = weakPref.lock();
         if (pref == nullptr) {
             return;
@@ -353,7 +418,7 @@ void PreferencesBase::ReportObjectUsage(std::shared_ptr<PreferencesBase> pref, c
         }
         OHOS::NativePreferences::Close(fd);
     };
-    executorPool_.Execute(std::move(task));
+    PreferencesTaskProcessor::GetInstance()->Execute(TaskLane::DFX, std::move(task));
 }
 } // End of namespace NativePreferences
 } // End of namespace OHOS
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "preferences_bloom_filter.h"
+
+#include <algorithm>
+#include <functional>
+
+namespace OHOS {
+namespace NativePreferences {
+// 10 bits and 7 probes per key keep the false positive rate about 1%.
+constexpr size_t BITS_PER_KEY = 10;
+constexpr size_t PROBE_NUM = 7;
+constexpr size_t MIN_CAPACITY = 128;
+constexpr size_t WORD_BITS = 64;
+
+PreferencesBloomFilter::PreferencesBloomFilter(size_t capacity, int64_t version)
+    : capacity_(std::max(capacity, MIN_CAPACITY)), version_(version)
+{
+    bitNum_ = capacity_ * BITS_PER_KEY;
+    bits_.resize((bitNum_ + WORD_BITS - 1) / WORD_BITS, 0);
+}
+
+uint64_t PreferencesBloomFilter::Hash(std::string_view key)
+{
+    return std::hash<std::string_view>()(key);
+}
+
+// the probes are h1 + i * h2, h2 is mixed from h1 as std::hash may return the identity of short values.
+static uint64_t GetProbeStep(uint64_t hash)
+{
+    uint64_t step = hash + 0x9e3779b97f4a7c15ULL;
+    step = (step ^ (step >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    step = (step ^ (step >> 27)) * 0x94d049bb133111ebULL;
+    return (step ^ (step >> 31)) | 1;
+}
+
+void PreferencesBloomFilter::Add(uint64_t hash)
+{
+    uint64_t step = GetProbeStep(hash);
+    for (size_t i = 0; i < PROBE_NUM; i++) {
+        size_t bit = static_cast<size_t>((hash + i * step) % bitNum_);
+        bits_[bit / WORD_BITS] |= (1ULL << (bit % WORD_BITS));
+    }
+    count_++;
+}
+
+bool PreferencesBloomFilter::MightContain(uint64_t hash) const
+{
+    uint64_t step = GetProbeStep(hash);
+    for (size_t i = 0; i < PROBE_NUM; i++) {
+        size_t bit = static_cast<size_t>((hash + i * step) % bitNum_);
+        if ((bits_[bit / WORD_BITS] & (1ULL << (bit % WORD_BITS))) == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int64_t PreferencesBloomFilter::GetVersion() const
+{
+    return version_;
+}
+
+void PreferencesBloomFilter::SetVersion(int64_t version)
+{
+    version_ = version;
+}
+
+bool PreferencesBloomFilter::IsOverloaded() const
+{
+    return count_ > capacity_ * 2;
+}
+} // namespace NativePreferences
+} // namespace OHOS
@@ -15,18 +15,26 @@
 
 #include "preferences_enhance_impl.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cinttypes>
 #include <climits>
 #include <cstdint>
 #include <cstdlib>
 #include <functional>
+#include <future>
+#include <optional>
 #include <sstream>
+#include <string_view>
 #include <thread>
 
 #include "executor_pool.h"
 #include "preferences_file_operation.h"
 #include "log_print.h"
 #include "preferences_observer_stub.h"
+#include "preferences_prefetch_manifest.h"
+#include "preferences_task_processor.h"
 #include "preferences_utils.h"
 #include "preferences_value.h"
 #include "preferences_value_parcel.h"
@@ -34,9 +42,57 @@
 namespace OHOS {
 namespace NativePreferences {
 
-constexpr int32_t CACHED_THRESHOLDS = 512 * 1024; // we will cached big obj(len >= 512k)
+constexpr size_t DEFAULT_VALUE_CACHE_CAPACITY = 1024 * 1024; // per store, the decoded values and absent keys
+constexpr size_t MAX_KEPT_ENCODE_BUFFER_SIZE = 64 * 1024;
+// the key filter is built again at most once per interval when the writes of other processes outdate it.
+constexpr int64_t MIN_KEY_FILTER_BUILD_INTERVAL = 1000 * 1000;
+// the memtable is written in the background once it holds this many bytes or its first write is this old, and by
+// the writer itself above the limit.
+constexpr size_t MEMTABLE_FLUSH_BYTES = 64 * 1024;
+constexpr size_t MAX_MEMTABLE_BYTES = 1024 * 1024;
+constexpr std::chrono::milliseconds MEMTABLE_FLUSH_DELAY = std::chrono::milliseconds(100);
+constexpr size_t MAX_OPEN_THREAD_NUM = 4;
 
-PreferencesEnhanceImpl::PreferencesEnhanceImpl(const Options &options): PreferencesBase(options)
+static std::atomic<size_t> g_valueCacheCapacity = DEFAULT_VALUE_CACHE_CAPACITY;
+static std::atomic<int64_t> g_versionCheckInterval = 0;
+static std::atomic<bool> g_isWriteBehindEnabled = false;
+static std::atomic<bool> g_isKeyRecordingEnabled = false;
+// the stores are opened here rather than in a lane of the task processor, an open may take long.
+static ExecutorPool g_openPool(MAX_OPEN_THREAD_NUM, 0);
+
+static bool RegisterOpenPoolStats()
+{
+    return PreferencesTaskProcessor::RegisterPoolStats("PreferencesOpenPool", [] {
+        auto poolStats = g_openPool.GetStats();
+        TaskPoolStats stats;
+        stats.executorNum = poolStats.executorNum;
+        stats.queuedTaskNum = poolStats.queuedTaskNum;
+        stats.delayedTaskNum = poolStats.delayedTaskNum;
+        stats.schedulerWakeupCount = poolStats.schedulerWakeupCount;
+        return stats;
+    });
+}
+__attribute__((used)) static bool g_isOpenPoolStatsRegistered = RegisterOpenPoolStats();
+
+// the buffer of the encoded values stays with the thread, so the puts of small values do not allocate it.
+static std::vector<uint8_t> &GetEncodeBuffer(uint32_t size)
+{
+    static thread_local std::vector<uint8_t> buffer;
+    if (buffer.capacity() > MAX_KEPT_ENCODE_BUFFER_SIZE && size <= MAX_KEPT_ENCODE_BUFFER_SIZE) {
+        std::vector<uint8_t>().swap(buffer);
+    }
+    buffer.resize(size);
+    return buffer;
+}
+
+static int64_t GetSteadyTimeUs()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+PreferencesEnhanceImpl::PreferencesEnhanceImpl(const Options &options): PreferencesBase(options),
+    valueCache_(g_valueCacheCapacity.load()), isWriteBehind_(g_isWriteBehindEnabled.load())
 {
 }
 
@@ -47,107 +103,586 @@ PreferencesEnhanceImpl::~PreferencesEnhanceImpl()
 
 int PreferencesEnhanceImpl::Init()
 {
-    std::unique_lock<std::shared_mutex> writeLock(dbMutex_);
+    // the api is loaded once per process, the later calls return at once.
     PreferenceDbAdapter::ApiInit();
     if (!PreferenceDbAdapter::IsEnhandceDbEnable()) {
         LOG_ERROR("enhance api load failed.");
         return E_ERROR;
     }
-    db_ = std::make_shared<PreferencesDb>();
-    cachedDataVersion_ = 0;
-    int errCode = db_->Init(options_.filePath, options_.bundleName);
+    auto promise = std::make_shared<std::promise<int>>();
+    openFuture_ = promise->get_future().share();
+    isOpenDone_ = false;
+    ExecutorPool::Task task = [pref = shared_from_this(), promise] {
+        promise->set_value(pref->Open());
+        pref->RunOpenWaiters();
+    };
+    if (g_openPool.Execute(std::move(task)) == ExecutorPool::INVALID_TASK_ID) {
+        int errCode = Open();
+        promise->set_value(errCode);
+        RunOpenWaiters();
+        return errCode;
+    }
+    return E_OK;
+}
+
+int PreferencesEnhanceImpl::Open()
+{
+    std::unique_lock<std::shared_mutex> writeLock(dbMutex_);
+    valueCache_.Clear();
+    versionCheckTime_ = 0;
+    std::atomic_store(&keyFilter_, std::shared_ptr<PreferencesBloomFilter>());
+    keyFilterBuildTime_ = 0;
+    auto db = std::make_shared<PreferencesDb>();
+    int errCode = db->Init(options_.filePath, options_.bundleName);
     if (errCode != E_OK) {
-        db_ = nullptr;
+        LOG_ERROR("open db failed, errCode=%{public}d, file: %{public}s", errCode,
+            ExtractFileName(options_.filePath).c_str());
+        return errCode;
     }
-    return errCode;
+    db_ = std::move(db);
+    // the filter is built in the background, the reads go to the db until it is ready.
+    StartBuildKeyFilter();
+    return E_OK;
 }
 
-PreferencesValue PreferencesEnhanceImpl::Get(const std::string &key, const PreferencesValue &defValue)
+int PreferencesEnhanceImpl::WaitOpen()
 {
-    if (PreferencesUtils::CheckKey(key) != E_OK) {
-        return defValue;
+    std::shared_future<int> openFuture = openFuture_;
+    return openFuture.valid() ? openFuture.get() : E_OK;
+}
+
+bool PreferencesEnhanceImpl::IsOpenDone()
+{
+    std::shared_future<int> openFuture = openFuture_;
+    return !openFuture.valid() || openFuture.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+void PreferencesEnhanceImpl::RunAfterOpen(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(openMutex_);
+        if (!isOpenDone_) {
+            openWaiters_.push_back(std::move(task));
+            return;
+        }
     }
-    // write lock here, get not support concurrence
-    std::unique_lock<std::shared_mutex> writeLock(dbMutex_);
+    task();
+}
+
+void PreferencesEnhanceImpl::RunOpenWaiters()
+{
+    std::vector<std::function<void()>> waiters;
+    {
+        std::lock_guard<std::mutex> lock(openMutex_);
+        isOpenDone_ = true;
+        waiters.swap(openWaiters_);
+    }
+    // the open pool is left to the opens of the other preferences.
+    for (auto &waiter : waiters) {
+        if (!PreferencesTaskProcessor::GetInstance()->Execute(TaskLane::LOAD, waiter)) {
+            waiter();
+        }
+    }
+}
+
+bool PreferencesEnhanceImpl::HasOpenFailed()
+{
+    return IsOpenDone() && WaitOpen() != E_OK;
+}
+
+void PreferencesEnhanceImpl::SetValueCacheCapacity(size_t capacity)
+{
+    g_valueCacheCapacity = capacity;
+}
+
+size_t PreferencesEnhanceImpl::GetValueCacheCapacity()
+{
+    return g_valueCacheCapacity;
+}
+
+PreferencesValueCache::Stats PreferencesEnhanceImpl::GetValueCacheStats()
+{
+    return valueCache_.GetStats();
+}
+
+uint64_t PreferencesEnhanceImpl::GetKeyFilterHitCount()
+{
+    return keyFilterHitCount_.load(std::memory_order_relaxed);
+}
+
+uint64_t PreferencesEnhanceImpl::GetVersionCheckCount()
+{
+    return versionCheckCount_.load(std::memory_order_relaxed);
+}
+
+void PreferencesEnhanceImpl::SetVersionCheckInterval(std::chrono::microseconds interval)
+{
+    g_versionCheckInterval = interval.count();
+}
+
+std::chrono::microseconds PreferencesEnhanceImpl::GetVersionCheckInterval()
+{
+    return std::chrono::microseconds(g_versionCheckInterval.load());
+}
+
+void PreferencesEnhanceImpl::SetWriteBehindEnabled(bool isEnabled)
+{
+    g_isWriteBehindEnabled = isEnabled;
+}
+
+bool PreferencesEnhanceImpl::IsWriteBehindEnabled()
+{
+    return g_isWriteBehindEnabled;
+}
+
+void PreferencesEnhanceImpl::SetKeyRecordingEnabled(bool isEnabled)
+{
+    g_isKeyRecordingEnabled = isEnabled;
+}
+
+void PreferencesEnhanceImpl::RecordKey(const std::string &key)
+{
+    if (!g_isKeyRecordingEnabled.load(std::memory_order_relaxed)) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(recordMutex_);
+    if (recordedKeys_.size() < PreferencesPrefetchManifest::MAX_KEY_NUM) {
+        recordedKeys_.insert(key);
+    }
+}
+
+std::vector<std::string> PreferencesEnhanceImpl::TakeRecordedKeys()
+{
+    std::lock_guard<std::mutex> lock(recordMutex_);
+    std::vector<std::string> keys(recordedKeys_.begin(), recordedKeys_.end());
+    recordedKeys_.clear();
+    return keys;
+}
+
+void PreferencesEnhanceImpl::Prefetch(const std::vector<std::string> &keys)
+{
+    if (WaitOpen() != E_OK) {
+        return;
+    }
+    std::shared_lock<std::shared_mutex> readLock(dbMutex_);
     if (db_ == nullptr) {
-        LOG_ERROR("PreferencesEnhanceImpl:Get failed, db has been closed.");
-        return defValue;
+        return;
+    }
+    PreferencesValue value;
+    for (const auto &key : keys) {
+        bool isExist = false;
+        (void)GetInner(key, value, isExist);
     }
+}
 
-    int64_t kernelDataVersion = 0;
-    if (db_->GetKernelDataVersion(kernelDataVersion) != E_OK) {
-        return defValue;
+int PreferencesEnhanceImpl::CheckDataVersion(int64_t &dataVersion)
+{
+    versionCheckCount_.fetch_add(1, std::memory_order_relaxed);
+    int errCode = db_->GetKernelDataVersion(dataVersion);
+    if (errCode != E_OK) {
+        versionCheckTime_.store(0, std::memory_order_release);
+        return errCode;
+    }
+    checkedDataVersion_.store(dataVersion, std::memory_order_relaxed);
+    versionCheckTime_.store(GetSteadyTimeUs(), std::memory_order_release);
+    return E_OK;
+}
+
+int PreferencesEnhanceImpl::GetDataVersion(int64_t &dataVersion)
+{
+    int64_t interval = g_versionCheckInterval.load(std::memory_order_relaxed);
+    if (interval > 0) {
+        int64_t checkTime = versionCheckTime_.load(std::memory_order_acquire);
+        if (checkTime != 0 && GetSteadyTimeUs() - checkTime < interval) {
+            dataVersion = checkedDataVersion_.load(std::memory_order_relaxed);
+            return E_OK;
+        }
+    }
+    return CheckDataVersion(dataVersion);
+}
+
+bool PreferencesEnhanceImpl::IsKeyAbsent(const std::string &key, int64_t version)
+{
+    auto filter = std::atomic_load(&keyFilter_);
+    if (filter == nullptr || filter->GetVersion() != version) {
+        StartBuildKeyFilter();
+        return false;
+    }
+    if (filter->MightContain(PreferencesBloomFilter::Hash(key))) {
+        return false;
+    }
+    keyFilterHitCount_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+int64_t PreferencesEnhanceImpl::GetVersionBeforeWrite()
+{
+    int64_t version = -1;
+    if (std::atomic_load(&keyFilter_) == nullptr || CheckDataVersion(version) != E_OK) {
+        return -1;
+    }
+    return version;
+}
+
+void PreferencesEnhanceImpl::UpdateKeyFilter(const std::string *key, int64_t versionBefore, int64_t version)
+{
+    auto filter = std::atomic_load(&keyFilter_);
+    if (filter == nullptr) {
+        return;
+    }
+    // the filter assumes that a write of this process moves the data version forward by any step, and that no other
+    // process writes between it and the read of the version after it. A version before the write which is not the
+    // one of the filter is a gap: another process has written in between and the keys it added are unknown.
+    if (versionBefore < 0 || filter->GetVersion() != versionBefore || version < versionBefore) {
+        std::atomic_store(&keyFilter_, std::shared_ptr<PreferencesBloomFilter>());
+        StartBuildKeyFilter();
+        return;
     }
-    if (kernelDataVersion == cachedDataVersion_) {
-        auto it = largeCachedData_.find(key);
-        if (it != largeCachedData_.end()) {
-            return it->second;
+    if (key != nullptr) {
+        filter->Add(PreferencesBloomFilter::Hash(*key));
+    }
+    filter->SetVersion(version);
+    if (filter->IsOverloaded()) {
+        keyFilterBuildTime_ = 0;
+        StartBuildKeyFilter();
+    }
+}
+
+void PreferencesEnhanceImpl::StartBuildKeyFilter()
+{
+    int64_t buildTime = keyFilterBuildTime_.load(std::memory_order_relaxed);
+    if (buildTime != 0 && GetSteadyTimeUs() - buildTime < MIN_KEY_FILTER_BUILD_INTERVAL) {
+        return;
+    }
+    if (isKeyFilterBuilding_.exchange(true)) {
+        return;
+    }
+    Task task = [weakPref = weak_from_this()] {
+        auto pref = weakPref.lock();
+        if (pref != nullptr) {
+            pref->BuildKeyFilter();
         }
+    };
+    PreferencesTaskProcessor::GetInstance()->Execute(TaskLane::FLUSH, std::move(task));
+}
+
+void PreferencesEnhanceImpl::BuildKeyFilter()
+{
+    std::shared_lock<std::shared_mutex> readLock(dbMutex_);
+    keyFilterBuildTime_ = GetSteadyTimeUs();
+    int64_t kernelDataVersion = 0;
+    std::unique_ptr<PreferencesDbIterator> iterator;
+    int errCode = db_ == nullptr ? E_ALREADY_CLOSED : CheckDataVersion(kernelDataVersion);
+    if (errCode == E_OK) {
+        errCode = db_->CreateIterator(iterator);
+    }
+    std::vector<uint64_t> hashes;
+    GRD_KVItemT oriKey = { nullptr, 0 };
+    GRD_KVItemT oriValue = { nullptr, 0 };
+    while (errCode == E_OK && (errCode = iterator->Next(oriKey, oriValue)) == E_OK) {
+        hashes.push_back(PreferencesBloomFilter::Hash(
+            std::string_view(static_cast<const char *>(oriKey.data), oriKey.dataLen)));
     }
+    iterator = nullptr;
+    if (errCode != E_NO_DATA) {
+        LOG_WARN("build key filter failed, errCode=%{public}d", errCode);
+        isKeyFilterBuilding_ = false;
+        return;
+    }
+    auto filter = std::make_shared<PreferencesBloomFilter>(hashes.size(), kernelDataVersion);
+    for (uint64_t hash : hashes) {
+        filter->Add(hash);
+    }
+    std::atomic_store(&keyFilter_, filter);
+    isKeyFilterBuilding_ = false;
+}
 
-    std::vector<uint8_t> oriKey(key.begin(), key.end());
-    std::vector<uint8_t> oriValue;
-    int errCode = db_->Get(oriKey, oriValue);
+int PreferencesEnhanceImpl::GetInner(const std::string &key, PreferencesValue &value, bool &isExist)
+{
+    if (GetPendingWrite(key, &value, isExist)) {
+        return isExist ? E_OK : E_NO_DATA;
+    }
+    int64_t kernelDataVersion = 0;
+    if (GetDataVersion(kernelDataVersion) != E_OK) {
+        return E_ERROR;
+    }
+    if (IsKeyAbsent(key, kernelDataVersion)) {
+        return E_NO_DATA;
+    }
+    if (valueCache_.Get(key, kernelDataVersion, value, isExist)) {
+        return isExist ? E_OK : E_NO_DATA;
+    }
+
+    GRD_KVItemT oriValue = { nullptr, 0 };
+    int errCode = db_->Get(key, oriValue);
     if (errCode == E_NO_DATA) {
-        return defValue;
+        valueCache_.PutAbsent(key, kernelDataVersion);
+        return errCode;
     }
     if (errCode != E_OK) {
-        return defValue;
+        return errCode;
     }
-    auto item = PreferencesValueParcel::UnmarshallingPreferenceValue(oriValue);
+    isExist = true;
+    // decode from the memory of the db, the value is not copied before.
+    auto item = PreferencesValueParcel::UnmarshallingPreferenceValue(static_cast<const uint8_t *>(oriValue.data),
+        oriValue.dataLen);
+    uint32_t oriValueLen = oriValue.dataLen;
+    db_->FreeItem(oriValue);
     if (item.first != E_OK) {
+        return item.first;
+    }
+    valueCache_.Put(key, item.second, oriValueLen, kernelDataVersion);
+    value = std::move(item.second);
+    return E_OK;
+}
+
+int PreferencesEnhanceImpl::HasKeyInner(const std::string &key, bool &isExist)
+{
+    if (GetPendingWrite(key, nullptr, isExist)) {
+        return E_OK;
+    }
+    int64_t kernelDataVersion = 0;
+    if (GetDataVersion(kernelDataVersion) != E_OK) {
+        return E_ERROR;
+    }
+    if (IsKeyAbsent(key, kernelDataVersion)) {
+        isExist = false;
+        return E_OK;
+    }
+    if (valueCache_.Contains(key, kernelDataVersion, isExist)) {
+        return E_OK;
+    }
+    int errCode = db_->HasKey(key, isExist);
+    if (errCode != E_OK) {
+        return errCode;
+    }
+    if (!isExist) {
+        valueCache_.PutAbsent(key, kernelDataVersion);
+    }
+    return E_OK;
+}
+
+PreferencesValue PreferencesEnhanceImpl::Get(const std::string &key, const PreferencesValue &defValue)
+{
+    if (PreferencesUtils::CheckKey(key) != E_OK || WaitOpen() != E_OK) {
+        return defValue;
+    }
+    RecordKey(key);
+    std::shared_lock<std::shared_mutex> readLock(dbMutex_);
+    if (db_ == nullptr) {
+        LOG_ERROR("PreferencesEnhanceImpl:Get failed, db has been closed.");
         return defValue;
     }
-    if (oriValue.size() >= CACHED_THRESHOLDS) {
-        largeCachedData_.insert_or_assign(key, item.second);
-        cachedDataVersion_ = kernelDataVersion;
+
+    PreferencesValue value;
+    bool isExist = false;
+    if (GetInner(key, value, isExist) != E_OK) {
+        return defValue;
     }
-    return item.second;
+    return value;
 }
 
 bool PreferencesEnhanceImpl::HasKey(const std::string &key)
 {
-    if (PreferencesUtils::CheckKey(key) != E_OK) {
+    if (PreferencesUtils::CheckKey(key) != E_OK || WaitOpen() != E_OK) {
         return false;
     }
-    std::unique_lock<std::shared_mutex> writeLock(dbMutex_);
+    RecordKey(key);
+    std::shared_lock<std::shared_mutex> readLock(dbMutex_);
     if (db_ == nullptr) {
         LOG_ERROR("PreferencesEnhanceImpl:HasKey failed, db has been closed.");
         return false;
     }
 
+    bool isExist = false;
+    (void)HasKeyInner(key, isExist);
+    return isExist;
+}
+
+int PreferencesEnhanceImpl::PutToDb(const std::string &key, const PreferencesValue &value)
+{
+    uint32_t oriValueLen = PreferencesValueParcel::CalSize(value);
+    std::vector<uint8_t> &oriValue = GetEncodeBuffer(oriValueLen);
+    int errCode = PreferencesValueParcel::MarshallingPreferenceValue(value, oriValue);
+    if (errCode != E_OK) {
+        LOG_ERROR("marshalling value failed, errCode=%{public}d", errCode);
+        return errCode;
+    }
+    int64_t versionBefore = GetVersionBeforeWrite();
+    errCode = db_->Put(key, oriValue);
+    if (errCode != E_OK) {
+        return errCode;
+    }
+
     int64_t kernelDataVersion = 0;
-    if (db_->GetKernelDataVersion(kernelDataVersion) != E_OK) {
-        return false;
+    if (CheckDataVersion(kernelDataVersion) == E_OK) {
+        valueCache_.AdvanceVersion(kernelDataVersion);
+        valueCache_.Put(key, value, oriValueLen, kernelDataVersion);
+        UpdateKeyFilter(&key, versionBefore, kernelDataVersion);
+    } else {
+        valueCache_.Clear();
+        std::atomic_store(&keyFilter_, std::shared_ptr<PreferencesBloomFilter>());
+    }
+    return E_OK;
+}
+
+int PreferencesEnhanceImpl::DeleteFromDb(const std::string &key)
+{
+    int64_t versionBefore = GetVersionBeforeWrite();
+    int errCode = db_->Delete(key);
+    if (errCode != E_OK) {
+        return errCode;
+    }
+
+    int64_t kernelDataVersion = 0;
+    if (CheckDataVersion(kernelDataVersion) == E_OK) {
+        valueCache_.AdvanceVersion(kernelDataVersion);
+        valueCache_.PutAbsent(key, kernelDataVersion);
+        UpdateKeyFilter(nullptr, versionBefore, kernelDataVersion);
+    } else {
+        valueCache_.Clear();
+        std::atomic_store(&keyFilter_, std::shared_ptr<PreferencesBloomFilter>());
+    }
+    return E_OK;
+}
+
+int PreferencesEnhanceImpl::BufferWrite(const std::string &key, const PreferencesValue *value)
+{
+    bool isFull = false;
+    {
+        std::shared_lock<std::shared_mutex> readLock(dbMutex_);
+        if (db_ == nullptr) {
+            LOG_ERROR("PreferencesEnhanceImpl:BufferWrite failed, db has been closed.");
+            return E_ERROR;
+        }
+        std::lock_guard<std::mutex> lock(memtableMutex_);
+        PendingWrite &write = memtable_[key];
+        memtableBytes_ -= write.size;
+        write.isDeleted = (value == nullptr);
+        write.value = write.isDeleted ? PreferencesValue() : *value;
+        write.size = key.size() + (write.isDeleted ? 0 : PreferencesValueParcel::CalSize(*value));
+        memtableBytes_ += write.size;
+        isFull = memtableBytes_ >= MAX_MEMTABLE_BYTES;
+        if (!isFull) {
+            ScheduleMemtableFlush(memtableBytes_ >= MEMTABLE_FLUSH_BYTES);
+        }
     }
-    if (kernelDataVersion == cachedDataVersion_) {
-        auto it = largeCachedData_.find(key);
-        if (it != largeCachedData_.end()) {
-            return true;
+    if (isFull) {
+        // the background flush falls behind, the writer waits for it instead of growing the memtable further.
+        std::unique_lock<std::shared_mutex> writeLock(dbMutex_);
+        if (db_ != nullptr && FlushMemtable() != E_OK) {
+            LOG_WARN("the memtable is full and can not be flushed, size:%{public}zu", memtableBytes_);
         }
     }
+    return E_OK;
+}
 
-    std::vector<uint8_t> oriKey(key.begin(), key.end());
-    std::vector<uint8_t> oriValue;
-    int errCode = db_->Get(oriKey, oriValue);
-    if (errCode == E_NO_DATA) {
+bool PreferencesEnhanceImpl::GetPendingWrite(const std::string &key, PreferencesValue *value, bool &isExist)
+{
+    if (!isWriteBehind_) {
         return false;
     }
-    if (errCode != E_OK) {
+    std::lock_guard<std::mutex> lock(memtableMutex_);
+    auto it = memtable_.find(key);
+    if (it == memtable_.end()) {
         return false;
     }
-    if (oriValue.size() >= CACHED_THRESHOLDS) {
-        auto item = PreferencesValueParcel::UnmarshallingPreferenceValue(oriValue);
-        if (item.first != E_OK) {
-            return true;
-        }
-        largeCachedData_.insert_or_assign(key, item.second);
-        cachedDataVersion_ = kernelDataVersion;
+    isExist = !it->second.isDeleted;
+    if (isExist && value != nullptr) {
+        *value = it->second.value;
     }
     return true;
 }
 
-int PreferencesEnhanceImpl::Put(const std::string &key, const PreferencesValue &value)
+template<typename Map>
+void PreferencesEnhanceImpl::ApplyPendingWrites(Map &data)
+{
+    if (!isWriteBehind_) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(memtableMutex_);
+    for (const auto &[key, write] : memtable_) {
+        if (write.isDeleted) {
+            data.erase(key);
+        } else {
+            data.insert_or_assign(key, write.value);
+        }
+    }
+}
+
+void PreferencesEnhanceImpl::ScheduleMemtableFlush(bool isUrgent)
+{
+    std::atomic<bool> &flag = isUrgent ? isMemtableFlushUrgent_ : isMemtableFlushScheduled_;
+    if (flag.exchange(true)) {
+        return;
+    }
+    Task task = [weakPref = weak_from_this()] {
+        auto pref = weakPref.lock();
+        if (pref == nullptr) {
+            return;
+        }
+        int errCode = pref->FlushSync();
+        if (errCode != E_OK) {
+            // the writes left are kept in the memtable, the flush is tried again later.
+            LOG_ERROR("background flush of the memtable failed, errCode=%{public}d, file: %{public}s", errCode,
+                ExtractFileName(pref->options_.filePath).c_str());
+            pref->ScheduleMemtableFlush(false);
+        }
+    };
+    if (isUrgent) {
+        PreferencesTaskProcessor::GetInstance()->Execute(TaskLane::FLUSH, std::move(task));
+    } else {
+        PreferencesTaskProcessor::GetInstance()->Schedule(TaskLane::FLUSH, MEMTABLE_FLUSH_DELAY,
+            std::move(task));
+    }
+}
+
+int PreferencesEnhanceImpl::FlushMemtable()
+{
+    isMemtableFlushScheduled_ = false;
+    isMemtableFlushUrgent_ = false;
+    // the buffered writers hold dbMutex_ shared, so the memtable does not change during the flush. The erases still
+    // take memtableMutex_ for the readers holding it alone. A write which fails stays in the memtable with the ones
+    // after it.
+    int errCode = E_OK;
+    std::vector<std::pair<std::string, PreferencesValue>> written;
+    auto it = memtable_.begin();
+    while (it != memtable_.end()) {
+        errCode = it->second.isDeleted ? DeleteFromDb(it->first) : PutToDb(it->first, it->second.value);
+        if (errCode != E_OK && errCode != E_NO_DATA) {
+            LOG_ERROR("flush memtable failed, errCode=%{public}d, %{public}zu writes left", errCode, memtable_.size());
+            break;
+        }
+        errCode = E_OK;
+        std::lock_guard<std::mutex> lock(memtableMutex_);
+        memtableBytes_ -= it->second.size;
+        written.emplace_back(it->first, std::move(it->second.value));
+        it = memtable_.erase(it);
+    }
+    NotifyWritten(std::move(written));
+    return errCode;
+}
+
+void PreferencesEnhanceImpl::NotifyWritten(std::vector<std::pair<std::string, PreferencesValue>> &&written)
+{
+    if (written.empty()) {
+        return;
+    }
+    // the last flush runs in the destructor, when nobody can observe the preferences anymore.
+    auto pref = weak_from_this().lock();
+    if (pref == nullptr) {
+        return;
+    }
+    Task task = [pref, written = std::move(written)] {
+        for (const auto &[key, value] : written) {
+            PreferencesEnhanceImpl::NotifyPreferencesObserver(pref, key, value);
+        }
+    };
+    PreferencesTaskProcessor::GetInstance()->Execute(TaskLane::NOTIFY, std::move(task));
+}
+
+template<typename K, typename V>
+int PreferencesEnhanceImpl::PutInner(K &&key, V &&value)
 {
     int errCode = PreferencesUtils::CheckKey(key);
     if (errCode != E_OK) {
@@ -157,121 +692,276 @@ int PreferencesEnhanceImpl::Put(const std::string &key, const PreferencesValue &
     if (errCode != E_OK) {
         return errCode;
     }
-    ReportObjectUsage(shared_from_this(), value);
-    std::unique_lock<std::shared_mutex> writeLock(dbMutex_);
-    if (db_ == nullptr) {
-        LOG_ERROR("PreferencesEnhanceImpl:Put failed, db has been closed.");
-        return E_ERROR;
-    }
-
-    std::vector<uint8_t> oriValue;
-    uint32_t oriValueLen = PreferencesValueParcel::CalSize(value);
-    oriValue.resize(oriValueLen);
-    errCode = PreferencesValueParcel::MarshallingPreferenceValue(value, oriValue);
+    errCode = WaitOpen();
     if (errCode != E_OK) {
-        LOG_ERROR("marshalling value failed, errCode=%{public}d", errCode);
         return errCode;
     }
-    std::vector<uint8_t> oriKey(key.begin(), key.end());
-    errCode = db_->Put(oriKey, oriValue);
-    if (errCode != E_OK) {
-        return errCode;
+    ReportObjectUsage(shared_from_this(), value);
+    if (isWriteBehind_) {
+        // the observers are notified when the write reaches the db, by the flush of the memtable.
+        return BufferWrite(key, &value);
     }
-
-    // update cached and version
-    if (oriValueLen >= CACHED_THRESHOLDS) {
-        largeCachedData_.insert_or_assign(key, value);
-        cachedDataVersion_ = cachedDataVersion_ == INT64_MAX ? 0 : cachedDataVersion_ + 1;
-    } else {
-        auto pos = largeCachedData_.find(key);
-        if (pos != largeCachedData_.end()) {
-            largeCachedData_.erase(pos);
+    {
+        std::unique_lock<std::shared_mutex> writeLock(dbMutex_);
+        if (db_ == nullptr) {
+            LOG_ERROR("PreferencesEnhanceImpl:Put failed, db has been closed.");
+            return E_ERROR;
         }
+        errCode = PutToDb(key, value);
+    }
+    if (errCode != E_OK) {
+        return errCode;
     }
 
-    ExecutorPool::Task task = [pref = shared_from_this(), key, value] {
+    // the notify task is the last user of the key and value, hand them over instead of copying.
+    Task task = [pref = shared_from_this(), key = std::forward<K>(key),
+        value = std::forward<V>(value)] {
         PreferencesEnhanceImpl::NotifyPreferencesObserver(pref, key, value);
     };
-    executorPool_.Execute(std::move(task));
+    PreferencesTaskProcessor::GetInstance()->Execute(TaskLane::NOTIFY, std::move(task));
     return E_OK;
 }
 
+int PreferencesEnhanceImpl::Put(const std::string &key, const PreferencesValue &value)
+{
+    return PutInner(key, value);
+}
+
+int PreferencesEnhanceImpl::Put(std::string &&key, PreferencesValue &&value)
+{
+    return PutInner(std::move(key), std::move(value));
+}
+
 int PreferencesEnhanceImpl::Delete(const std::string &key)
 {
     int errCode = PreferencesUtils::CheckKey(key);
     if (errCode != E_OK) {
         return errCode;
     }
-    std::unique_lock<std::shared_mutex> writeLock(dbMutex_);
-    if (db_ == nullptr) {
-        LOG_ERROR("PreferencesEnhanceImpl:Delete failed, db has been closed.");
-        return E_ERROR;
-    }
-
-    std::vector<uint8_t> oriKey(key.begin(), key.end());
-    errCode = db_->Delete(oriKey);
+    errCode = WaitOpen();
     if (errCode != E_OK) {
         return errCode;
     }
-
-    // update cached and version
-    auto it = largeCachedData_.find(key);
-    if (it != largeCachedData_.end()) {
-        largeCachedData_.erase(it);
-        cachedDataVersion_ = cachedDataVersion_ == INT64_MAX ? 0 : cachedDataVersion_ + 1;
+    if (isWriteBehind_) {
+        // the observers are notified when the delete reaches the db, by the flush of the memtable.
+        return BufferWrite(key, nullptr);
+    }
+    {
+        std::unique_lock<std::shared_mutex> writeLock(dbMutex_);
+        if (db_ == nullptr) {
+            LOG_ERROR("PreferencesEnhanceImpl:Delete failed, db has been closed.");
+            return E_ERROR;
+        }
+        errCode = DeleteFromDb(key);
+    }
+    if (errCode != E_OK) {
+        return errCode;
     }
 
     PreferencesValue value;
-    ExecutorPool::Task task = [pref = shared_from_this(), key, value] {
+    Task task = [pref = shared_from_this(), key, value] {
         PreferencesEnhanceImpl::NotifyPreferencesObserver(pref, key, value);
     };
-    executorPool_.Execute(std::move(task));
+    PreferencesTaskProcessor::GetInstance()->Execute(TaskLane::NOTIFY, std::move(task));
     return E_OK;
 }
 
-std::pair<int, std::unordered_map<std::string, PreferencesValue>> PreferencesEnhanceImpl::GetAllInner()
+// the entries of the db are streamed in key order one batch at a time, each batch reopens the cursor at the last
+// key read under one read lock, which is released before Next returns. The values are decoded from the cursor and
+// bypass the value cache. The pending writes at the creation of the iterator replace the entries of the db, the
+// ones which are not deleted are returned last.
+class PreferencesEnhanceIterator : public PreferencesIterator {
+public:
+    PreferencesEnhanceIterator(std::shared_ptr<PreferencesEnhanceImpl> pref,
+        PreferencesEnhanceImpl::PendingWrites &&pendingWrites)
+        : pref_(std::move(pref)), pendingWrites_(std::move(pendingWrites)), pendingPos_(pendingWrites_.begin())
+    {
+    }
+
+    int Next(std::string &key, PreferencesValue &value) override
+    {
+        while (batchPos_ == batch_.size()) {
+            if (isDbDone_) {
+                return NextPendingWrite(key, value);
+            }
+            int errCode = ReadBatch();
+            if (errCode != E_OK) {
+                return errCode;
+            }
+        }
+        auto &entry = batch_[batchPos_++];
+        key = std::move(entry.first);
+        value = std::move(entry.second);
+        return E_OK;
+    }
+
+private:
+    static constexpr size_t BATCH_SIZE = 64;
+
+    int NextPendingWrite(std::string &key, PreferencesValue &value)
+    {
+        for (; pendingPos_ != pendingWrites_.end(); pendingPos_++) {
+            if (!pendingPos_->second.isDeleted) {
+                key = pendingPos_->first;
+                value = std::move(pendingPos_->second.value);
+                pendingPos_++;
+                return E_OK;
+            }
+        }
+        return E_NO_DATA;
+    }
+
+    int ReadBatch()
+    {
+        batch_.clear();
+        batchPos_ = 0;
+        std::shared_lock<std::shared_mutex> readLock(pref_->dbMutex_);
+        if (pref_->db_ == nullptr) {
+            LOG_ERROR("PreferencesEnhanceIterator:Next failed, db has been closed.");
+            return E_ALREADY_CLOSED;
+        }
+        std::unique_ptr<PreferencesDbIterator> iterator;
+        int errCode = pref_->db_->CreateIterator(iterator, lastKey_.has_value() ? &lastKey_.value() : nullptr);
+        if (errCode != E_OK) {
+            return errCode;
+        }
+        GRD_KVItemT oriKey = { nullptr, 0 };
+        GRD_KVItemT oriValue = { nullptr, 0 };
+        while (batch_.size() < BATCH_SIZE && (errCode = iterator->Next(oriKey, oriValue)) == E_OK) {
+            std::string key(static_cast<const char *>(oriKey.data), oriKey.dataLen);
+            // the cursor starts at the last key of the previous batch when it has not been deleted since.
+            if (lastKey_.has_value() && key == lastKey_.value()) {
+                continue;
+            }
+            lastKey_ = key;
+            if (pendingWrites_.find(key) != pendingWrites_.end()) {
+                continue;
+            }
+            auto item = PreferencesValueParcel::UnmarshallingPreferenceValue(
+                static_cast<const uint8_t *>(oriValue.data), oriValue.dataLen);
+            if (item.first != E_OK) {
+                return item.first;
+            }
+            batch_.emplace_back(std::move(key), std::move(item.second));
+        }
+        if (errCode == E_NO_DATA) {
+            isDbDone_ = true;
+            return E_OK;
+        }
+        return errCode;
+    }
+
+    std::shared_ptr<PreferencesEnhanceImpl> pref_;
+    PreferencesEnhanceImpl::PendingWrites pendingWrites_;
+    PreferencesEnhanceImpl::PendingWrites::iterator pendingPos_;
+    std::optional<std::string> lastKey_;
+    bool isDbDone_ = false;
+    std::vector<std::pair<std::string, PreferencesValue>> batch_;
+    size_t batchPos_ = 0;
+};
+
+template<typename Map>
+int PreferencesEnhanceImpl::GetAllInner(Map &data)
 {
-    std::unordered_map<std::string, PreferencesValue> map;
     if (db_ == nullptr) {
         LOG_ERROR("PreferencesEnhanceImpl:GetAll failed, db has been closed.");
-        return std::make_pair(E_ALREADY_CLOSED, map);
+        return E_ALREADY_CLOSED;
+    }
+    std::unique_ptr<PreferencesDbIterator> iterator;
+    int errCode = db_->CreateIterator(iterator);
+    if (errCode != E_OK) {
+        return errCode;
     }
+    GRD_KVItemT oriKey = { nullptr, 0 };
+    GRD_KVItemT oriValue = { nullptr, 0 };
+    while ((errCode = iterator->Next(oriKey, oriValue)) == E_OK) {
+        auto item = PreferencesValueParcel::UnmarshallingPreferenceValue(static_cast<const uint8_t *>(oriValue.data),
+            oriValue.dataLen);
+        if (item.first != E_OK) {
+            data.clear();
+            return item.first;
+        }
+        data.insert_or_assign(std::string(static_cast<const char *>(oriKey.data), oriKey.dataLen),
+            std::move(item.second));
+    }
+    if (errCode != E_NO_DATA) {
+        data.clear();
+        return errCode;
+    }
+    ApplyPendingWrites(data);
+    return E_OK;
+}
 
-    int64_t kernelDataVersion = 0;
-    if (db_->GetKernelDataVersion(kernelDataVersion) != E_OK) {
-        return std::make_pair(E_ERROR, map);
+std::map<std::string, PreferencesValue> PreferencesEnhanceImpl::GetAll()
+{
+    int errCode = WaitOpen();
+    if (errCode != E_OK) {
+        LOG_ERROR("PreferencesEnhanceImpl:GetAll failed, the db failed to open, errCode=%{public}d.", errCode);
+        return {};
     }
+    std::shared_lock<std::shared_mutex> readLock(dbMutex_);
+    std::map<std::string, PreferencesValue> allDatas;
+    (void)GetAllInner(allDatas);
+    return allDatas;
+}
 
-    std::unordered_map<std::string, PreferencesValue> result;
-    std::list<std::pair<std::vector<uint8_t>, std::vector<uint8_t>>> data;
-    int errCode = db_->GetAll(data);
+std::pair<int, std::shared_ptr<PreferencesIterator>> PreferencesEnhanceImpl::CreateIterator()
+{
+    int errCode = WaitOpen();
     if (errCode != E_OK) {
-        return std::make_pair(errCode, map);
+        return { errCode, nullptr };
     }
-    for (auto it = data.begin(); it != data.end(); it++) {
-        std::string key(it->first.begin(), it->first.end());
-        auto item = PreferencesValueParcel::UnmarshallingPreferenceValue(it->second);
-        result.insert({key, item.second});
-        if (item.first != E_OK) {
-            return std::make_pair(item.first, map);
+    PendingWrites pendingWrites;
+    {
+        std::shared_lock<std::shared_mutex> readLock(dbMutex_);
+        if (db_ == nullptr) {
+            LOG_ERROR("PreferencesEnhanceImpl:CreateIterator failed, db has been closed.");
+            return { E_ALREADY_CLOSED, nullptr };
         }
-        if (it->second.size() >= CACHED_THRESHOLDS) {
-            largeCachedData_.insert_or_assign(key, item.second);
+        if (isWriteBehind_) {
+            std::lock_guard<std::mutex> lock(memtableMutex_);
+            pendingWrites = memtable_;
         }
     }
-    cachedDataVersion_ = kernelDataVersion;
-    return std::make_pair(E_OK, result);
+    return { E_OK, std::make_shared<PreferencesEnhanceIterator>(shared_from_this(), std::move(pendingWrites)) };
 }
 
-std::map<std::string, PreferencesValue> PreferencesEnhanceImpl::GetAll()
+void PreferencesEnhanceImpl::Flush()
 {
+    if (isWriteBehind_) {
+        ScheduleMemtableFlush(true);
+    }
+}
+
+int PreferencesEnhanceImpl::FlushSync()
+{
+    if (!isWriteBehind_ || WaitOpen() != E_OK) {
+        return E_OK;
+    }
     std::unique_lock<std::shared_mutex> writeLock(dbMutex_);
-    std::pair<int, std::unordered_map<std::string, PreferencesValue>> res = GetAllInner();
-    std::map<std::string, PreferencesValue> allDatas;
-    for (auto &it : res.second) {
-        allDatas.insert_or_assign(it.first, it.second);
+    if (db_ == nullptr) {
+        return E_OK;
     }
-    return allDatas;
+    return FlushMemtable();
+}
+
+bool PreferencesEnhanceImpl::HasDirtyData()
+{
+    if (!isWriteBehind_) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(memtableMutex_);
+    return !memtable_.empty();
+}
+
+int64_t PreferencesEnhanceImpl::GetMemoryBytes()
+{
+    size_t size = valueCache_.GetStats().usedBytes;
+    if (isWriteBehind_) {
+        std::lock_guard<std::mutex> lock(memtableMutex_);
+        size += memtableBytes_;
+    }
+    return static_cast<int64_t>(size);
 }
 
 void PreferencesEnhanceImpl::NotifyPreferencesObserver(std::shared_ptr<PreferencesEnhanceImpl> pref,
@@ -303,15 +993,97 @@ void PreferencesEnhanceImpl::NotifyPreferencesObserver(std::shared_ptr<Preferenc
 }
 
 void PreferencesEnhanceImpl::NotifyPreferencesObserverBatchKeys(std::shared_ptr<PreferencesEnhanceImpl> pref,
-    const std::unordered_map<std::string, PreferencesValue> &data)
+    const std::vector<std::string> &keys, const std::map<std::string, PreferencesValue> &values)
+{
+    std::shared_lock<std::shared_mutex> readLock(pref->observerMutex_);
+    // a data observer gets the keys it observes in one record.
+    for (const auto &[weakPrt, observedKeys] : pref->dataObserversMap_) {
+        std::map<std::string, PreferencesValue> records;
+        for (const auto &key : observedKeys) {
+            auto it = values.find(key);
+            if (it != values.end()) {
+                records.emplace(key, it->second);
+            }
+        }
+        if (records.empty()) {
+            continue;
+        }
+        if (std::shared_ptr<PreferencesObserver> sharedPtr = weakPrt.lock()) {
+            LOG_DEBUG("dataChange observer call, resultSize:%{public}zu", records.size());
+            sharedPtr->OnChange(records);
+        }
+    }
+    for (const auto &weakPreferencesObserver : pref->localObservers_) {
+        if (std::shared_ptr<PreferencesObserver> sharedPreferencesObserver = weakPreferencesObserver.lock()) {
+            for (const auto &key : keys) {
+                sharedPreferencesObserver->OnChange(key);
+            }
+        }
+    }
+    auto dataObsMgrClient = DataObsMgrClient::GetInstance();
+    if (dataObsMgrClient != nullptr) {
+        for (const auto &key : keys) {
+            dataObsMgrClient->NotifyChange(pref->MakeUri(key));
+        }
+    }
+}
+
+std::set<std::string> PreferencesEnhanceImpl::GetObservedKeys()
+{
+    std::shared_lock<std::shared_mutex> readLock(observerMutex_);
+    std::set<std::string> observedKeys;
+    for (const auto &[weakPrt, keys] : dataObserversMap_) {
+        observedKeys.insert(keys.begin(), keys.end());
+    }
+    return observedKeys;
+}
+
+int PreferencesEnhanceImpl::GetAllKeys(const std::set<std::string> &valueKeys, std::vector<std::string> &keys,
+    std::map<std::string, PreferencesValue> &values)
 {
-    for (const auto &[key, value] : data) {
-        NotifyPreferencesObserver(pref, key, value);
+    std::unique_ptr<PreferencesDbIterator> iterator;
+    int errCode = db_->CreateIterator(iterator);
+    if (errCode != E_OK) {
+        return errCode;
+    }
+    std::lock_guard<std::mutex> lock(memtableMutex_);
+    GRD_KVItemT oriKey = { nullptr, 0 };
+    GRD_KVItemT oriValue = { nullptr, 0 };
+    while ((errCode = iterator->Next(oriKey, oriValue)) == E_OK) {
+        std::string key(static_cast<const char *>(oriKey.data), oriKey.dataLen);
+        if (memtable_.find(key) != memtable_.end()) {
+            continue;
+        }
+        if (valueKeys.find(key) != valueKeys.end()) {
+            auto item = PreferencesValueParcel::UnmarshallingPreferenceValue(
+                static_cast<const uint8_t *>(oriValue.data), oriValue.dataLen);
+            values.insert_or_assign(key, item.first == E_OK ? std::move(item.second) : PreferencesValue());
+        }
+        keys.push_back(std::move(key));
     }
+    if (errCode != E_NO_DATA) {
+        return errCode;
+    }
+    for (const auto &[key, write] : memtable_) {
+        if (write.isDeleted) {
+            continue;
+        }
+        if (valueKeys.find(key) != valueKeys.end()) {
+            values.insert_or_assign(key, write.value);
+        }
+        keys.push_back(key);
+    }
+    return E_OK;
 }
 
 int PreferencesEnhanceImpl::Clear()
 {
+    // read before dbMutex_, the observers may read the preferences holding observerMutex_.
+    std::set<std::string> observedKeys = GetObservedKeys();
+    int errCode = WaitOpen();
+    if (errCode != E_OK) {
+        return errCode;
+    }
     std::unique_lock<std::shared_mutex> writeLock(dbMutex_);
     LOG_INFO("Clear called, file: %{public}s", ExtractFileName(options_.filePath).c_str());
     if (db_ == nullptr) {
@@ -319,47 +1091,67 @@ int PreferencesEnhanceImpl::Clear()
         return E_ERROR;
     }
 
-    std::pair<int, std::unordered_map<std::string, PreferencesValue>> res = GetAllInner();
-    if (res.first != E_OK) {
-        LOG_ERROR("get all failed when clear, errCode=%{public}d", res.first);
-        return res.first;
+    // only the values of the observed keys are read for the notifications.
+    std::vector<std::string> keys;
+    std::map<std::string, PreferencesValue> values;
+    errCode = GetAllKeys(observedKeys, keys, values);
+    if (errCode != E_OK) {
+        LOG_ERROR("get all keys failed when clear, errCode=%{public}d", errCode);
+        return errCode;
     }
 
-    std::unordered_map<std::string, PreferencesValue> allData = res.second;
-
-    int errCode = db_->DropCollection();
+    errCode = db_->DropCollection();
     if (errCode != E_OK) {
         return errCode;
     }
+    {
+        std::lock_guard<std::mutex> lock(memtableMutex_);
+        memtable_.clear();
+        memtableBytes_ = 0;
+    }
 
-    if (!allData.empty()) {
-        ExecutorPool::Task task = [pref = shared_from_this(), allData] {
-            PreferencesEnhanceImpl::NotifyPreferencesObserverBatchKeys(pref, allData);
+    if (!keys.empty()) {
+        Task task = [pref = shared_from_this(), keys = std::move(keys), values = std::move(values)] {
+            PreferencesEnhanceImpl::NotifyPreferencesObserverBatchKeys(pref, keys, values);
         };
-        executorPool_.Execute(std::move(task));
+        PreferencesTaskProcessor::GetInstance()->Execute(TaskLane::NOTIFY, std::move(task));
     }
 
     errCode = db_->CreateCollection();
     if (errCode != E_OK) {
         return errCode;
     }
-    largeCachedData_.clear();
-    cachedDataVersion_ = cachedDataVersion_ == INT64_MAX ? 0 : cachedDataVersion_ + 1;
+    valueCache_.Clear();
+    versionCheckTime_ = 0;
+    // the store is empty now, so is the filter.
+    int64_t kernelDataVersion = 0;
+    std::shared_ptr<PreferencesBloomFilter> filter;
+    if (CheckDataVersion(kernelDataVersion) == E_OK) {
+        filter = std::make_shared<PreferencesBloomFilter>(0, kernelDataVersion);
+    }
+    std::atomic_store(&keyFilter_, filter);
     return E_OK;
 }
 
 int PreferencesEnhanceImpl::CloseDb()
 {
+    // a failed open leaves nothing to close.
+    (void)WaitOpen();
     std::unique_lock<std::shared_mutex> writeLock(dbMutex_);
     if (db_ == nullptr) {
         LOG_WARN("PreferencesEnhanceImpl:CloseDb failed, db has been closed, no need to close again.");
         return E_OK;
     }
-    int errCode = db_->CloseDb();
+    int errCode = FlushMemtable();
     if (errCode != E_OK) {
         return errCode;
     }
-    largeCachedData_.clear();
+    errCode = db_->CloseDb();
+    if (errCode != E_OK) {
+        return errCode;
+    }
+    valueCache_.Clear();
+    std::atomic_store(&keyFilter_, std::shared_ptr<PreferencesBloomFilter>());
     db_ = nullptr;
     return E_OK;
 }
@@ -371,59 +1163,82 @@ std::pair<int, PreferencesValue> PreferencesEnhanceImpl::GetValue(const std::str
     if (errCode != E_OK) {
         return std::make_pair(errCode, defValue);
     }
-    // write lock here, get not support concurrence
-    std::unique_lock<std::shared_mutex> writeLock(dbMutex_);
+    errCode = WaitOpen();
+    if (errCode != E_OK) {
+        return std::make_pair(errCode, defValue);
+    }
+    RecordKey(key);
+    std::shared_lock<std::shared_mutex> readLock(dbMutex_);
     if (db_ == nullptr) {
         LOG_ERROR("PreferencesEnhanceImpl:Get failed, db has been closed.");
         return std::make_pair(E_ALREADY_CLOSED, defValue);
     }
 
-    int64_t kernelDataVersion = 0;
-    if (db_->GetKernelDataVersion(kernelDataVersion) != E_OK) {
-        return std::make_pair(E_ERROR, defValue);
-    }
-    if (kernelDataVersion == cachedDataVersion_) {
-        auto it = largeCachedData_.find(key);
-        if (it != largeCachedData_.end()) {
-            return std::make_pair(E_OK, it->second);
-        }
-    }
-
-    std::vector<uint8_t> oriKey(key.begin(), key.end());
-    std::vector<uint8_t> oriValue;
-    errCode = db_->Get(oriKey, oriValue);
-    if (errCode == E_NO_DATA) {
+    PreferencesValue value;
+    bool isExist = false;
+    errCode = GetInner(key, value, isExist);
+    if (errCode != E_OK) {
         return std::make_pair(errCode, defValue);
     }
+    return std::make_pair(E_OK, value);
+}
+
+std::pair<int, PreferencesValue> PreferencesEnhanceImpl::TryGet(const std::string &key,
+    const PreferencesValue &defValue)
+{
+    int errCode = PreferencesUtils::CheckKey(key);
     if (errCode != E_OK) {
         return std::make_pair(errCode, defValue);
     }
-    auto item = PreferencesValueParcel::UnmarshallingPreferenceValue(oriValue);
-    if (item.first != E_OK) {
-        return std::make_pair(item.first, defValue);
+    if (!IsOpenDone()) {
+        return std::make_pair(E_NOT_LOADED, GetLoadingDefault(key, defValue));
     }
-    if (oriValue.size() >= CACHED_THRESHOLDS) {
-        largeCachedData_.insert_or_assign(key, item.second);
-        cachedDataVersion_ = kernelDataVersion;
+    return GetValue(key, defValue);
+}
+
+void PreferencesEnhanceImpl::GetAsync(const std::string &key, const PreferencesValue &defValue,
+    std::function<void(std::pair<int, PreferencesValue>)> callback, PreferencesResumer resumer)
+{
+    RunAfterOpen([pref = shared_from_this(), key, defValue, callback = std::move(callback), resumer] {
+        auto result = pref->GetValue(key, defValue);
+        Resume(resumer, [callback, result] { callback(result); });
+    });
+}
+
+void PreferencesEnhanceImpl::FlushAsync(std::function<void(int)> callback, PreferencesResumer resumer)
+{
+    Task task = [pref = shared_from_this(), callback = std::move(callback), resumer] {
+        int errCode = pref->FlushSync();
+        Resume(resumer, [callback, errCode] { callback(errCode); });
+    };
+    if (!PreferencesTaskProcessor::GetInstance()->Execute(TaskLane::FLUSH, task)) {
+        task();
     }
-    return std::make_pair(E_OK, item.second);
 }
 
 std::pair<int, std::map<std::string, PreferencesValue>> PreferencesEnhanceImpl::GetAllData()
 {
-    std::unique_lock<std::shared_mutex> writeLock(dbMutex_);
-    std::pair<int, std::unordered_map<std::string, PreferencesValue>> res = GetAllInner();
-    std::map<std::string, PreferencesValue> allDatas;
-    for (auto &it : res.second) {
-        allDatas.insert_or_assign(it.first, it.second);
+    int errCode = WaitOpen();
+    if (errCode != E_OK) {
+        return { errCode, {} };
     }
-    return {res.first, allDatas};
+    std::shared_lock<std::shared_mutex> readLock(dbMutex_);
+    std::map<std::string, PreferencesValue> allDatas;
+    errCode = GetAllInner(allDatas);
+    return {errCode, std::move(allDatas)};
 }
 
 std::unordered_map<std::string, PreferencesValue> PreferencesEnhanceImpl::GetAllDatas()
 {
-    std::unique_lock<std::shared_mutex> writeLock(dbMutex_);
-    return GetAllInner().second;
+    int errCode = WaitOpen();
+    if (errCode != E_OK) {
+        LOG_ERROR("PreferencesEnhanceImpl:GetAllDatas failed, the db failed to open, errCode=%{public}d.", errCode);
+        return {};
+    }
+    std::shared_lock<std::shared_mutex> readLock(dbMutex_);
+    std::unordered_map<std::string, PreferencesValue> allDatas;
+    (void)GetAllInner(allDatas);
+    return allDatas;
 }
 } // End of namespace NativePreferences
 } // End of namespace OHOS
@@ -18,8 +18,14 @@
 #include <cerrno>
 #include <climits>
 #include <cstdlib>
+#include <functional>
+#include <algorithm>
+#include <future>
+#include <tuple>
+#include <unordered_set>
 #include <utility>
 
+#include "executor_pool.h"
 #include "log_print.h"
 #include "preferences.h"
 #include "preferences_errno.h"
@@ -28,25 +34,75 @@
 #include "preferences_dfx_adapter.h"
 #include "preferences_impl.h"
 #include "preferences_enhance_impl.h"
+#include "preferences_prefetch_manifest.h"
+#include "preferences_task_processor.h"
 #include "preferences_utils.h"
 
 namespace OHOS {
 namespace NativePreferences {
 std::map<std::string, std::pair<std::shared_ptr<Preferences>, bool>> PreferencesHelper::prefsCache_;
+std::map<std::string, std::shared_future<PreferencesHelper::OpenResult>> PreferencesHelper::openingPrefs_;
 std::mutex PreferencesHelper::prefsCacheMutex_;
 std::atomic<bool> PreferencesHelper::isReportFault_(false);
 static constexpr const int DB_SUFFIX_NUM = 6;
 static constexpr const char *DB_SUFFIX[DB_SUFFIX_NUM] = { ".ctrl", ".ctrl.dwr", ".redo", ".undo", ".safe", ".map" };
+static constexpr const size_t MAX_FLUSH_THREAD_NUM = 4;
+static ExecutorPool g_flushPool(MAX_FLUSH_THREAD_NUM, 0);
+// the eviction of the idle instances, the maps are guarded by prefsCacheMutex_.
+static std::atomic<int64_t> g_cacheMemoryBudget = 0;
+static std::atomic<bool> g_isEvictPending = false;
+static uint64_t g_accessTick = 0;
+static std::map<std::string, uint64_t> g_accessTicks;
+static std::unordered_set<std::string> g_evictedPaths;
+// the evicted instances being closed and the eviction closing them, an open of the same file waits for the close.
+static uint64_t g_evictGeneration = 0;
+static std::map<std::string, std::pair<uint64_t, std::shared_future<void>>> g_closingPaths;
+static std::atomic<int64_t> g_cacheMemoryBytes = 0;
+static std::atomic<uint64_t> g_evictCount = 0;
+static std::atomic<uint64_t> g_reloadCount = 0;
+static std::atomic<uint64_t> g_reloadTime = 0;
+static std::atomic<uint64_t> g_openCount = 0;
+static constexpr const size_t MAX_PRELOAD_THREAD_NUM = 4;
+static ExecutorPool g_preloadPool(MAX_PRELOAD_THREAD_NUM, 0);
+
+static TaskPoolStatsGetter GetPoolStatsGetter(ExecutorPool &pool)
+{
+    return [&pool] {
+        auto poolStats = pool.GetStats();
+        TaskPoolStats stats;
+        stats.executorNum = poolStats.executorNum;
+        stats.queuedTaskNum = poolStats.queuedTaskNum;
+        stats.delayedTaskNum = poolStats.delayedTaskNum;
+        stats.schedulerWakeupCount = poolStats.schedulerWakeupCount;
+        return stats;
+    };
+}
+
+static bool RegisterPoolStats()
+{
+    PreferencesTaskProcessor::RegisterPoolStats("PreferencesFlushPool", GetPoolStatsGetter(g_flushPool));
+    PreferencesTaskProcessor::RegisterPoolStats("PreferencesPreloadPool", GetPoolStatsGetter(g_preloadPool));
+    return true;
+}
+__attribute__((used)) static bool g_isPoolStatsRegistered = RegisterPoolStats();
+// the recording of the prefetch manifest, the opens of the preload itself are not recorded. g_manifestMutex is
+// taken after prefsCacheMutex_ when both are held.
+static thread_local bool g_isPreloading = false;
+static std::atomic<bool> g_isManifestRecording = false;
+static std::mutex g_manifestMutex;
+static std::string g_manifestPath;
+static uint64_t g_manifestGeneration = 0;
+static std::vector<PreferencesPrefetchManifest::Entry> g_recordedEntries;
 
 static bool IsFileExist(const std::string &path)
 {
     struct stat buffer;
-    return (stat(path.c_str(), &buffer) == 0);
+    return (Stat(path, buffer) == 0);
 }
 
 static int RemoveEnhanceDb(const std::string &filePath)
 {
-    if (std::remove(filePath.c_str()) != 0) {
+    if (Remove(filePath) != 0) {
         LOG_ERROR("remove %{public}s failed.", ExtractFileName(filePath).c_str());
         return E_DELETE_FILE_FAIL;
     }
@@ -112,6 +168,44 @@ std::string PreferencesHelper::GetRealPath(const std::string &path, int &errorCo
     return path;
 }
 
+// Runs the action when the scope is left, by a return or by an exception.
+class ScopeExit {
+public:
+    explicit ScopeExit(std::function<void()> action) : action_(std::move(action))
+    {
+    }
+
+    ~ScopeExit()
+    {
+        action_();
+    }
+
+    ScopeExit(const ScopeExit &) = delete;
+    ScopeExit &operator=(const ScopeExit &) = delete;
+
+private:
+    std::function<void()> action_;
+};
+
+static void RecordOpen(const Options &options, const std::string &realPath, bool isEnhance)
+{
+    if (!g_isManifestRecording.load(std::memory_order_relaxed) || g_isPreloading) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(g_manifestMutex);
+    if (!g_isManifestRecording || g_recordedEntries.size() >= PreferencesPrefetchManifest::MAX_ENTRY_NUM) {
+        return;
+    }
+    for (const auto &entry : g_recordedEntries) {
+        if (entry.options.filePath == realPath) {
+            return;
+        }
+    }
+    PreferencesPrefetchManifest::Entry entry;
+    entry.options = Options(realPath, options.bundleName, options.dataGroupId, isEnhance);
+    g_recordedEntries.push_back(std::move(entry));
+}
+
 static bool IsInTrustList(const std::string &bundleName)
 {
     std::vector<std::string> trustList = {"uttest", "alipay", "com.jd.", "cmblife", "os.mms", "os.ouc",
@@ -161,46 +255,153 @@ int PreferencesHelper::GetPreferencesInner(const Options &options, bool &isEnhan
     return std::static_pointer_cast<PreferencesEnhanceImpl>(pref)->Init();
 }
 
+void PreferencesHelper::GetPreferencesAsync(const Options &options,
+    std::function<void(int, std::shared_ptr<Preferences>)> callback, PreferencesResumer resumer)
+{
+    ExecutorPool::Task task = [options, callback = std::move(callback), resumer] {
+        int errCode = E_OK;
+        auto pref = GetPreferences(options, errCode);
+        if (resumer == nullptr) {
+            callback(errCode, pref);
+            return;
+        }
+        resumer([callback, errCode, pref] { callback(errCode, pref); });
+    };
+    if (g_preloadPool.Execute(ExecutorPool::Task(task)) == ExecutorPool::INVALID_TASK_ID) {
+        task();
+    }
+}
+
 std::shared_ptr<Preferences> PreferencesHelper::GetPreferences(const Options &options, int &errCode)
 {
     std::string realPath = GetRealPath(options.filePath, errCode);
     if (realPath == "" || errCode != E_OK) {
         return nullptr;
     }
+    OpenState state;
+    StartOpen(realPath, state);
+    return FinishOpen(options, realPath, state, errCode);
+}
 
+void PreferencesHelper::StartOpen(const std::string &realPath, OpenState &state)
+{
     std::lock_guard<std::mutex> lock(prefsCacheMutex_);
     auto it = prefsCache_.find(realPath);
     if (it != prefsCache_.end()) {
         auto pre = it->second.first;
+        // the enhance preferences are cached while their db is opening, one that failed to open is opened again.
+        if (pre != nullptr && it->second.second &&
+            std::static_pointer_cast<PreferencesEnhanceImpl>(pre)->HasOpenFailed()) {
+            LOG_WARN("GetPreferences: the db of the cached preferences failed to open, open it again.");
+            pre = nullptr;
+        }
         if (pre != nullptr) { // LCOV_EXCL_BR_LINE
             LOG_DEBUG("GetPreferences: found preferences in cache");
-            return pre;
+            g_accessTicks[realPath] = ++g_accessTick;
+            state.pref = pre;
+            state.isEnhance = it->second.second;
+            return;
         }
-        LOG_DEBUG("GetPreferences: found preferences in cache but it's null, erase it.");
+        LOG_DEBUG("GetPreferences: found preferences in cache but it's null or failed, erase it.");
         prefsCache_.erase(it);
+        g_accessTicks.erase(realPath);
+    }
+    auto openingIt = openingPrefs_.find(realPath);
+    if (openingIt != openingPrefs_.end()) {
+        state.future = openingIt->second;
+        return;
+    }
+    state.promise = std::make_shared<std::promise<OpenResult>>();
+    state.future = state.promise->get_future().share();
+    openingPrefs_.emplace(realPath, state.future);
+    state.isReload = g_evictedPaths.erase(realPath) > 0;
+    auto closingIt = g_closingPaths.find(realPath);
+    if (closingIt != g_closingPaths.end()) {
+        state.closing = closingIt->second.second;
     }
+}
 
-    const_cast<Options &>(options).filePath = realPath;
-    std::string::size_type pos = realPath.find_last_of('/');
-    std::string filePath = realPath.substr(0, pos);
-    if (Access(filePath.c_str()) != 0) {
-        LOG_ERROR("The path is invalid, prefName is %{public}s.", ExtractFileName(filePath).c_str());
-        if (!PreferencesHelper::isReportFault_.exchange(true)) {
-            ReportFaultParam param = { "GetPreferences error", options.bundleName, NORMAL_DB,
-                ExtractFileName(options.filePath), E_INVALID_FILE_PATH, "The path is invalid." };
-            PreferencesDfxManager::ReportFault(param);
+std::shared_ptr<Preferences> PreferencesHelper::FinishOpen(const Options &options, const std::string &realPath,
+    OpenState &state, int &errCode)
+{
+    if (state.pref != nullptr) {
+        errCode = E_OK;
+        RecordOpen(options, realPath, state.isEnhance);
+        return state.pref;
+    }
+    if (state.closing.valid()) {
+        state.closing.wait();
+    }
+    if (state.promise == nullptr) {
+        // another thread is opening the same file, share its result.
+        const OpenResult &result = state.future.get();
+        errCode = result.errCode;
+        if (result.pref != nullptr) {
+            RecordOpen(options, realPath, result.isEnhance);
         }
+        return result.pref;
     }
+
+    // the open is settled however it ends, an exception included: the waiters get its result and the path leaves
+    // openingPrefs_.
     bool isEnhancePreferences = false;
     std::shared_ptr<Preferences> pref = nullptr;
-    errCode = GetPreferencesInner(options, isEnhancePreferences, pref);
-    if (errCode != E_OK) {
-        return nullptr;
+    errCode = E_ERROR;
+    {
+        ScopeExit settle([&realPath, &state, &isEnhancePreferences, &pref, &errCode] {
+            if (errCode != E_OK) {
+                pref = nullptr;
+            }
+            {
+                std::lock_guard<std::mutex> lock(prefsCacheMutex_);
+                if (pref != nullptr) {
+                    prefsCache_.insert_or_assign(realPath, std::make_pair(pref, isEnhancePreferences));
+                    g_accessTicks[realPath] = ++g_accessTick;
+                }
+                openingPrefs_.erase(realPath);
+            }
+            state.promise->set_value({ pref, isEnhancePreferences, errCode });
+        });
+        // the files are checked and opened without the lock, so the opens of different files run in parallel.
+        const_cast<Options &>(options).filePath = realPath;
+        std::string::size_type pos = realPath.find_last_of('/');
+        std::string filePath = realPath.substr(0, pos);
+        if (Access(filePath.c_str()) != 0) {
+            LOG_ERROR("The path is invalid, prefName is %{public}s.", ExtractFileName(filePath).c_str());
+            if (!PreferencesHelper::isReportFault_.exchange(true)) {
+                ReportFaultParam param = { "GetPreferences error", options.bundleName, NORMAL_DB,
+                    ExtractFileName(options.filePath), E_INVALID_FILE_PATH, "The path is invalid." };
+                PreferencesDfxManager::ReportFault(param);
+            }
+        }
+        auto begin = std::chrono::steady_clock::now();
+        g_openCount++;
+        errCode = GetPreferencesInner(options, isEnhancePreferences, pref);
+        if (state.isReload) {
+            g_reloadCount++;
+            g_reloadTime += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - begin).count());
+        }
+    }
+    if (pref != nullptr) {
+        RecordOpen(options, realPath, isEnhancePreferences);
+        StartEvictIdlePreferences();
     }
-    prefsCache_.insert({realPath, {pref, isEnhancePreferences}});
     return pref;
 }
 
+void PreferencesHelper::WaitOpening(const std::string &realPath, std::unique_lock<std::mutex> &lock)
+{
+    auto it = openingPrefs_.find(realPath);
+    while (it != openingPrefs_.end()) {
+        auto future = it->second;
+        lock.unlock();
+        future.wait();
+        lock.lock();
+        it = openingPrefs_.find(realPath);
+    }
+}
+
 std::pair<std::string, int> PreferencesHelper::DeletePreferencesCache(const std::string &realPath)
 {
     std::string bundleName;
@@ -219,8 +420,10 @@ std::pair<std::string, int> PreferencesHelper::DeletePreferencesCache(const std:
         }
         if (errCode == E_OK) {
             prefsCache_.erase(it);
+            g_accessTicks.erase(realPath);
         }
     }
+    g_evictedPaths.erase(realPath);
 
     return { bundleName, errCode };
 }
@@ -235,7 +438,8 @@ int PreferencesHelper::DeletePreferences(const std::string &path)
 
     std::string bundleName;
     {
-        std::lock_guard<std::mutex> lock(prefsCacheMutex_);
+        std::unique_lock<std::mutex> lock(prefsCacheMutex_);
+        WaitOpening(realPath, lock);
         auto [ name, code ] = DeletePreferencesCache(realPath);
         if (code != E_OK) {
             LOG_ERROR("file %{public}s failed to close when delete preferences, errCode is: %{public}d",
@@ -259,11 +463,11 @@ int PreferencesHelper::DeletePreferences(const std::string &path)
             E_OPERAT_IS_CROSS_PROESS, "Cross-process operations." };
         PreferencesDfxManager::ReportFault(param);
     }
-    std::remove(filePath.c_str());
-    std::remove(backupPath.c_str());
-    std::remove(brokenPath.c_str());
-    std::remove(lockFilePath.c_str());
-    std::remove(objFlagPath.c_str());
+    Remove(filePath);
+    Remove(backupPath);
+    Remove(brokenPath);
+    Remove(lockFilePath);
+    Remove(objFlagPath);
     if (RemoveEnhanceDbFileIfNeed(path) != E_OK) {
         return E_DELETE_FILE_FAIL;
     }
@@ -282,7 +486,8 @@ int PreferencesHelper::RemovePreferencesFromCache(const std::string &path)
         return errCode;
     }
 
-    std::lock_guard<std::mutex> lock(prefsCacheMutex_);
+    std::unique_lock<std::mutex> lock(prefsCacheMutex_);
+    WaitOpening(realPath, lock);
     std::map<std::string, std::pair<std::shared_ptr<Preferences>, bool>>::iterator it = prefsCache_.find(realPath);
     if (it == prefsCache_.end()) {
         LOG_DEBUG("RemovePreferencesFromCache: preferences not in cache, just return");
@@ -304,9 +509,280 @@ int PreferencesHelper::RemovePreferencesFromCache(const std::string &path)
     }
 
     prefsCache_.erase(it);
+    g_accessTicks.erase(realPath);
     return E_OK;
 }
 
+int PreferencesHelper::FlushAll(std::chrono::milliseconds timeout, std::vector<std::string> &unflushedPaths)
+{
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    std::vector<std::pair<std::string, std::shared_ptr<Preferences>>> dirtyPrefs;
+    {
+        std::lock_guard<std::mutex> lock(prefsCacheMutex_);
+        for (auto &[path, prefPair] : prefsCache_) {
+            if (prefPair.first == nullptr) {
+                continue;
+            }
+            // the enhance preferences only have dirty data in write-behind mode.
+            bool isDirty = prefPair.second ?
+                std::static_pointer_cast<PreferencesEnhanceImpl>(prefPair.first)->HasDirtyData() :
+                std::static_pointer_cast<PreferencesImpl>(prefPair.first)->HasDirtyData();
+            if (isDirty) {
+                dirtyPrefs.emplace_back(path, prefPair.first);
+            }
+        }
+    }
+
+    std::vector<std::future<int>> results;
+    for (auto &[path, pref] : dirtyPrefs) {
+        auto promise = std::make_shared<std::promise<int>>();
+        results.push_back(promise->get_future());
+        ExecutorPool::Task task = [pref = pref, promise, deadline] {
+            if (std::chrono::steady_clock::now() >= deadline) {
+                promise->set_value(E_FLUSH_TIMEOUT);
+                return;
+            }
+            promise->set_value(pref->FlushSync());
+        };
+        if (g_flushPool.Execute(std::move(task)) == ExecutorPool::INVALID_TASK_ID) {
+            promise->set_value(E_ERROR);
+        }
+    }
+
+    int errCode = E_OK;
+    for (size_t i = 0; i < results.size(); i++) {
+        int ret = E_FLUSH_TIMEOUT;
+        if (results[i].wait_until(deadline) == std::future_status::ready) {
+            ret = results[i].get();
+        }
+        if (ret != E_OK) {
+            unflushedPaths.push_back(dirtyPrefs[i].first);
+            errCode = (errCode == E_OK || ret == E_FLUSH_TIMEOUT) ? ret : errCode;
+        }
+    }
+    if (!unflushedPaths.empty()) {
+        LOG_WARN("FlushAll: %{public}zu of %{public}zu preferences are not flushed, errCode is %{public}d.",
+            unflushedPaths.size(), dirtyPrefs.size(), errCode);
+    }
+    return errCode;
+}
+
+int PreferencesHelper::SetCacheMemoryBudget(int64_t budget)
+{
+    if (budget < 0) {
+        LOG_ERROR("invalid cache memory budget.");
+        return E_ERROR;
+    }
+    g_cacheMemoryBudget = budget;
+    StartEvictIdlePreferences();
+    return E_OK;
+}
+
+PreferencesHelper::CacheStats PreferencesHelper::GetCacheStats()
+{
+    CacheStats stats;
+    stats.memoryBytes = g_cacheMemoryBytes.load();
+    stats.evictCount = g_evictCount.load();
+    stats.reloadCount = g_reloadCount.load();
+    stats.reloadTime = g_reloadTime.load();
+    stats.openCount = g_openCount.load();
+    return stats;
+}
+
+void PreferencesHelper::StartEvictIdlePreferences()
+{
+    if (g_cacheMemoryBudget.load() <= 0 || g_isEvictPending.exchange(true)) {
+        return;
+    }
+    ExecutorPool::Task task = [] {
+        g_isEvictPending = false;
+        EvictIdlePreferences();
+    };
+    if (g_flushPool.Execute(std::move(task)) == ExecutorPool::INVALID_TASK_ID) {
+        g_isEvictPending = false;
+    }
+}
+
+void PreferencesHelper::EvictIdlePreferences()
+{
+    int64_t budget = g_cacheMemoryBudget.load();
+    if (budget <= 0) {
+        return;
+    }
+    // the victims leave the cache under the lock and are closed after it, the opens of other files do not wait.
+    std::vector<std::tuple<std::string, std::shared_ptr<Preferences>, bool>> victims;
+    std::promise<void> closed;
+    uint64_t generation = 0;
+    {
+        std::lock_guard<std::mutex> lock(prefsCacheMutex_);
+        int64_t totalBytes = 0;
+        // the access tick, the path and the bytes of the instances only referenced by the cache.
+        std::vector<std::tuple<uint64_t, std::string, int64_t>> idlePrefs;
+        for (auto &[path, prefPair] : prefsCache_) {
+            if (prefPair.first == nullptr) {
+                continue;
+            }
+            int64_t bytes = 0;
+            bool isDirty = false;
+            if (prefPair.second) {
+                auto pref = std::static_pointer_cast<PreferencesEnhanceImpl>(prefPair.first);
+                bytes = pref->GetMemoryBytes();
+                isDirty = pref->HasDirtyData();
+            } else {
+                auto pref = std::static_pointer_cast<PreferencesImpl>(prefPair.first);
+                bytes = pref->GetMemoryBytes();
+                isDirty = pref->HasDirtyData();
+            }
+            totalBytes += bytes;
+            // the count is read under prefsCacheMutex_, so no reference can be obtained from the cache meanwhile.
+            // The observers would not be registered on a reopened instance, so their instances stay.
+            if (prefPair.first.use_count() == 1 && !isDirty &&
+                !std::static_pointer_cast<PreferencesBase>(prefPair.first)->HasObservers()) {
+                idlePrefs.emplace_back(g_accessTicks[path], path, bytes);
+            }
+        }
+        std::sort(idlePrefs.begin(), idlePrefs.end());
+        auto closing = closed.get_future().share();
+        generation = ++g_evictGeneration;
+        for (auto &[tick, path, bytes] : idlePrefs) {
+            if (totalBytes <= budget) {
+                break;
+            }
+            auto it = prefsCache_.find(path);
+            victims.emplace_back(path, it->second.first, it->second.second);
+            prefsCache_.erase(it);
+            g_accessTicks.erase(path);
+            g_evictedPaths.insert(path);
+            g_closingPaths.insert_or_assign(path, std::make_pair(generation, closing));
+            totalBytes -= bytes;
+            g_evictCount++;
+        }
+        g_cacheMemoryBytes = totalBytes;
+    }
+    for (auto &[path, pref, isEnhance] : victims) {
+        int errCode = isEnhance ? pref->CloseDb() : std::static_pointer_cast<PreferencesImpl>(pref)->Close();
+        if (errCode != E_OK) {
+            LOG_WARN("close evicted %{public}s failed, errCode is %{public}d.", ExtractFileName(path).c_str(),
+                errCode);
+        }
+    }
+    if (victims.empty()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(prefsCacheMutex_);
+        for (auto &[path, pref, isEnhance] : victims) {
+            auto it = g_closingPaths.find(path);
+            if (it != g_closingPaths.end() && it->second.first == generation) {
+                g_closingPaths.erase(it);
+            }
+        }
+    }
+    closed.set_value();
+}
+
+int PreferencesHelper::Preload(const std::vector<Options> &options)
+{
+    int errCode = E_OK;
+    for (const auto &option : options) {
+        int ret = E_OK;
+        if (GetRealPath(option.filePath, ret).empty() || ret != E_OK) {
+            errCode = (errCode == E_OK) ? ret : errCode;
+            continue;
+        }
+        PreloadFile(option, {});
+    }
+    return errCode;
+}
+
+void PreferencesHelper::PreloadFile(const Options &options, std::vector<std::string> &&keys)
+{
+    int errCode = E_OK;
+    std::string realPath = GetRealPath(options.filePath, errCode);
+    if (realPath.empty() || errCode != E_OK) {
+        LOG_WARN("preload %{public}s failed, errCode is %{public}d.", ExtractFileName(options.filePath).c_str(),
+            errCode);
+        return;
+    }
+    // the open is registered before the task is queued, a GetPreferences call made after this one waits for it.
+    auto state = std::make_shared<OpenState>();
+    StartOpen(realPath, *state);
+    ExecutorPool::Task task = [options, realPath, state, keys = std::move(keys)] {
+        g_isPreloading = true;
+        int errCode = E_OK;
+        auto pref = FinishOpen(options, realPath, *state, errCode);
+        g_isPreloading = false;
+        if (pref == nullptr) {
+            LOG_WARN("preload %{public}s failed, errCode is %{public}d.", ExtractFileName(realPath).c_str(), errCode);
+            return;
+        }
+        if (options.isEnhance && !keys.empty()) {
+            std::static_pointer_cast<PreferencesEnhanceImpl>(pref)->Prefetch(keys);
+        }
+    };
+    // the registered open must run, on this thread if the pool does not take it.
+    if (g_preloadPool.Execute(ExecutorPool::Task(task)) == ExecutorPool::INVALID_TASK_ID) {
+        task();
+    }
+}
+
+int PreferencesHelper::StartPrefetchManifest(const std::string &manifestPath, std::chrono::milliseconds duration)
+{
+    int errCode = E_OK;
+    if (GetRealPath(manifestPath, errCode).empty() || errCode != E_OK) {
+        return errCode;
+    }
+    std::vector<PreferencesPrefetchManifest::Entry> entries;
+    if (PreferencesPrefetchManifest::Load(manifestPath, entries) != E_OK) {
+        LOG_INFO("no prefetch manifest to replay, %{public}s.", ExtractFileName(manifestPath).c_str());
+    }
+    uint64_t generation = 0;
+    {
+        std::lock_guard<std::mutex> lock(g_manifestMutex);
+        g_manifestPath = manifestPath;
+        generation = ++g_manifestGeneration;
+        g_recordedEntries.clear();
+        g_isManifestRecording = true;
+    }
+    PreferencesEnhanceImpl::SetKeyRecordingEnabled(true);
+    for (auto &entry : entries) {
+        PreloadFile(entry.options, std::move(entry.keys));
+    }
+    g_preloadPool.Schedule(duration, [generation] { SavePrefetchManifest(generation); });
+    return E_OK;
+}
+
+void PreferencesHelper::SavePrefetchManifest(uint64_t generation)
+{
+    std::string manifestPath;
+    std::vector<PreferencesPrefetchManifest::Entry> entries;
+    {
+        std::lock_guard<std::mutex> lock(g_manifestMutex);
+        if (generation != g_manifestGeneration) {
+            return;
+        }
+        g_isManifestRecording = false;
+        manifestPath = g_manifestPath;
+        entries = std::move(g_recordedEntries);
+        g_recordedEntries.clear();
+    }
+    PreferencesEnhanceImpl::SetKeyRecordingEnabled(false);
+    {
+        std::lock_guard<std::mutex> lock(prefsCacheMutex_);
+        for (auto &entry : entries) {
+            auto it = prefsCache_.find(entry.options.filePath);
+            if (entry.options.isEnhance && it != prefsCache_.end() && it->second.first != nullptr) {
+                entry.keys = std::static_pointer_cast<PreferencesEnhanceImpl>(it->second.first)->TakeRecordedKeys();
+            }
+        }
+    }
+    if (PreferencesPrefetchManifest::Save(manifestPath, entries) != E_OK) {
+        return;
+    }
+    LOG_INFO("the prefetch manifest %{public}s records %{public}zu files.", ExtractFileName(manifestPath).c_str(),
+        entries.size());
+}
+
 bool PreferencesHelper::IsStorageTypeSupported(const StorageType &type)
 {
     if (type == StorageType::XML) {
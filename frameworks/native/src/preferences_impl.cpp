@@ -20,11 +20,13 @@
 #include <cstdint>
 #include <cstdlib>
 #include <functional>
+#include <iterator>
 #include <thread>
 #include <chrono>
 #include <sstream>
+#include <type_traits>
+#include <variant>
 
-#include "executor_pool.h"
 #include "log_print.h"
 #include "preferences_xml_utils.h"
 #include "preferences_file_operation.h"
@@ -38,10 +40,61 @@ namespace NativePreferences {
 
 using namespace std::chrono;
 
-constexpr int32_t WAIT_TIME = 2;
 constexpr int32_t TASK_EXEC_TIME = 100;
 constexpr int32_t LOAD_XML_LOG_TIME = 1000;
 constexpr int32_t MAX_LOG_LENGTH = 3000;
+constexpr int64_t DIRTY_SOFT_LIMIT = 4 * 1024 * 1024;
+constexpr int64_t DIRTY_HARD_LIMIT = 16 * 1024 * 1024;
+constexpr int64_t GLOBAL_DIRTY_SOFT_LIMIT = 16 * 1024 * 1024;
+constexpr int64_t GLOBAL_DIRTY_HARD_LIMIT = 64 * 1024 * 1024;
+constexpr int32_t DIRTY_WAIT_TIME = 1000;
+
+static std::atomic<int64_t> g_dirtySoftLimit(DIRTY_SOFT_LIMIT);
+static std::atomic<int64_t> g_dirtyHardLimit(DIRTY_HARD_LIMIT);
+static std::atomic<int64_t> g_globalDirtySoftLimit(GLOBAL_DIRTY_SOFT_LIMIT);
+static std::atomic<int64_t> g_globalDirtyHardLimit(GLOBAL_DIRTY_HARD_LIMIT);
+static std::atomic<int32_t> g_dirtyWaitTime(DIRTY_WAIT_TIME);
+static std::atomic<int64_t> g_globalDirtyBytes(0);
+static std::atomic<uint64_t> g_earlyFlushCount(0);
+static std::atomic<uint64_t> g_throttledCount(0);
+static std::atomic<uint64_t> g_rejectedCount(0);
+static std::atomic<uint64_t> g_throttledTime(0);
+static std::mutex g_dirtyMutex;
+static std::condition_variable g_dirtyCond;
+static constexpr int64_t LOAD_WAIT_BUCKET_BOUNDS[] = { 100, 1000, 10000, 100000, 1000000 };
+static std::atomic<uint64_t> g_loadWaitCount(0);
+static std::atomic<uint64_t> g_loadStealCount(0);
+static std::atomic<uint64_t> g_loadWaitHistogram[std::size(LOAD_WAIT_BUCKET_BOUNDS) + 1];
+
+// An estimate of the memory held by a modified entry until it is flushed.
+static int64_t GetDirtySize(const std::string &key, const PreferencesValue &value)
+{
+    int64_t size = static_cast<int64_t>(key.size());
+    std::visit([&size](const auto &val) {
+        using T = std::decay_t<decltype(val)>;
+        if constexpr (std::is_same_v<T, std::string>) {
+            size += static_cast<int64_t>(val.size());
+        } else if constexpr (std::is_same_v<T, Object>) {
+            size += static_cast<int64_t>(val.valueStr.size());
+        } else if constexpr (std::is_same_v<T, BigInt>) {
+            size += static_cast<int64_t>(val.words_.size() * sizeof(uint64_t));
+        } else if constexpr (std::is_same_v<T, std::vector<std::string>>) {
+            for (const auto &str : val) {
+                size += static_cast<int64_t>(str.size());
+            }
+        } else if constexpr (std::is_same_v<T, std::vector<bool>>) {
+            size += static_cast<int64_t>(val.size());
+        } else if constexpr (std::is_same_v<T, std::monostate>) {
+            return;
+        } else if constexpr (std::is_arithmetic_v<T>) {
+            size += static_cast<int64_t>(sizeof(T));
+        } else {
+            size += static_cast<int64_t>(val.size() * sizeof(typename T::value_type));
+        }
+    }, value.value_);
+    return size;
+}
+
 PreferencesImpl::PreferencesImpl(const Options &options) : PreferencesBase(options)
 {
     loaded_.store(false);
@@ -51,10 +104,13 @@ PreferencesImpl::PreferencesImpl(const Options &options) : PreferencesBase(optio
     dataObsMgrClient_ = DataObsMgrClient::GetInstance();
     isActive_.store(true);
     isCleared_.store(false);
+    isEarlyFlushPending_.store(false);
+    dirtyBytes_.store(0);
 }
 
 PreferencesImpl::~PreferencesImpl()
 {
+    ResetDirtyBytes();
 }
 
 int PreferencesImpl::Init()
@@ -72,8 +128,12 @@ bool PreferencesImpl::StartLoadFromDisk()
     isNeverUnlock_ = false;
     loadResult_ = false;
 
-    auto task = [pref = shared_from_this()] {
-        PreferencesImpl::LoadFromDisk(pref);
+    // a read may run the load before the task, which then does not keep the preferences alive.
+    auto task = [weakPref = weak_from_this()] {
+        auto pref = weakPref.lock();
+        if (pref != nullptr) {
+            PreferencesImpl::LoadFromDisk(pref);
+        }
     };
     return PreferencesTaskProcessor::GetInstance()->Execute(task);
 }
@@ -85,25 +145,31 @@ void PreferencesImpl::LoadFromDisk(std::shared_ptr<PreferencesImpl> pref)
         return;
     }
     std::lock_guard<std::mutex> lock(pref->mutex_);
-    if (!pref->loaded_.load()) {
-        std::string::size_type pos = pref->options_.filePath.find_last_of('/');
-        std::string filePath = pref->options_.filePath.substr(0, pos);
-        if (Access(filePath) != 0) {
-            pref->isNeverUnlock_ = true;
-        }
-        std::unordered_map<std::string, PreferencesValue> values;
-        bool loadResult = pref->ReadSettingXml(values);
-        if (!loadResult) {
-            LOG_WARN("The settingXml %{public}s load failed.", ExtractFileName(pref->options_.filePath).c_str());
-        } else {
-            std::unique_lock<decltype(pref->cacheMutex_)> lock(pref->cacheMutex_);
-            pref->valuesCache_ = std::move(values);
-            pref->loadResult_ = true;
-            pref->isNeverUnlock_ = false;
-        }
-        pref->loaded_.store(true);
-        pref->cond_.notify_all();
+    pref->LoadFromDiskLocked();
+}
+
+void PreferencesImpl::LoadFromDiskLocked()
+{
+    if (loaded_.load()) {
+        return;
     }
+    std::string::size_type pos = options_.filePath.find_last_of('/');
+    std::string filePath = options_.filePath.substr(0, pos);
+    if (Access(filePath) != 0) {
+        isNeverUnlock_ = true;
+    }
+    std::unordered_map<std::string, PreferencesValue> values;
+    bool loadResult = ReadSettingXml(values);
+    if (!loadResult) {
+        LOG_WARN("The settingXml %{public}s load failed.", ExtractFileName(options_.filePath).c_str());
+    } else {
+        std::unique_lock<decltype(cacheMutex_)> lock(cacheMutex_);
+        valuesCache_ = std::move(values);
+        loadResult_ = true;
+        isNeverUnlock_ = false;
+    }
+    loaded_.store(true);
+    cond_.notify_all();
 }
 
 bool PreferencesImpl::ReloadFromDisk()
@@ -149,14 +215,23 @@ void PreferencesImpl::AwaitLoadFile()
         PreLoad();
         return;
     }
+    auto begin = steady_clock::now();
+    // the load holds mutex_ while it runs. If it has not run once the lock is taken, it is still queued behind
+    // other tasks, the reader runs it instead of waiting for them, the queued one finds it done.
     std::unique_lock<std::mutex> lock(mutex_);
     if (!loaded_.load()) {
-        cond_.wait_for(lock, std::chrono::seconds(WAIT_TIME), [this] { return loaded_.load(); });
+        LoadFromDiskLocked();
+        g_loadStealCount++;
     }
+    lock.unlock();
 
-    if (!loaded_.load()) {
-        LOG_ERROR("The settingXml %{public}s load timeout.", ExtractFileName(options_.filePath).c_str());
+    int64_t waitTime = duration_cast<microseconds>(steady_clock::now() - begin).count();
+    size_t bucket = 0;
+    while (bucket < std::size(LOAD_WAIT_BUCKET_BOUNDS) && waitTime >= LOAD_WAIT_BUCKET_BOUNDS[bucket]) {
+        bucket++;
     }
+    g_loadWaitHistogram[bucket]++;
+    g_loadWaitCount++;
 }
 
 PreferencesValue PreferencesImpl::Get(const std::string &key, const PreferencesValue &defValue)
@@ -196,7 +271,7 @@ static int64_t GetFileSize(const std::string &path)
 {
     int64_t fileSize = -1;
     struct stat buffer;
-    if (stat(path.c_str(), &buffer) == 0) {
+    if (Stat(path, buffer) == 0) {
         fileSize = static_cast<int64_t>(buffer.st_size);
     }
     return fileSize;
@@ -251,7 +326,8 @@ bool PreferencesImpl::HasKey(const std::string &key)
     return valuesCache_.find(key) != valuesCache_.end();
 }
 
-int PreferencesImpl::Put(const std::string &key, const PreferencesValue &value)
+template<typename K, typename V>
+int PreferencesImpl::PutInner(K &&key, V &&value)
 {
     int errCode = PreferencesUtils::CheckKey(key);
     if (errCode != E_OK) {
@@ -264,6 +340,11 @@ int PreferencesImpl::Put(const std::string &key, const PreferencesValue &value)
     AwaitLoadFile();
     IsClose(std::string(__FUNCTION__));
     ReportObjectUsage(shared_from_this(), value);
+    errCode = WaitForDirtyBudget();
+    if (errCode != E_OK) {
+        return errCode;
+    }
+    int64_t dirtySize = GetDirtySize(key, value);
 
     std::unique_lock<decltype(cacheMutex_)> lock(cacheMutex_);
     if (isCleared_.load()) { // has cleared.
@@ -271,9 +352,10 @@ int PreferencesImpl::Put(const std::string &key, const PreferencesValue &value)
             modifiedKeys_.emplace(it.first);
         }
         valuesCache_.clear();
-        valuesCache_.insert_or_assign(key, value);
         modifiedKeys_.emplace(key);
+        valuesCache_.insert_or_assign(std::forward<K>(key), std::forward<V>(value));
         isCleared_.store(false);
+        AddDirtyBytes(dirtySize);
     } else {
         auto iter = valuesCache_.find(key);
         if (iter != valuesCache_.end()) {
@@ -281,13 +363,33 @@ int PreferencesImpl::Put(const std::string &key, const PreferencesValue &value)
             if (val == value) {
                 return E_OK;
             }
+            // the key is already cached, only the value needs to be replaced. A dirty key is written once, so only
+            // the change of its size is charged.
+            if (modifiedKeys_.find(key) != modifiedKeys_.end()) {
+                dirtySize -= GetDirtySize(key, val);
+            }
+            val = std::forward<V>(value);
+            modifiedKeys_.emplace(std::forward<K>(key));
+            AddDirtyBytes(dirtySize);
+            return E_OK;
         }
-        valuesCache_.insert_or_assign(key, value);
         modifiedKeys_.emplace(key);
+        valuesCache_.insert_or_assign(std::forward<K>(key), std::forward<V>(value));
+        AddDirtyBytes(dirtySize);
     }
     return E_OK;
 }
 
+int PreferencesImpl::Put(const std::string &key, const PreferencesValue &value)
+{
+    return PutInner(key, value);
+}
+
+int PreferencesImpl::Put(std::string &&key, PreferencesValue &&value)
+{
+    return PutInner(std::move(key), std::move(value));
+}
+
 int PreferencesImpl::Delete(const std::string &key)
 {
     int errCode = PreferencesUtils::CheckKey(key);
@@ -303,6 +405,7 @@ int PreferencesImpl::Delete(const std::string &key)
     if (valuesCache_.find(key) != valuesCache_.end()) {
         valuesCache_.erase(key);
         modifiedKeys_.emplace(key);
+        AddDirtyBytes(static_cast<int64_t>(key.size()));
     }
     return E_OK;
 }
@@ -319,6 +422,7 @@ int PreferencesImpl::WriteToDiskFile(std::shared_ptr<PreferencesImpl> pref)
 {
     auto keysModified = std::make_shared<std::unordered_set<std::string>>();
     auto writeToDiskMap = std::make_shared<std::unordered_map<std::string, PreferencesValue>>();
+    int64_t writtenBytes = 0;
     {
         std::unique_lock<decltype(pref->cacheMutex_)> lock(pref->cacheMutex_);
         if (pref->isCleared_.load()) {
@@ -331,14 +435,20 @@ int PreferencesImpl::WriteToDiskFile(std::shared_ptr<PreferencesImpl> pref)
         if (!pref->modifiedKeys_.empty()) {
             *keysModified = std::move(pref->modifiedKeys_);
             *writeToDiskMap = pref->valuesCache_;
+            // the bytes stay counted until they are written, the writes after this point add their own.
+            writtenBytes = pref->dirtyBytes_.load();
         } else {
             // Cache has not changed, Not need to write persistent files.
             return E_OK;
         }
     }
     if (!PreferencesXmlUtils::WriteSettingXml(pref->options_.filePath, pref->options_.bundleName, *writeToDiskMap)) {
+        // the keys are dirty again, so that the next flush writes them.
+        std::unique_lock<decltype(pref->cacheMutex_)> lock(pref->cacheMutex_);
+        pref->modifiedKeys_.merge(*keysModified);
         return E_ERROR;
     }
+    pref->ReleaseDirtyBytes(writtenBytes);
     if (pref->isNeverUnlock_) {
         pref->isNeverUnlock_ = false;
     }
@@ -358,7 +468,7 @@ void PreferencesImpl::Flush()
         return;
     }
     std::weak_ptr<SafeBlockQueue<uint64_t>> queue = queue_;
-    ExecutorPool::Task task = [queue, self = weak_from_this()] {
+    Task task = [queue, self = weak_from_this()] {
         auto realQueue = queue.lock();
         auto realThis = self.lock();
         if (realQueue == nullptr || realThis == nullptr) {
@@ -374,30 +484,189 @@ void PreferencesImpl::Flush()
             PreferencesImpl::WriteToDiskFile(realThis);
         }
     };
-    executorPool_.Schedule(std::chrono::milliseconds(TASK_EXEC_TIME), std::move(task));
+    PreferencesTaskProcessor::GetInstance()->Schedule(TaskLane::FLUSH, std::chrono::milliseconds(TASK_EXEC_TIME),
+        std::move(task));
 }
 
-int PreferencesImpl::FlushSync()
+void PreferencesImpl::StartEarlyFlush()
 {
-    IsClose(std::string(__FUNCTION__));
-    auto success = queue_->PushNoWait(1);
-    if (success) {
-        if (queue_ == nullptr) {
-            return E_ERROR;
+    if (isEarlyFlushPending_.exchange(true)) {
+        return;
+    }
+    g_earlyFlushCount++;
+    Task task = [self = weak_from_this()] {
+        auto realThis = self.lock();
+        if (realThis == nullptr) {
+            return;
         }
-        if (!PreLoad()) {
-            return E_OK;
+        realThis->isEarlyFlushPending_.store(false);
+        if (!realThis->PreLoad()) {
+            return;
         }
+        std::lock_guard<std::mutex> lock(realThis->mutex_);
+        // the data of a pending delayed flush is written here as well.
         uint64_t value = 0;
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto has = queue_->PopNotWait(value);
-        if (has && value == 1) {
-            return PreferencesImpl::WriteToDiskFile(shared_from_this());
-        }
+        realThis->queue_->PopNotWait(value);
+        PreferencesImpl::WriteToDiskFile(realThis);
+    };
+    PreferencesTaskProcessor::GetInstance()->Execute(TaskLane::FLUSH, std::move(task));
+}
+
+void PreferencesImpl::AddDirtyBytes(int64_t size)
+{
+    int64_t dirtyBytes = dirtyBytes_.fetch_add(size) + size;
+    int64_t globalDirtyBytes = g_globalDirtyBytes.fetch_add(size) + size;
+    if (dirtyBytes >= g_dirtySoftLimit.load() || globalDirtyBytes >= g_globalDirtySoftLimit.load()) {
+        StartEarlyFlush();
+    }
+}
+
+void PreferencesImpl::ResetDirtyBytes()
+{
+    int64_t dirtyBytes = dirtyBytes_.exchange(0);
+    if (dirtyBytes == 0) {
+        return;
+    }
+    g_globalDirtyBytes.fetch_sub(dirtyBytes);
+    {
+        std::lock_guard<std::mutex> lock(g_dirtyMutex);
+    }
+    g_dirtyCond.notify_all();
+}
+
+void PreferencesImpl::ReleaseDirtyBytes(int64_t size)
+{
+    if (size == 0) {
+        return;
+    }
+    dirtyBytes_.fetch_sub(size);
+    g_globalDirtyBytes.fetch_sub(size);
+    {
+        std::lock_guard<std::mutex> lock(g_dirtyMutex);
+    }
+    g_dirtyCond.notify_all();
+}
+
+int PreferencesImpl::WaitForDirtyBudget()
+{
+    // while the process is over budget, only the writers holding dirty data wait for their own flush.
+    auto isOverLimit = [this] {
+        int64_t dirtyBytes = dirtyBytes_.load();
+        return dirtyBytes >= g_dirtyHardLimit.load() ||
+            (dirtyBytes > 0 && g_globalDirtyBytes.load() >= g_globalDirtyHardLimit.load());
+    };
+    if (!isOverLimit()) {
+        return E_OK;
+    }
+    StartEarlyFlush();
+    // a task of the flush lane would wait for the early flush queued behind it.
+    if (PreferencesTaskProcessor::GetCurrentLane() == TaskLane::FLUSH) {
+        g_rejectedCount++;
+        LOG_WARN("The settingXml %{public}s dirty bytes %{public}" PRId64 " exceed limit in a flush task.",
+            ExtractFileName(options_.filePath).c_str(), dirtyBytes_.load());
+        return E_DIRTY_BYTES_EXCEED_LIMIT;
+    }
+    g_throttledCount++;
+    auto begin = steady_clock::now();
+    bool isAdmitted = false;
+    {
+        std::unique_lock<std::mutex> lock(g_dirtyMutex);
+        isAdmitted = g_dirtyCond.wait_for(lock, milliseconds(g_dirtyWaitTime.load()),
+            [&isOverLimit] { return !isOverLimit(); });
+    }
+    g_throttledTime += static_cast<uint64_t>(duration_cast<microseconds>(steady_clock::now() - begin).count());
+    if (!isAdmitted) {
+        g_rejectedCount++;
+        LOG_WARN("The settingXml %{public}s dirty bytes %{public}" PRId64 " exceed limit, flush is too slow.",
+            ExtractFileName(options_.filePath).c_str(), dirtyBytes_.load());
+        return E_DIRTY_BYTES_EXCEED_LIMIT;
     }
     return E_OK;
 }
 
+int64_t PreferencesImpl::GetDirtyBytes()
+{
+    return dirtyBytes_.load();
+}
+
+bool PreferencesImpl::HasDirtyData()
+{
+    return dirtyBytes_.load() > 0 || isCleared_.load();
+}
+
+int64_t PreferencesImpl::GetMemoryBytes()
+{
+    if (!loaded_.load()) {
+        return 0;
+    }
+    std::shared_lock<decltype(cacheMutex_)> lock(cacheMutex_);
+    int64_t size = 0;
+    for (const auto &[key, value] : valuesCache_) {
+        size += GetDirtySize(key, value);
+    }
+    return size;
+}
+
+int PreferencesImpl::SetDirtyBytesBudget(const DirtyBytesBudget &budget)
+{
+    if (budget.softLimit <= 0 || budget.softLimit > budget.hardLimit || budget.globalSoftLimit <= 0 ||
+        budget.globalSoftLimit > budget.globalHardLimit || budget.waitTime < 0) {
+        LOG_ERROR("invalid dirty bytes budget.");
+        return E_ERROR;
+    }
+    g_dirtySoftLimit.store(budget.softLimit);
+    g_dirtyHardLimit.store(budget.hardLimit);
+    g_globalDirtySoftLimit.store(budget.globalSoftLimit);
+    g_globalDirtyHardLimit.store(budget.globalHardLimit);
+    g_dirtyWaitTime.store(budget.waitTime);
+    return E_OK;
+}
+
+PreferencesImpl::DirtyBytesBudget PreferencesImpl::GetDirtyBytesBudget()
+{
+    return { g_dirtySoftLimit.load(), g_globalDirtySoftLimit.load(), g_dirtyHardLimit.load(),
+        g_globalDirtyHardLimit.load(), g_dirtyWaitTime.load() };
+}
+
+PreferencesImpl::WriteThrottleStats PreferencesImpl::GetWriteThrottleStats()
+{
+    WriteThrottleStats stats;
+    stats.globalDirtyBytes = g_globalDirtyBytes.load();
+    stats.earlyFlushCount = g_earlyFlushCount.load();
+    stats.throttledCount = g_throttledCount.load();
+    stats.rejectedCount = g_rejectedCount.load();
+    stats.throttledTime = g_throttledTime.load();
+    return stats;
+}
+
+PreferencesImpl::LoadWaitStats PreferencesImpl::GetLoadWaitStats()
+{
+    LoadWaitStats stats;
+    stats.waitCount = g_loadWaitCount.load();
+    stats.stealCount = g_loadStealCount.load();
+    for (size_t i = 0; i < stats.waitTimeHistogram.size(); i++) {
+        stats.waitTimeHistogram[i] = g_loadWaitHistogram[i].load();
+    }
+    return stats;
+}
+
+int PreferencesImpl::FlushSync()
+{
+    IsClose(std::string(__FUNCTION__));
+    if (queue_ == nullptr) {
+        return E_ERROR;
+    }
+    if (!PreLoad()) {
+        return E_OK;
+    }
+    uint64_t value = 0;
+    std::lock_guard<std::mutex> lock(mutex_);
+    // the token of a pending delayed flush is taken as well, its data is written here. Nothing is written when the
+    // cache is not dirty.
+    queue_->PopNotWait(value);
+    return PreferencesImpl::WriteToDiskFile(shared_from_this());
+}
+
 std::pair<int, PreferencesValue> PreferencesImpl::GetValue(const std::string &key, const PreferencesValue &defValue)
 {
     int errCode = PreferencesUtils::CheckKey(key);
@@ -417,6 +686,49 @@ std::pair<int, PreferencesValue> PreferencesImpl::GetValue(const std::string &ke
     return std::make_pair(E_NO_DATA, defValue);
 }
 
+std::pair<int, PreferencesValue> PreferencesImpl::TryGet(const std::string &key, const PreferencesValue &defValue)
+{
+    int errCode = PreferencesUtils::CheckKey(key);
+    if (errCode != E_OK) {
+        return std::make_pair(errCode, defValue);
+    }
+    if (!loaded_.load()) {
+        return std::make_pair(E_NOT_LOADED, GetLoadingDefault(key, defValue));
+    }
+    return GetValue(key, defValue);
+}
+
+void PreferencesImpl::GetAsync(const std::string &key, const PreferencesValue &defValue,
+    std::function<void(std::pair<int, PreferencesValue>)> callback, PreferencesResumer resumer)
+{
+    Task task = [pref = shared_from_this(), key, defValue, callback = std::move(callback), resumer] {
+        auto result = pref->GetValue(key, defValue);
+        Resume(resumer, [callback, result] { callback(result); });
+    };
+    if (loaded_.load()) {
+        task();
+        return;
+    }
+    if (!PreferencesTaskProcessor::GetInstance()->Execute(task)) {
+        LOG_WARN("failed to queue the read of %{public}s, read it inline.",
+            ExtractFileName(options_.filePath).c_str());
+        task();
+    }
+}
+
+void PreferencesImpl::FlushAsync(std::function<void(int)> callback, PreferencesResumer resumer)
+{
+    Task task = [pref = shared_from_this(), callback = std::move(callback), resumer] {
+        int errCode = pref->FlushSync();
+        Resume(resumer, [callback, errCode] { callback(errCode); });
+    };
+    if (!PreferencesTaskProcessor::GetInstance()->Execute(TaskLane::FLUSH, task)) {
+        LOG_WARN("failed to queue the flush of %{public}s, flush it inline.",
+            ExtractFileName(options_.filePath).c_str());
+        task();
+    }
+}
+
 std::pair<int, std::map<std::string, PreferencesValue>> PreferencesImpl::GetAllData()
 {
     AwaitLoadFile();
@@ -486,7 +798,7 @@ void PreferencesImpl::NotifyPreferencesObserver(std::shared_ptr<PreferencesImpl>
 void PreferencesImpl::ExecuteNotifyChange(std::shared_ptr<PreferencesImpl> pref,
     std::shared_ptr<std::unordered_set<std::string>> keysModified)
 {
-    ExecutorPool::Task task = [pref, keysModified] {
+    Task task = [pref, keysModified] {
         if (pref == nullptr || pref->dataObsMgrClient_ == nullptr) {
             return;
         }
@@ -504,7 +816,7 @@ void PreferencesImpl::ExecuteNotifyChange(std::shared_ptr<PreferencesImpl> pref,
             LOG_INFO("notify %{public}s", ss.str().c_str());
         }
     };
-    executorPool_.Execute(std::move(task));
+    PreferencesTaskProcessor::GetInstance()->Execute(TaskLane::NOTIFY, std::move(task));
 }
 } // End of namespace NativePreferences
 } // End of namespace OHOS
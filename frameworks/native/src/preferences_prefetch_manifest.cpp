@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "preferences_prefetch_manifest.h"
+
+#include <cerrno>
+#include <sstream>
+
+#include "base64_helper.h"
+#include "log_print.h"
+#include "preferences_errno.h"
+#include "preferences_file_operation.h"
+
+namespace OHOS {
+namespace NativePreferences {
+// a line per file followed by a line per key, the strings are in base64 as they may hold any byte:
+// "file\t<isEnhance>\t<filePath>\t<bundleName>\t<dataGroupId>" and "key\t<key>".
+constexpr const char *MANIFEST_HEADER = "preferences prefetch manifest v1";
+constexpr const char *FILE_TAG = "file";
+constexpr const char *KEY_TAG = "key";
+constexpr const char *TMP_SUFFIX = ".tmp";
+constexpr char FIELD_SEPARATOR = '\t';
+constexpr size_t FILE_FIELD_NUM = 5;
+constexpr size_t KEY_FIELD_NUM = 2;
+
+static std::string EncodeField(const std::string &field)
+{
+    return Base64Helper::Encode(std::vector<uint8_t>(field.begin(), field.end()));
+}
+
+static bool DecodeField(const std::string &input, std::string &field)
+{
+    std::vector<uint8_t> output;
+    if (!Base64Helper::Decode(input, output)) {
+        return false;
+    }
+    field.assign(output.begin(), output.end());
+    return true;
+}
+
+static std::vector<std::string> SplitLine(const std::string &line)
+{
+    std::vector<std::string> fields;
+    size_t begin = 0;
+    while (true) {
+        size_t end = line.find(FIELD_SEPARATOR, begin);
+        fields.push_back(line.substr(begin, end == std::string::npos ? std::string::npos : end - begin));
+        if (end == std::string::npos) {
+            return fields;
+        }
+        begin = end + 1;
+    }
+}
+
+static bool ParseFileLine(const std::vector<std::string> &fields, PreferencesPrefetchManifest::Entry &entry)
+{
+    if (fields.size() != FILE_FIELD_NUM || (fields[1] != "0" && fields[1] != "1")) {
+        return false;
+    }
+    entry.options.isEnhance = (fields[1] == "1");
+    return DecodeField(fields[2], entry.options.filePath) && !entry.options.filePath.empty() &&
+        DecodeField(fields[3], entry.options.bundleName) && DecodeField(fields[4], entry.options.dataGroupId);
+}
+
+int PreferencesPrefetchManifest::Load(const std::string &path, std::vector<Entry> &entries)
+{
+    std::vector<uint8_t> content;
+    if (!ReadFileContent(path, content)) {
+        return E_ERROR;
+    }
+    std::istringstream stream(std::string(content.begin(), content.end()));
+    std::string line;
+    if (!std::getline(stream, line) || line != MANIFEST_HEADER) {
+        LOG_WARN("the prefetch manifest %{public}s is not valid.", ExtractFileName(path).c_str());
+        return E_ERROR;
+    }
+    // the keys of a file line that can not be parsed are skipped with it.
+    bool isEntryValid = false;
+    while (std::getline(stream, line)) {
+        std::vector<std::string> fields = SplitLine(line);
+        if (fields[0] == FILE_TAG) {
+            Entry entry;
+            isEntryValid = entries.size() < MAX_ENTRY_NUM && ParseFileLine(fields, entry);
+            if (isEntryValid) {
+                entries.push_back(std::move(entry));
+            }
+            continue;
+        }
+        std::string key;
+        if (isEntryValid && fields[0] == KEY_TAG && fields.size() == KEY_FIELD_NUM &&
+            entries.back().keys.size() < MAX_KEY_NUM && DecodeField(fields[1], key)) {
+            entries.back().keys.push_back(std::move(key));
+        }
+    }
+    return E_OK;
+}
+
+int PreferencesPrefetchManifest::Save(const std::string &path, const std::vector<Entry> &entries)
+{
+    std::string content = std::string(MANIFEST_HEADER) + "\n";
+    for (size_t i = 0; i < entries.size() && i < MAX_ENTRY_NUM; i++) {
+        const Options &options = entries[i].options;
+        content.append(FILE_TAG).append(1, FIELD_SEPARATOR).append(options.isEnhance ? "1" : "0")
+            .append(1, FIELD_SEPARATOR).append(EncodeField(options.filePath))
+            .append(1, FIELD_SEPARATOR).append(EncodeField(options.bundleName))
+            .append(1, FIELD_SEPARATOR).append(EncodeField(options.dataGroupId)).append("\n");
+        for (size_t j = 0; j < entries[i].keys.size() && j < MAX_KEY_NUM; j++) {
+            content.append(KEY_TAG).append(1, FIELD_SEPARATOR).append(EncodeField(entries[i].keys[j])).append("\n");
+        }
+    }
+
+    std::string tmpPath = path + TMP_SUFFIX;
+    int fd = Open(tmpPath);
+    if (fd == -1) {
+        LOG_ERROR("open the prefetch manifest %{public}s failed, errno is %{public}d.",
+            ExtractFileName(path).c_str(), errno);
+        return E_ERROR;
+    }
+    int ret = Write(fd, reinterpret_cast<const unsigned char *>(content.data()), content.size());
+    Close(fd);
+    if (ret != static_cast<int>(content.size()) || Rename(tmpPath, path) != 0) {
+        LOG_ERROR("write the prefetch manifest %{public}s failed, errno is %{public}d.",
+            ExtractFileName(path).c_str(), errno);
+        Remove(tmpPath);
+        return E_ERROR;
+    }
+    return E_OK;
+}
+} // namespace NativePreferences
+} // namespace OHOS
@@ -15,6 +15,7 @@
 #include "preferences_utils.h"
 
 #include <string>
+#include <variant>
 
 #include "log_print.h"
 #include "preferences_errno.h"
@@ -51,20 +52,18 @@ int PreferencesUtils::CheckValue(const PreferencesValue &value)
         return E_OK;
     };
 
-    if (value.IsString()) {
-        std::string val = value;
-        return lengthCheck(val.length(), "the value string length should shorter than 16 * 1024 * 1024.");
+    // inspect the alternatives in place, values can be large and must not be copied here.
+    if (auto val = std::get_if<std::string>(&value.value_)) {
+        return lengthCheck(val->length(), "the value string length should shorter than 16 * 1024 * 1024.");
     }
 
-    if (value.IsObject()) {
-        Object obj = value;
-        return lengthCheck(obj.valueStr.length(), "the length of the object converted to JSON should be less than 16 *"
-                                                  " 1024 * 1024");
+    if (auto obj = std::get_if<Object>(&value.value_)) {
+        return lengthCheck(obj->valueStr.length(), "the length of the object converted to JSON should be less than 16 *"
+                                                   " 1024 * 1024");
     }
 
-    if (value.IsBigInt()) {
-        BigInt bigint = value;
-        if (bigint.words_.empty()) {
+    if (auto bigint = std::get_if<BigInt>(&value.value_)) {
+        if (bigint->words_.empty()) {
             LOG_ERROR("BigInt words cannot be empty.");
             return E_ERROR;
         }
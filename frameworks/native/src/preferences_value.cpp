@@ -15,6 +15,8 @@
 
 #include "preferences_value.h"
 
+#include <utility>
+
 namespace OHOS {
 namespace NativePreferences {
 PreferencesValue::PreferencesValue(const PreferencesValue &preferencesValue)
@@ -69,47 +71,47 @@ PreferencesValue::PreferencesValue(const char *value)
 
 PreferencesValue::PreferencesValue(std::string value)
 {
-    value_ = value;
+    value_ = std::move(value);
 }
 
 PreferencesValue::PreferencesValue(std::vector<double> value)
 {
-    value_ = value;
+    value_ = std::move(value);
 }
 
 PreferencesValue::PreferencesValue(std::vector<std::string> value)
 {
-    value_ = value;
+    value_ = std::move(value);
 }
 
 PreferencesValue::PreferencesValue(std::vector<bool> value)
 {
-    value_ = value;
+    value_ = std::move(value);
 }
 
 PreferencesValue::PreferencesValue(std::vector<uint8_t> value)
 {
-    value_ = value;
+    value_ = std::move(value);
 }
 
 PreferencesValue::PreferencesValue(Object value)
 {
-    value_ = value;
+    value_ = std::move(value);
 }
 
 PreferencesValue::PreferencesValue(BigInt value)
 {
-    value_ = value;
+    value_ = std::move(value);
 }
 
 PreferencesValue::PreferencesValue(std::vector<int> value)
 {
-    value_ = value;
+    value_ = std::move(value);
 }
 
 PreferencesValue::PreferencesValue(std::vector<int64_t> value)
 {
-    value_ = value;
+    value_ = std::move(value);
 }
 
 PreferencesValue &PreferencesValue::operator=(PreferencesValue &&preferencesValue) noexcept
@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "preferences_value_cache.h"
+
+#include <climits>
+#include <iterator>
+
+namespace OHOS {
+namespace NativePreferences {
+// the bookkeeping of an entry: the list node, the hash node and the members besides the value.
+constexpr size_t ENTRY_OVERHEAD = 128;
+constexpr size_t PROTECTED_PERCENT = 80;
+constexpr size_t PERCENT_BASE = 100;
+
+PreferencesValueCache::PreferencesValueCache(size_t capacity) : capacity_(capacity)
+{
+}
+
+bool PreferencesValueCache::Get(const std::string &key, int64_t version, PreferencesValue &value, bool &isExist)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = Find(key, version);
+    if (it == probation_.end()) {
+        return false;
+    }
+    isExist = it->isExist;
+    if (isExist) {
+        value = it->value;
+    }
+    return true;
+}
+
+bool PreferencesValueCache::Contains(const std::string &key, int64_t version, bool &isExist)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = Find(key, version);
+    if (it == probation_.end()) {
+        return false;
+    }
+    isExist = it->isExist;
+    return true;
+}
+
+PreferencesValueCache::EntryList::iterator PreferencesValueCache::Find(const std::string &key, int64_t version)
+{
+    if (version != version_) {
+        missCount_++;
+        return probation_.end();
+    }
+    auto pos = entries_.find(key);
+    if (pos == entries_.end()) {
+        missCount_++;
+        return probation_.end();
+    }
+    hitCount_++;
+    auto it = pos->second;
+    if (it->isOversize) {
+        return it;
+    }
+    if (it->isProtected) {
+        protected_.splice(protected_.begin(), protected_, it);
+    } else {
+        it->isProtected = true;
+        protectedBytes_ += it->size;
+        protected_.splice(protected_.begin(), probation_, it);
+        size_t protectedLimit = capacity_ / PERCENT_BASE * PROTECTED_PERCENT;
+        while (protectedBytes_ > protectedLimit && protected_.size() > 1) {
+            auto demoted = std::prev(protected_.end());
+            demoted->isProtected = false;
+            protectedBytes_ -= demoted->size;
+            probation_.splice(probation_.begin(), protected_, demoted);
+        }
+    }
+    return it;
+}
+
+void PreferencesValueCache::Put(const std::string &key, const PreferencesValue &value, size_t size,
+    int64_t version)
+{
+    Entry entry;
+    entry.key = key;
+    entry.value = value;
+    entry.isExist = true;
+    entry.size = key.size() + size + ENTRY_OVERHEAD;
+    Insert(std::move(entry), version);
+}
+
+void PreferencesValueCache::PutAbsent(const std::string &key, int64_t version)
+{
+    Entry entry;
+    entry.key = key;
+    entry.size = key.size() + ENTRY_OVERHEAD;
+    Insert(std::move(entry), version);
+}
+
+void PreferencesValueCache::Insert(Entry &&entry, int64_t version)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (version != version_) {
+        ClearEntries();
+        version_ = version;
+    }
+    auto pos = entries_.find(entry.key);
+    if (pos != entries_.end()) {
+        Remove(pos->second);
+    }
+    if (capacity_ == 0) {
+        return;
+    }
+    if (entry.size > capacity_) {
+        if (!oversize_.empty()) {
+            Remove(oversize_.begin());
+            evictCount_++;
+        }
+        entry.isOversize = true;
+        oversize_.push_front(std::move(entry));
+        entries_.insert_or_assign(oversize_.front().key, oversize_.begin());
+        return;
+    }
+    usedBytes_ += entry.size;
+    probation_.push_front(std::move(entry));
+    entries_.insert_or_assign(probation_.front().key, probation_.begin());
+    Evict();
+}
+
+void PreferencesValueCache::Remove(EntryList::iterator it)
+{
+    entries_.erase(it->key);
+    if (it->isOversize) {
+        oversize_.erase(it);
+        return;
+    }
+    usedBytes_ -= it->size;
+    if (it->isProtected) {
+        protectedBytes_ -= it->size;
+        protected_.erase(it);
+    } else {
+        probation_.erase(it);
+    }
+}
+
+void PreferencesValueCache::Evict()
+{
+    while (usedBytes_ > capacity_) {
+        if (!probation_.empty()) {
+            Remove(std::prev(probation_.end()));
+        } else if (!protected_.empty()) {
+            Remove(std::prev(protected_.end()));
+        } else {
+            break;
+        }
+        evictCount_++;
+    }
+}
+
+void PreferencesValueCache::AdvanceVersion(int64_t version)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    int64_t nextVersion = version_ == INT64_MAX ? 0 : version_ + 1;
+    if (version != nextVersion) {
+        ClearEntries();
+    }
+    version_ = version;
+}
+
+void PreferencesValueCache::Clear()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    ClearEntries();
+}
+
+void PreferencesValueCache::ClearEntries()
+{
+    probation_.clear();
+    protected_.clear();
+    oversize_.clear();
+    entries_.clear();
+    usedBytes_ = 0;
+    protectedBytes_ = 0;
+}
+
+void PreferencesValueCache::SetCapacity(size_t capacity)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    capacity_ = capacity;
+    if (!oversize_.empty() && (capacity_ == 0 || oversize_.front().size <= capacity_)) {
+        Remove(oversize_.begin());
+    }
+    Evict();
+}
+
+PreferencesValueCache::Stats PreferencesValueCache::GetStats()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats stats;
+    stats.hitCount = hitCount_;
+    stats.missCount = missCount_;
+    stats.evictCount = evictCount_;
+    stats.usedBytes = usedBytes_ + (oversize_.empty() ? 0 : oversize_.front().size);
+    stats.entryCount = entries_.size();
+    return stats;
+}
+} // namespace NativePreferences
+} // namespace OHOS
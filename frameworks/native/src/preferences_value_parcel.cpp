@@ -15,13 +15,197 @@
 
 #include "preferences_value_parcel.h"
 
+#include <cstring>
+
 #include "log_print.h"
+#include "preferences.h"
 #include "preferences_errno.h"
 #include "securec.h"
 
 namespace OHOS {
 namespace NativePreferences {
 
+namespace {
+// the types take the low bits of the type byte, the flag tells a string is compressed.
+constexpr uint8_t COMPRESSED_FLAG = 0x80;
+constexpr size_t MIN_COMPRESS_SIZE = 4096;
+constexpr size_t MIN_MATCH = 4;
+constexpr uint32_t HASH_BITS = 13;
+constexpr uint32_t HASH_MULTIPLIER = 2654435761U;
+constexpr size_t BITS_PER_BYTE = 8;
+constexpr size_t MAX_VARINT_SIZE = 10;
+constexpr uint8_t VARINT_MASK = 0x7F;
+constexpr uint8_t VARINT_MORE = 0x80;
+constexpr uint32_t VARINT_SHIFT = 7;
+
+uint32_t VarintSize(uint64_t value)
+{
+    uint32_t size = 1;
+    while (value > VARINT_MASK) {
+        value >>= VARINT_SHIFT;
+        size++;
+    }
+    return size;
+}
+
+uint64_t ZigZag(int64_t value)
+{
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+int64_t UnZigZag(uint64_t value)
+{
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+} // namespace
+
+class PreferencesValueParcel::Writer {
+public:
+    Writer(uint8_t *data, size_t len) : begin_(data), pos_(data), end_(data + len)
+    {
+    }
+
+    bool WriteByte(uint8_t byte)
+    {
+        if (pos_ == end_) {
+            return false;
+        }
+        *pos_++ = byte;
+        return true;
+    }
+
+    bool WriteVarint(uint64_t value)
+    {
+        while (value > VARINT_MASK) {
+            if (!WriteByte(static_cast<uint8_t>(value & VARINT_MASK) | VARINT_MORE)) {
+                return false;
+            }
+            value >>= VARINT_SHIFT;
+        }
+        return WriteByte(static_cast<uint8_t>(value));
+    }
+
+    bool WriteBytes(const void *src, size_t len)
+    {
+        if (len == 0) {
+            return true;
+        }
+        if (len > static_cast<size_t>(end_ - pos_) || memcpy_s(pos_, end_ - pos_, src, len) != E_OK) {
+            return false;
+        }
+        pos_ += len;
+        return true;
+    }
+
+    // the zigzag varints of the ints.
+    template<typename T>
+    bool WritePacked(const std::vector<T> &vec)
+    {
+        if (!WriteVarint(vec.size())) {
+            return false;
+        }
+        for (T item : vec) {
+            if (!WriteVarint(ZigZag(item))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    size_t GetSize() const
+    {
+        return pos_ - begin_;
+    }
+
+    void Rewind(size_t size)
+    {
+        pos_ = begin_ + size;
+    }
+
+private:
+    uint8_t *begin_;
+    uint8_t *pos_;
+    uint8_t *end_;
+};
+
+class PreferencesValueParcel::Reader {
+public:
+    Reader(const uint8_t *data, size_t len) : pos_(data), end_(data + len)
+    {
+    }
+
+    bool ReadByte(uint8_t &byte)
+    {
+        if (pos_ == end_) {
+            return false;
+        }
+        byte = *pos_++;
+        return true;
+    }
+
+    bool ReadVarint(uint64_t &value)
+    {
+        value = 0;
+        for (size_t i = 0; i < MAX_VARINT_SIZE; i++) {
+            uint8_t byte = 0;
+            if (!ReadByte(byte)) {
+                return false;
+            }
+            value |= static_cast<uint64_t>(byte & VARINT_MASK) << (i * VARINT_SHIFT);
+            if ((byte & VARINT_MORE) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool ReadBytes(void *dst, size_t len)
+    {
+        if (len == 0) {
+            return true;
+        }
+        if (len > GetRemain() || memcpy_s(dst, len, pos_, len) != E_OK) {
+            return false;
+        }
+        pos_ += len;
+        return true;
+    }
+
+    // the bytes stay in the buffer of the reader.
+    bool ReadView(const uint8_t *&data, size_t len)
+    {
+        if (len > GetRemain()) {
+            return false;
+        }
+        data = pos_;
+        pos_ += len;
+        return true;
+    }
+
+    template<typename T>
+    bool ReadPacked(size_t num, std::vector<T> &vec)
+    {
+        vec.resize(num);
+        for (size_t i = 0; i < num; i++) {
+            uint64_t item = 0;
+            if (!ReadVarint(item)) {
+                return false;
+            }
+            vec[i] = static_cast<T>(UnZigZag(item));
+        }
+        return true;
+    }
+
+    size_t GetRemain() const
+    {
+        return end_ - pos_;
+    }
+
+private:
+    const uint8_t *pos_;
+    const uint8_t *end_;
+};
+
 uint8_t PreferencesValueParcel::GetTypeIndex(const PreferencesValue &value)
 {
     if (value.IsInt()) {
@@ -48,410 +232,464 @@ uint8_t PreferencesValueParcel::GetTypeIndex(const PreferencesValue &value)
         return OBJECT_TYPE;
     } else if (value.IsBigInt()) {
         return BIG_INT_TYPE;
+    } else if (value.IsIntArray()) {
+        return INT_ARRAY_TYPE;
+    } else if (value.IsInt64Array()) {
+        return INT64_ARRAY_TYPE;
     } else {
         return MONO_TYPE;
     }
 }
 
-uint32_t PreferencesValueParcel::CalSize(PreferencesValue value)
+template<typename T>
+static uint32_t CalPackedSize(const std::vector<T> &vec)
 {
+    uint32_t size = VarintSize(vec.size());
+    for (T item : vec) {
+        size += VarintSize(ZigZag(item));
+    }
+    return size;
+}
+
+static uint32_t CalStringSize(const std::string &str)
+{
+    return VarintSize(str.size()) + str.size();
+}
+
+uint32_t PreferencesValueParcel::CalSize(const PreferencesValue &value)
+{
+    // the version and the type, then the data, the sizes are measured on the value without copying it.
+    constexpr uint32_t headerSize = sizeof(uint8_t) + sizeof(uint8_t);
     uint8_t type = GetTypeIndex(value);
     switch (type) {
         case INT_TYPE:
-            return sizeof(uint8_t) + sizeof(int);
+            return headerSize + VarintSize(ZigZag(std::get<int>(value.value_)));
         case LONG_TYPE:
-            return sizeof(uint8_t) + sizeof(int64_t);
+            return headerSize + VarintSize(ZigZag(std::get<int64_t>(value.value_)));
         case FLOAT_TYPE:
-            return sizeof(uint8_t) + sizeof(float);
+            return headerSize + sizeof(float);
         case DOUBLE_TYPE:
-            return sizeof(uint8_t) + sizeof(double);
+            return headerSize + sizeof(double);
         case BOOL_TYPE:
-            return sizeof(uint8_t) + sizeof(bool);
+            return headerSize + sizeof(uint8_t);
+        case STRING_TYPE:
+            return headerSize + CalStringSize(std::get<std::string>(value.value_));
         case OBJECT_TYPE:
-        case STRING_TYPE: {
-            uint32_t strLen = sizeof(uint8_t) + sizeof(size_t);
-            strLen += (type == STRING_TYPE) ? std::get<std::string>(value.value_).size() :
-                std::get<Object>(value.value_).valueStr.size();
-            return  strLen;
-        }
-        case BOOL_ARRAY_TYPE:
-            return sizeof(uint8_t) + sizeof(size_t) + std::get<std::vector<bool>>(value.value_).size() * sizeof(bool);
-        case DOUBLE_ARRAY_TYPE:
-            return sizeof(uint8_t) + sizeof(size_t) +
-                std::get<std::vector<double>>(value.value_).size() * sizeof(double);
-        case UINT8_ARRAY_TYPE:
-            return sizeof(uint8_t) + sizeof(size_t) +
-                ((std::get<std::vector<uint8_t>>(value.value_).size()) * sizeof(uint8_t));
+            return headerSize + CalStringSize(std::get<Object>(value.value_).valueStr);
         case STRING_ARRAY_TYPE: {
-            uint32_t strArrBlobLen = sizeof(uint8_t) + sizeof(size_t);
-            std::vector<std::string> strVec = std::get<std::vector<std::string>>(value.value_);
-
-            for (size_t i = 0; i < strVec.size(); i++) {
-                strArrBlobLen += sizeof(size_t);
-                strArrBlobLen += strVec[i].size();
+            const auto &vec = std::get<std::vector<std::string>>(value.value_);
+            uint32_t size = headerSize + VarintSize(vec.size());
+            for (const auto &str : vec) {
+                size += CalStringSize(str);
             }
-            return strArrBlobLen;
+            return size;
         }
-        case BIG_INT_TYPE:
-            return sizeof(uint8_t) + sizeof(size_t) + sizeof(int64_t) +
-                std::get<BigInt>(value.value_).words_.size() * sizeof(uint64_t);
+        case BOOL_ARRAY_TYPE: {
+            size_t num = std::get<std::vector<bool>>(value.value_).size();
+            return headerSize + VarintSize(num) + (num + BITS_PER_BYTE - 1) / BITS_PER_BYTE;
+        }
+        case DOUBLE_ARRAY_TYPE: {
+            size_t num = std::get<std::vector<double>>(value.value_).size();
+            return headerSize + VarintSize(num) + num * sizeof(double);
+        }
+        case UINT8_ARRAY_TYPE: {
+            size_t num = std::get<std::vector<uint8_t>>(value.value_).size();
+            return headerSize + VarintSize(num) + num;
+        }
+        case BIG_INT_TYPE: {
+            const BigInt &bigInt = std::get<BigInt>(value.value_);
+            return headerSize + VarintSize(ZigZag(bigInt.sign_)) + VarintSize(bigInt.words_.size()) +
+                bigInt.words_.size() * sizeof(uint64_t);
+        }
+        case INT_ARRAY_TYPE:
+            return headerSize + CalPackedSize(std::get<std::vector<int>>(value.value_));
+        case INT64_ARRAY_TYPE:
+            return headerSize + CalPackedSize(std::get<std::vector<int64_t>>(value.value_));
         default:
             break;
     }
     return 0;
 }
 
-int PreferencesValueParcel::MarshallingBasicValueInner(const PreferencesValue &value, const uint8_t type,
-    std::vector<uint8_t> &data)
+bool PreferencesValueParcel::CompressString(const std::string &str, Writer &writer)
 {
-    uint8_t *startAddr = data.data();
-    size_t basicDataLen = 0;
-    if (data.size() <= sizeof(uint8_t)) {
-        LOG_ERROR("memcpy error when marshalling basic value, type: %{public}d", type);
-        return E_ERROR;
-    }
-    size_t memLen = data.size() - sizeof(uint8_t);
-    int errCode = E_OK;
-    switch (type) {
-        case INT_TYPE: {
-            int intValue = std::get<int>(value.value_);
-            basicDataLen = sizeof(int);
-            errCode = memcpy_s(startAddr + sizeof(uint8_t), memLen, &intValue, basicDataLen);
-            break;
-        }
-        case LONG_TYPE: {
-            int64_t longValue = std::get<int64_t>(value.value_);
-            basicDataLen = sizeof(int64_t);
-            errCode = memcpy_s(startAddr + sizeof(uint8_t), memLen, &longValue, basicDataLen);
-            break;
-        }
-        case FLOAT_TYPE: {
-            float floatValue = std::get<float>(value.value_);
-            basicDataLen = sizeof(float);
-            errCode = memcpy_s(startAddr + sizeof(uint8_t), memLen, &floatValue, basicDataLen);
-            break;
+    const uint8_t *src = reinterpret_cast<const uint8_t *>(str.data());
+    size_t len = str.size();
+    // the positions plus one of the last sequences of MIN_MATCH bytes with the hash, 0 for none.
+    std::vector<uint32_t> table(1 << HASH_BITS, 0);
+    size_t anchor = 0;
+    size_t pos = 0;
+    while (pos + MIN_MATCH <= len) {
+        uint32_t sequence = 0;
+        (void)memcpy_s(&sequence, sizeof(sequence), src + pos, MIN_MATCH);
+        uint32_t hash = (sequence * HASH_MULTIPLIER) >> (sizeof(uint32_t) * BITS_PER_BYTE - HASH_BITS);
+        size_t candidate = table[hash];
+        table[hash] = static_cast<uint32_t>(pos + 1);
+        if (candidate == 0 || memcmp(src + candidate - 1, src + pos, MIN_MATCH) != 0) {
+            pos++;
+            continue;
         }
-        case DOUBLE_TYPE: {
-            double doubleValue = std::get<double>(value.value_);
-            basicDataLen = sizeof(double);
-            errCode = memcpy_s(startAddr + sizeof(uint8_t), memLen, &doubleValue, basicDataLen);
-            break;
+        candidate--;
+        size_t matchLen = MIN_MATCH;
+        while (pos + matchLen < len && src[candidate + matchLen] == src[pos + matchLen]) {
+            matchLen++;
         }
-        case BOOL_TYPE: {
-            bool boolValue = std::get<bool>(value.value_);
-            basicDataLen = sizeof(bool);
-            errCode = memcpy_s(startAddr + sizeof(uint8_t), memLen, &boolValue, basicDataLen);
-            break;
+        if (!writer.WriteVarint(pos - anchor) || !writer.WriteBytes(src + anchor, pos - anchor) ||
+            !writer.WriteVarint(matchLen - MIN_MATCH) || !writer.WriteVarint(pos - candidate)) {
+            return false;
         }
-        default:
-            break;
-    }
-    
-    if (errCode != E_OK) {
-        LOG_ERROR("memcpy failed when marshalling basic value, %{public}d", errCode);
-        return E_ERROR;
+        pos += matchLen;
+        anchor = pos;
     }
-    return E_OK;
+    return writer.WriteVarint(len - anchor) && writer.WriteBytes(src + anchor, len - anchor);
 }
 
-/**
- *     ------------------------
- *     |  type  |   BasicData   |
- *     ------------------------
- * len:  uint8_t   sizeof(int) or size of(Bool) e.g.
-*/
-int PreferencesValueParcel::MarshallingBasicValue(const PreferencesValue &value, const uint8_t type,
-    std::vector<uint8_t> &data)
+bool PreferencesValueParcel::DecompressString(Reader &reader, size_t len, std::string &str)
 {
-    uint8_t *startAddr = data.data();
-    int errCode = memcpy_s(startAddr, data.size(), &type, sizeof(uint8_t));
-    if (errCode != E_OK) {
-        LOG_ERROR("memcpy failed when marshalling basic value's type, %{public}d", errCode);
-        return E_NOT_SUPPORTED;
+    str.resize(len);
+    size_t out = 0;
+    while (true) {
+        uint64_t literalLen = 0;
+        if (!reader.ReadVarint(literalLen) || literalLen > len - out || !reader.ReadBytes(&str[out], literalLen)) {
+            return false;
+        }
+        out += literalLen;
+        if (out == len) {
+            return true;
+        }
+        uint64_t matchLen = 0;
+        uint64_t offset = 0;
+        if (!reader.ReadVarint(matchLen) || !reader.ReadVarint(offset)) {
+            return false;
+        }
+        matchLen += MIN_MATCH;
+        if (offset == 0 || offset > out || matchLen > len - out) {
+            return false;
+        }
+        // the match may overlap the bytes it produces, so it is copied byte by byte.
+        for (size_t i = 0; i < matchLen; i++) {
+            str[out + i] = str[out - offset + i];
+        }
+        out += matchLen;
     }
-    return MarshallingBasicValueInner(value, type, data);
 }
 
 /**
- *     -------------------------------------
- *     |  type  |   strLen   |   strData   |
- *     -------------------------------------
- * len:  uint8_t   size_t        strLen
+ *     ------------------------------------------------------
+ *     |  type | flag  |  strLen  |  strData  |
+ *     ------------------------------------------------------
+ * len:     uint8_t       varint     strLen
+ * A large string is compressed if that makes it smaller, then strData is the compressed string.
 */
-int PreferencesValueParcel::MarshallingStringValue(const PreferencesValue &value, const uint8_t type,
-    std::vector<uint8_t> &data)
+bool PreferencesValueParcel::WriteString(const std::string &str, uint8_t type, Writer &writer)
 {
-    std::string stringValue;
-    if (type == OBJECT_TYPE) {
-        Object objValue = std::get<Object>(value.value_);
-        stringValue = objValue.valueStr;
-    } else {
-        // it's string type
-        stringValue = std::get<std::string>(value.value_);
-    }
-    uint8_t *startAddr = data.data();
-    int errCode = memcpy_s(startAddr, sizeof(uint8_t), &type, sizeof(uint8_t));
-    if (errCode != E_OK) {
-        LOG_ERROR("memcpy failed when marshalling string value's type, %{public}d", errCode);
-        return -E_ERROR;
-    }
-    size_t strLen = stringValue.size();
-    errCode = memcpy_s(startAddr + sizeof(uint8_t), sizeof(size_t), &strLen, sizeof(size_t));
-    if (errCode != E_OK) {
-        LOG_ERROR("memcpy failed when marshalling string value's str len, %{public}d", errCode);
-        return -E_ERROR;
-    }
-    if (strLen == 0) {
-        return E_OK;
-    }
-    errCode = memcpy_s(startAddr + sizeof(uint8_t) + sizeof(size_t), strLen,
-        stringValue.c_str(), strLen);
-    if (errCode != E_OK) {
-        LOG_ERROR("memcpy failed when marshalling string value's str data, %{public}d", errCode);
-        return -E_ERROR;
+    if (str.size() >= MIN_COMPRESS_SIZE) {
+        size_t mark = writer.GetSize();
+        if (writer.WriteByte(type | COMPRESSED_FLAG) && writer.WriteVarint(str.size()) &&
+            CompressString(str, writer)) {
+            return true;
+        }
+        writer.Rewind(mark);
     }
-    return E_OK;
+    return writer.WriteByte(type) && writer.WriteVarint(str.size()) && writer.WriteBytes(str.data(), str.size());
 }
 
 /**
- *     --------------------------------------------------------------------
- *     |  type  |   vec_num   |  len1  |  str1  |  len2  |  str2  |  ...  |
- *     --------------------------------------------------------------------
- * len:  uint8_t   size_t        sizet     len1    size_t   len2
+ *     -----------------------------------------------
+ *     |  type  |  vec_num  |  data1  |  data2  | ... |
+ *     -----------------------------------------------
+ * len:  uint8_t   varint
+ * The bools take a bit each, the ints and int64s are zigzag varints, the others are as in memory.
 */
-int PreferencesValueParcel::MarshallingStringArrayValue(const PreferencesValue &value, const uint8_t type,
-    std::vector<uint8_t> &data)
+bool PreferencesValueParcel::WriteArray(const PreferencesValue &value, uint8_t type, Writer &writer)
 {
-    std::vector<std::string> strVec = std::get<std::vector<std::string>>(value.value_);
-    uint8_t *startAddr = data.data();
-    // write type into data
-    int errCode = memcpy_s(startAddr, sizeof(uint8_t), &type, sizeof(uint8_t));
-    if (errCode != E_OK) {
-        LOG_ERROR("memcpy failed when marshalling string array value's type, %{public}d", errCode);
-        return -E_ERROR;
-    }
-    startAddr += sizeof(uint8_t);
-
-    // write vector size into data
-    size_t vecNum = strVec.size();
-    errCode = memcpy_s(startAddr, sizeof(size_t), &vecNum, sizeof(size_t));
-    if (errCode != E_OK) {
-        LOG_ERROR("memcpy failed when marshalling string array value's vector num, %{public}d", errCode);
-        return -E_ERROR;
+    if (!writer.WriteByte(type)) {
+        return false;
     }
-    startAddr += sizeof(size_t);
-
-    // write every single str into data
-    for (size_t i = 0; i < vecNum; i++) {
-        size_t strLen = strVec[i].size();
-        errCode = memcpy_s(startAddr, sizeof(size_t), &strLen, sizeof(size_t));
-        if (errCode != E_OK) {
-            LOG_ERROR("memcpy failed when marshalling string array value's str len, %{public}d", errCode);
-            return -E_ERROR;
+    switch (type) {
+        case STRING_ARRAY_TYPE: {
+            const auto &vec = std::get<std::vector<std::string>>(value.value_);
+            if (!writer.WriteVarint(vec.size())) {
+                return false;
+            }
+            for (const auto &str : vec) {
+                if (!writer.WriteVarint(str.size()) || !writer.WriteBytes(str.data(), str.size())) {
+                    return false;
+                }
+            }
+            return true;
         }
-        startAddr += sizeof(size_t);
-        if (strLen == 0) {
-            continue;
+        case BOOL_ARRAY_TYPE: {
+            const auto &vec = std::get<std::vector<bool>>(value.value_);
+            if (!writer.WriteVarint(vec.size())) {
+                return false;
+            }
+            for (size_t i = 0; i < vec.size(); i += BITS_PER_BYTE) {
+                uint8_t bits = 0;
+                for (size_t j = 0; j < BITS_PER_BYTE && i + j < vec.size(); j++) {
+                    bits |= static_cast<uint8_t>(vec[i + j]) << j;
+                }
+                if (!writer.WriteByte(bits)) {
+                    return false;
+                }
+            }
+            return true;
         }
-        errCode = memcpy_s(startAddr, strLen, strVec[i].c_str(), strLen);
-        if (errCode != E_OK) {
-            LOG_ERROR("memcpy failed when marshalling string array value's str data, %{public}d", errCode);
-            return -E_ERROR;
+        case DOUBLE_ARRAY_TYPE: {
+            const auto &vec = std::get<std::vector<double>>(value.value_);
+            return writer.WriteVarint(vec.size()) && writer.WriteBytes(vec.data(), vec.size() * sizeof(double));
         }
-        startAddr += strLen;
+        case UINT8_ARRAY_TYPE: {
+            const auto &vec = std::get<std::vector<uint8_t>>(value.value_);
+            return writer.WriteVarint(vec.size()) && writer.WriteBytes(vec.data(), vec.size());
+        }
+        case BIG_INT_TYPE: {
+            const BigInt &bigInt = std::get<BigInt>(value.value_);
+            return writer.WriteVarint(ZigZag(bigInt.sign_)) && writer.WriteVarint(bigInt.words_.size()) &&
+                writer.WriteBytes(bigInt.words_.data(), bigInt.words_.size() * sizeof(uint64_t));
+        }
+        case INT_ARRAY_TYPE:
+            return writer.WritePacked(std::get<std::vector<int>>(value.value_));
+        case INT64_ARRAY_TYPE:
+            return writer.WritePacked(std::get<std::vector<int64_t>>(value.value_));
+        default:
+            break;
     }
-    return E_OK;
+    return false;
 }
 
-int PreferencesValueParcel::MarshallingVecUInt8AfterType(const PreferencesValue &value, uint8_t *startAddr)
+bool PreferencesValueParcel::WriteValue(const PreferencesValue &value, uint8_t type, Writer &writer)
 {
-    std::vector<uint8_t> vec = std::get<std::vector<uint8_t>>(value.value_);
-    size_t vecNum = vec.size();
-    // write vec num
-    int errCode = memcpy_s(startAddr, sizeof(size_t), &vecNum, sizeof(size_t));
-    if (errCode != E_OK) {
-        LOG_ERROR("memcpy failed when marshalling uint8 array value's vector num, %{public}d", errCode);
-        return E_ERROR;
-    }
-    if (vecNum == 0) {
-        return E_OK;
-    }
-    startAddr += sizeof(size_t);
-    errCode = memcpy_s(startAddr, vecNum * sizeof(uint8_t), vec.data(), vecNum * sizeof(uint8_t));
-    if (errCode != E_OK) {
-        LOG_ERROR("memcpy failed when marshalling uint8 array value's data, %{public}d", errCode);
-        return E_ERROR;
+    switch (type) {
+        case INT_TYPE:
+            return writer.WriteByte(type) && writer.WriteVarint(ZigZag(std::get<int>(value.value_)));
+        case LONG_TYPE:
+            return writer.WriteByte(type) && writer.WriteVarint(ZigZag(std::get<int64_t>(value.value_)));
+        case FLOAT_TYPE: {
+            float floatValue = std::get<float>(value.value_);
+            return writer.WriteByte(type) && writer.WriteBytes(&floatValue, sizeof(float));
+        }
+        case DOUBLE_TYPE: {
+            double doubleValue = std::get<double>(value.value_);
+            return writer.WriteByte(type) && writer.WriteBytes(&doubleValue, sizeof(double));
+        }
+        case BOOL_TYPE:
+            return writer.WriteByte(type) && writer.WriteByte(std::get<bool>(value.value_) ? 1 : 0);
+        case STRING_TYPE:
+            return WriteString(std::get<std::string>(value.value_), type, writer);
+        case OBJECT_TYPE:
+            return WriteString(std::get<Object>(value.value_).valueStr, type, writer);
+        default:
+            return WriteArray(value, type, writer);
     }
-    return errCode;
 }
 
 /**
- *     --------------------------------------------------------------------------
- *     |  type  |  vec_num  |    sign    |     data1     |     data2     | .... |
- *     --------------------------------------------------------------------------
- * len:  uint8_t   size_t   sizeof(int64_t)  sizeof(int64_t)    sizeof(int64_t)
+ *     --------------------------------------
+ *     |  PARCEL_VERSION_V2  |  type  |  data  |
+ *     --------------------------------------
+ * len:        uint8_t          uint8_t
 */
-int PreferencesValueParcel::MarshallingVecBigIntAfterType(const PreferencesValue &value, uint8_t *startAddr)
+int PreferencesValueParcel::MarshallingPreferenceValue(const PreferencesValue &value, std::vector<uint8_t> &data)
 {
-    BigInt bigIntValue = std::get<BigInt>(value.value_);
-    int64_t sign = static_cast<int64_t>(bigIntValue.sign_);
-    std::vector<uint64_t> words = bigIntValue.words_;
-
-    // write vec num
-    size_t vecNum = words.size();
-    int errCode = memcpy_s(startAddr, sizeof(size_t), &vecNum, sizeof(size_t));
-    if (errCode != E_OK) {
-        LOG_ERROR("memcpy failed when marshalling bigInt array value's vector num, %{public}d", errCode);
-        return E_ERROR;
+    uint8_t type = GetTypeIndex(value);
+    if (type == MONO_TYPE) {
+        LOG_ERROR("MarshallingPreferenceValue failed, type invalid, %{public}d", E_INVALID_ARGS);
+        return E_INVALID_ARGS;
     }
-    startAddr += sizeof(size_t);
-
-    // write sign
-    errCode = memcpy_s(startAddr, sizeof(int64_t), &sign, sizeof(int64_t));
-    if (errCode != E_OK) {
-        LOG_ERROR("memcpy failed when marshalling bigInt array value's sign, %{public}d", errCode);
+    Writer writer(data.data(), data.size());
+    if (!writer.WriteByte(PARCEL_VERSION_V2) || !WriteValue(value, type, writer)) {
+        LOG_ERROR("MarshallingPreferenceValue failed, type: %{public}d, size: %{public}zu", type, data.size());
         return E_ERROR;
     }
-    startAddr += sizeof(int64_t);
-
-    // write vec element
-    for (size_t i = 0; i < vecNum; i++) {
-        uint64_t item = words[i];
-        errCode = memcpy_s(startAddr, sizeof(uint64_t), &item, sizeof(uint64_t));
-        if (errCode != E_OK) {
-            LOG_ERROR("memcpy failed when marshalling bigInt array value's words, %{public}d", errCode);
-            return E_ERROR;
-        }
-        startAddr += sizeof(uint64_t);
-    }
-    return errCode;
+    data.resize(writer.GetSize());
+    return E_OK;
 }
 
-int PreferencesValueParcel::MarshallingVecDoubleAfterType(const PreferencesValue &value, uint8_t *startAddr)
+bool PreferencesValueParcel::ReadString(uint8_t type, Reader &reader, PreferencesValue &value)
 {
-    std::vector<double> vec = std::get<std::vector<double>>(value.value_);
-    size_t vecNum = vec.size();
-    // write vec num
-    int errCode = memcpy_s(startAddr, sizeof(size_t), &vecNum, sizeof(size_t));
-    if (errCode != E_OK) {
-        LOG_ERROR("memcpy failed when marshalling double array value's vector num, %{public}d", errCode);
-        return E_ERROR;
-    }
-    startAddr += sizeof(size_t);
-
-    // write vec element
-    for (size_t i = 0; i < vecNum; i++) {
-        double item = vec[i];
-        errCode = memcpy_s(startAddr, sizeof(double), &item, sizeof(double));
-        if (errCode != E_OK) {
-            LOG_ERROR("memcpy failed when marshalling double array value's vector data, %{public}d", errCode);
-            return E_ERROR;
+    uint64_t len = 0;
+    if (!reader.ReadVarint(len) || len > Preferences::MAX_VALUE_LENGTH) {
+        return false;
+    }
+    std::string str;
+    if ((type & COMPRESSED_FLAG) != 0) {
+        if (!DecompressString(reader, len, str)) {
+            return false;
         }
-        startAddr += sizeof(double);
+    } else {
+        const uint8_t *data = nullptr;
+        if (!reader.ReadView(data, len)) {
+            return false;
+        }
+        str.assign(reinterpret_cast<const char *>(data), len);
+    }
+    if ((type & ~COMPRESSED_FLAG) == OBJECT_TYPE) {
+        Object obj;
+        obj.valueStr = std::move(str);
+        value = PreferencesValue(std::move(obj));
+    } else {
+        value = PreferencesValue(std::move(str));
     }
-    return errCode;
+    return true;
 }
 
-int PreferencesValueParcel::MarshallingVecBoolAfterType(const PreferencesValue &value, uint8_t *startAddr)
+bool PreferencesValueParcel::ReadArray(uint8_t type, Reader &reader, PreferencesValue &value)
 {
-    const std::vector<bool> vec = std::get<std::vector<bool>>(value.value_);
-    size_t vecNum = vec.size();
-    // write vec num
-    int errCode = memcpy_s(startAddr, sizeof(size_t), &vecNum, sizeof(size_t));
-    if (errCode != E_OK) {
-        LOG_ERROR("memcpy failed when marshalling bool array value's vector num, %{public}d", errCode);
-        return E_ERROR;
-    }
-    startAddr += sizeof(size_t);
-
-    // write vec element
-    for (size_t i = 0; i < vecNum; i++) {
-        bool item = vec[i];
-        errCode = memcpy_s(startAddr, sizeof(bool), &item, sizeof(bool));
-        if (errCode != E_OK) {
-            LOG_ERROR("memcpy failed when marshalling bool array value's vector data, %{public}d", errCode);
-            return E_ERROR;
+    int64_t sign = 0;
+    uint64_t num = 0;
+    if (type == BIG_INT_TYPE) {
+        uint64_t zigZagSign = 0;
+        if (!reader.ReadVarint(zigZagSign)) {
+            return false;
         }
-        startAddr += sizeof(bool);
+        sign = UnZigZag(zigZagSign);
     }
-    return errCode;
-}
-
-/**
- *     -----------------------------------------------------------------------
- *     |  type  |  vec_num  |    data1    |    data2    |    data3    | .... |
- *     ----------------------------------------------------------------------
- * len:  uint8_t   size_t     sizeof(typ)    sizeof(typ)
-*/
-int PreferencesValueParcel::MarshallingBasicArrayValue(const PreferencesValue &value, const uint8_t type,
-    std::vector<uint8_t> &data)
-{
-    uint8_t *startAddr = data.data();
-    int errCode = memcpy_s(startAddr, sizeof(uint8_t), &type, sizeof(uint8_t));
-    if (errCode != E_OK) {
-        LOG_ERROR("memcpy failed when marshalling basic array value's type, %{public}d", errCode);
-        return E_ERROR;
+    // a bool takes at least a bit and the others a byte, more elements than that are from corrupted data.
+    if (!reader.ReadVarint(num) || (type == BOOL_ARRAY_TYPE ? num / BITS_PER_BYTE : num) > reader.GetRemain()) {
+        return false;
     }
-    // write type
-    startAddr += sizeof(uint8_t);
-
     switch (type) {
-        case UINT8_ARRAY_TYPE:
-            errCode = MarshallingVecUInt8AfterType(value, startAddr);
-            break;
-        case BIG_INT_TYPE:
-            errCode = MarshallingVecBigIntAfterType(value, startAddr);
-            break;
-        case DOUBLE_ARRAY_TYPE:
-            errCode = MarshallingVecDoubleAfterType(value, startAddr);
-            break;
-        case BOOL_ARRAY_TYPE:
-            errCode = MarshallingVecBoolAfterType(value, startAddr);
-            break;
+        case STRING_ARRAY_TYPE: {
+            std::vector<std::string> vec(num);
+            for (auto &str : vec) {
+                uint64_t len = 0;
+                const uint8_t *data = nullptr;
+                if (!reader.ReadVarint(len) || !reader.ReadView(data, len)) {
+                    return false;
+                }
+                str.assign(reinterpret_cast<const char *>(data), len);
+            }
+            value = PreferencesValue(std::move(vec));
+            return true;
+        }
+        case BOOL_ARRAY_TYPE: {
+            std::vector<bool> vec(num);
+            uint8_t bits = 0;
+            for (size_t i = 0; i < num; i++) {
+                if (i % BITS_PER_BYTE == 0 && !reader.ReadByte(bits)) {
+                    return false;
+                }
+                vec[i] = ((bits >> (i % BITS_PER_BYTE)) & 1) != 0;
+            }
+            value = PreferencesValue(std::move(vec));
+            return true;
+        }
+        case DOUBLE_ARRAY_TYPE: {
+            std::vector<double> vec(num);
+            if (!reader.ReadBytes(vec.data(), num * sizeof(double))) {
+                return false;
+            }
+            value = PreferencesValue(std::move(vec));
+            return true;
+        }
+        case UINT8_ARRAY_TYPE: {
+            std::vector<uint8_t> vec(num);
+            if (!reader.ReadBytes(vec.data(), num)) {
+                return false;
+            }
+            value = PreferencesValue(std::move(vec));
+            return true;
+        }
+        case BIG_INT_TYPE: {
+            std::vector<uint64_t> words(num);
+            if (!reader.ReadBytes(words.data(), num * sizeof(uint64_t))) {
+                return false;
+            }
+            value = PreferencesValue(BigInt(words, static_cast<int>(sign)));
+            return true;
+        }
+        case INT_ARRAY_TYPE: {
+            std::vector<int> vec;
+            if (!reader.ReadPacked(num, vec)) {
+                return false;
+            }
+            value = PreferencesValue(std::move(vec));
+            return true;
+        }
+        case INT64_ARRAY_TYPE: {
+            std::vector<int64_t> vec;
+            if (!reader.ReadPacked(num, vec)) {
+                return false;
+            }
+            value = PreferencesValue(std::move(vec));
+            return true;
+        }
         default:
-            errCode = E_INVALID_ARGS;
             break;
     }
-    return errCode;
+    return false;
 }
 
-int PreferencesValueParcel::MarshallingPreferenceValue(const PreferencesValue &value, std::vector<uint8_t> &data)
+bool PreferencesValueParcel::ReadValue(uint8_t type, Reader &reader, PreferencesValue &value)
 {
-    int errCode = E_OK;
-    uint8_t type = GetTypeIndex(value);
-    switch (type) {
+    uint8_t baseType = type & ~COMPRESSED_FLAG;
+    if (type != baseType && baseType != STRING_TYPE && baseType != OBJECT_TYPE) {
+        return false;
+    }
+    switch (baseType) {
         case INT_TYPE:
-        case LONG_TYPE:
-        case FLOAT_TYPE:
-        case DOUBLE_TYPE:
-        case BOOL_TYPE:
-            errCode = MarshallingBasicValue(value, type, data);
-            break;
+        case LONG_TYPE: {
+            uint64_t zigZagValue = 0;
+            if (!reader.ReadVarint(zigZagValue)) {
+                return false;
+            }
+            int64_t longValue = UnZigZag(zigZagValue);
+            value = (type == INT_TYPE) ? PreferencesValue(static_cast<int>(longValue)) : PreferencesValue(longValue);
+            return true;
+        }
+        case FLOAT_TYPE: {
+            float floatValue = 0;
+            if (!reader.ReadBytes(&floatValue, sizeof(float))) {
+                return false;
+            }
+            value = PreferencesValue(floatValue);
+            return true;
+        }
+        case DOUBLE_TYPE: {
+            double doubleValue = 0;
+            if (!reader.ReadBytes(&doubleValue, sizeof(double))) {
+                return false;
+            }
+            value = PreferencesValue(doubleValue);
+            return true;
+        }
+        case BOOL_TYPE: {
+            uint8_t boolValue = 0;
+            if (!reader.ReadByte(boolValue)) {
+                return false;
+            }
+            value = PreferencesValue(boolValue != 0);
+            return true;
+        }
         case STRING_TYPE:
         case OBJECT_TYPE:
-            errCode = MarshallingStringValue(value, type, data);
-            break;
-        case STRING_ARRAY_TYPE:
-            errCode = MarshallingStringArrayValue(value, type, data);
-            break;
-        case UINT8_ARRAY_TYPE:
-        case BIG_INT_TYPE:
-        case DOUBLE_ARRAY_TYPE:
-        case BOOL_ARRAY_TYPE:
-            errCode = MarshallingBasicArrayValue(value, type, data);
-            break;
+            return ReadString(type, reader, value);
         default:
-            errCode = E_INVALID_ARGS;
-            LOG_ERROR("MarshallingPreferenceValue failed, type invalid, %{public}d", errCode);
-            break;
+            return ReadArray(type, reader, value);
+    }
+}
+
+std::pair<int, PreferencesValue> PreferencesValueParcel::UnmarshallingV2(const uint8_t *data, size_t len)
+{
+    Reader reader(data, len);
+    uint8_t type = MONO_TYPE;
+    PreferencesValue value(0);
+    if (!reader.ReadByte(type) || !ReadValue(type, reader, value) || reader.GetRemain() != 0) {
+        LOG_ERROR("UnmarshallingPreferenceValue failed, data corrupted, type: %{public}d, len: %{public}zu",
+            type, len);
+        return std::make_pair(E_INVALID_ARGS, PreferencesValue(0));
     }
-    return errCode;
+    return std::make_pair(E_OK, std::move(value));
 }
 
+/**
+ * The decoding of the v1 data, which starts with the type and has the lengths in size_t.
+ */
 std::pair<int, PreferencesValue> PreferencesValueParcel::UnmarshallingBasicValue(const uint8_t type,
-    const std::vector<uint8_t> &data)
+    const uint8_t *data)
 {
-    const uint8_t *startAddr = data.data();
+    const uint8_t *startAddr = data;
     switch (type) {
         case INT_TYPE: {
             const int intValue = *(reinterpret_cast<const int *>(startAddr + sizeof(uint8_t)));
@@ -480,37 +718,31 @@ std::pair<int, PreferencesValue> PreferencesValueParcel::UnmarshallingBasicValue
 }
 
 std::pair<int, PreferencesValue> PreferencesValueParcel::UnmarshallingStringValue(const uint8_t type,
-    const std::vector<uint8_t> &data)
+    const uint8_t *data)
 {
-    const uint8_t *startAddr = data.data();
-    std::string strValue;
+    const uint8_t *startAddr = data;
     size_t strLen = *(reinterpret_cast<const size_t *>(startAddr + sizeof(uint8_t)));
-    if (strLen == 0) {
-        strValue = "";
-    } else {
-        strValue.resize(strLen);
-        strValue.assign(startAddr + sizeof(uint8_t) + sizeof(size_t), startAddr + sizeof(uint8_t) + sizeof(size_t) +
-            strLen);
-    }
+    const uint8_t *strAddr = startAddr + sizeof(uint8_t) + sizeof(size_t);
+    std::string strValue(reinterpret_cast<const char *>(strAddr), strLen);
 
     if (type == OBJECT_TYPE) {
         Object obj;
-        obj.valueStr = strValue;
-        return std::make_pair(E_OK, PreferencesValue(obj));
+        obj.valueStr = std::move(strValue);
+        return std::make_pair(E_OK, PreferencesValue(std::move(obj)));
     } else if (type == STRING_TYPE) {
-        return std::make_pair(E_OK, PreferencesValue(strValue));
+        return std::make_pair(E_OK, PreferencesValue(std::move(strValue)));
     }
     return std::make_pair(E_INVALID_ARGS, PreferencesValue(0));
 }
 
 std::pair<int, PreferencesValue> PreferencesValueParcel::UnmarshallingStringArrayValue(const uint8_t type,
-    const std::vector<uint8_t> &data)
+    const uint8_t *data)
 {
     if (type != STRING_ARRAY_TYPE) {
         return std::make_pair(E_INVALID_ARGS, PreferencesValue(0));
     }
 
-    const uint8_t *startAddr = data.data() + sizeof(uint8_t);
+    const uint8_t *startAddr = data + sizeof(uint8_t);
     size_t vecNum = *(reinterpret_cast<const size_t *>(startAddr));
     startAddr += sizeof(size_t);
 
@@ -519,22 +751,15 @@ std::pair<int, PreferencesValue> PreferencesValueParcel::UnmarshallingStringArra
     for (size_t i = 0; i < vecNum; i++) {
         size_t strLen = *(reinterpret_cast<const size_t *>(startAddr));
         startAddr += sizeof(size_t);
-        std::string strValue;
-        if (strLen == 0) {
-            strValue = "";
-        } else {
-            strValue.resize(strLen);
-            strValue.assign(startAddr, startAddr + strLen);
-        }
-        strVec[i] = strValue;
+        strVec[i].assign(reinterpret_cast<const char *>(startAddr), strLen);
         startAddr += strLen;
     }
-    return std::make_pair(E_OK, PreferencesValue(strVec));
+    return std::make_pair(E_OK, PreferencesValue(std::move(strVec)));
 }
 
-std::pair<int, PreferencesValue> PreferencesValueParcel::UnmarshallingVecUInt8(const std::vector<uint8_t> &data)
+std::pair<int, PreferencesValue> PreferencesValueParcel::UnmarshallingVecUInt8(const uint8_t *data)
 {
-    const uint8_t *startAddr = data.data() + sizeof(uint8_t);
+    const uint8_t *startAddr = data + sizeof(uint8_t);
     size_t vecNum = *(reinterpret_cast<const size_t *>(startAddr));
     startAddr += sizeof(size_t);
 
@@ -545,12 +770,12 @@ std::pair<int, PreferencesValue> PreferencesValueParcel::UnmarshallingVecUInt8(c
         vec[i] = element;
         startAddr += sizeof(uint8_t);
     }
-    return std::make_pair(E_OK, PreferencesValue(vec));
+    return std::make_pair(E_OK, PreferencesValue(std::move(vec)));
 }
 
-std::pair<int, PreferencesValue> PreferencesValueParcel::UnmarshallingVecDouble(const std::vector<uint8_t> &data)
+std::pair<int, PreferencesValue> PreferencesValueParcel::UnmarshallingVecDouble(const uint8_t *data)
 {
-    const uint8_t *startAddr = data.data() + sizeof(uint8_t);
+    const uint8_t *startAddr = data + sizeof(uint8_t);
     size_t vecNum = *(reinterpret_cast<const size_t *>(startAddr));
     startAddr += sizeof(size_t);
 
@@ -561,12 +786,12 @@ std::pair<int, PreferencesValue> PreferencesValueParcel::UnmarshallingVecDouble(
         vec[i] = element;
         startAddr += sizeof(double);
     }
-    return std::make_pair(E_OK, PreferencesValue(vec));
+    return std::make_pair(E_OK, PreferencesValue(std::move(vec)));
 }
 
-std::pair<int, PreferencesValue> PreferencesValueParcel::UnmarshallingVecBool(const std::vector<uint8_t> &data)
+std::pair<int, PreferencesValue> PreferencesValueParcel::UnmarshallingVecBool(const uint8_t *data)
 {
-    const uint8_t *startAddr = data.data() + sizeof(uint8_t);
+    const uint8_t *startAddr = data + sizeof(uint8_t);
     size_t vecNum = *(reinterpret_cast<const size_t *>(startAddr));
     startAddr += sizeof(size_t);
 
@@ -577,12 +802,12 @@ std::pair<int, PreferencesValue> PreferencesValueParcel::UnmarshallingVecBool(co
         vec[i] = element;
         startAddr += sizeof(bool);
     }
-    return std::make_pair(E_OK, PreferencesValue(vec));
+    return std::make_pair(E_OK, PreferencesValue(std::move(vec)));
 }
 
-std::pair<int, PreferencesValue> PreferencesValueParcel::UnmarshallingVecBigInt(const std::vector<uint8_t> &data)
+std::pair<int, PreferencesValue> PreferencesValueParcel::UnmarshallingVecBigInt(const uint8_t *data)
 {
-    const uint8_t *startAddr = data.data() + sizeof(uint8_t);
+    const uint8_t *startAddr = data + sizeof(uint8_t);
     size_t vecNum = *(reinterpret_cast<const size_t *>(startAddr));
     startAddr += sizeof(size_t);
 
@@ -596,12 +821,11 @@ std::pair<int, PreferencesValue> PreferencesValueParcel::UnmarshallingVecBigInt(
         vec[i] = element;
         startAddr += sizeof(uint64_t);
     }
-    BigInt bigIntValue = BigInt(vec, sign);
-    return std::make_pair(E_OK, PreferencesValue(bigIntValue));
+    return std::make_pair(E_OK, PreferencesValue(BigInt(vec, sign)));
 }
 
 std::pair<int, PreferencesValue> PreferencesValueParcel::UnmarshallingBasicArrayValue(const uint8_t type,
-    const std::vector<uint8_t> &data)
+    const uint8_t *data)
 {
     switch (type) {
         case UINT8_ARRAY_TYPE:
@@ -623,12 +847,21 @@ std::pair<int, PreferencesValue> PreferencesValueParcel::UnmarshallingBasicArray
 }
 
 std::pair<int, PreferencesValue> PreferencesValueParcel::UnmarshallingPreferenceValue(const std::vector<uint8_t> &data)
+{
+    return UnmarshallingPreferenceValue(data.data(), data.size());
+}
+
+std::pair<int, PreferencesValue> PreferencesValueParcel::UnmarshallingPreferenceValue(const uint8_t *data, size_t len)
 {
     PreferencesValue value(0);
-    if (data.empty()) {
+    if (data == nullptr || len == 0) {
         LOG_ERROR("UnmarshallingPreferenceValue failed, data empty, %{public}d", E_INVALID_ARGS);
         return std::make_pair(E_INVALID_ARGS, value);
     }
+    if (data[0] == PARCEL_VERSION_V2) {
+        return UnmarshallingV2(data + sizeof(uint8_t), len - sizeof(uint8_t));
+    }
+    // the data of v1 starts with the type.
     uint8_t type = data[0];
 
     switch (type) {
@@ -655,4 +888,4 @@ std::pair<int, PreferencesValue> PreferencesValueParcel::UnmarshallingPreference
     return std::make_pair(E_INVALID_ARGS, value);
 }
 } // namespace NativePreferences
-} // namespace OHOS
\ No newline at end of file
+} // namespace OHOS
@@ -411,20 +411,26 @@ static bool IsFileExist(const std::string &inputPath)
         return false;
     }
     struct stat buffer;
-    return (stat(inputPath.c_str(), &buffer) == 0);
+    return (Stat(inputPath, buffer) == 0);
 }
 
 static void RemoveBackupFile(const std::string &fileName)
 {
     std::string backupFileName = PreferencesUtils::MakeFilePath(fileName, PreferencesUtils::STR_BACKUP);
-    if (IsFileExist(backupFileName) && std::remove(backupFileName.c_str())) {
+    if (IsFileExist(backupFileName) && Remove(backupFileName)) {
         LOG_WARN("failed to delete backup file %{public}d.", errno);
     }
 }
 
 static xmlDoc *ReadFile(const std::string &fileName, int &errCode)
 {
-    xmlDoc *doc = xmlReadFile(fileName.c_str(), "UTF-8", XML_PARSE_NOBLANKS | XML_PARSE_HUGE);
+    std::vector<uint8_t> content;
+    if (!ReadFileContent(fileName, content)) {
+        errCode = errno;
+        return nullptr;
+    }
+    xmlDoc *doc = xmlReadMemory(reinterpret_cast<const char *>(content.data()), static_cast<int>(content.size()),
+        fileName.c_str(), "UTF-8", XML_PARSE_NOBLANKS | XML_PARSE_HUGE);
     errCode = errno;
     return doc;
 }
@@ -479,20 +485,20 @@ static bool RenameFromBackupFile(
         std::string errMessage = (xmlErr != nullptr) ? xmlErr->message : "null";
         LOG_ERROR("%{public}s restore failed, errno:%{public}d, error:%{public}s.",
             ExtractFileName(fileName).c_str(), errCode, errMessage.c_str());
-        std::remove(backupFileName.c_str());
+        Remove(backupFileName);
         if (ReportNonCorruptError("read bak failed", fileName, bundleName, errCode)) {
             return false;
         }
         isReportCorrupt = true;
         return false;
     }
-    if (std::rename(backupFileName.c_str(), fileName.c_str())) {
+    if (Rename(backupFileName, fileName)) {
         LOG_ERROR("failed to restore backup errno %{public}d.", errno);
         return false;
     }
     isReportCorrupt = false;
     struct stat fileStats;
-    if (stat(fileName.c_str(), &fileStats) == -1) {
+    if (Stat(fileName, fileStats) == -1) {
         LOG_ERROR("failed to stat backup file.");
     }
     std::string appindex = "Restored from the backup. The file size is " + std::to_string(fileStats.st_size) + ".";
@@ -506,7 +512,7 @@ static bool RenameFromBackupFile(
 static bool RenameFile(const std::string &fileName, const std::string &fileType)
 {
     std::string name = PreferencesUtils::MakeFilePath(fileName, fileType);
-    if (std::rename(fileName.c_str(), name.c_str())) {
+    if (Rename(fileName, name)) {
         LOG_ERROR("failed to rename to %{public}s, err:%{public}d.", fileType.c_str(), errno);
         return false;
     }
@@ -785,13 +791,14 @@ static bool SaveXmlFile(const std::string &fileName, const std::string &bundleNa
         ReportSaveFileFault(fileName, bundleName, isReport, isMultiProcessing);
         return false;
     }
-    if (Write(fd, buf->content, buf->use) < 0) {
+    bool isSynced = false;
+    if (WriteAndSync(fd, buf->content, buf->use, isSynced) < 0) {
         LOG_ERROR("Failed write:%{public}s", ExtractFileName(fileName).c_str());
         ReportSaveFileFault(fileName, bundleName, isReport, isMultiProcessing);
         Close(fd);
         return false;
     }
-    if (!Fsync(fd)) {
+    if (!isSynced) {
         LOG_WARN("Failed to write to the disk.");
     }
     Close(fd);
@@ -207,7 +207,9 @@ int OH_Preferences_SetValue(OH_Preferences *preference, const char *key, OH_Pref
     }
 
     std::string keyStr(key);
-    int errCode = innerPreferences->Put(keyStr, static_cast<OH_PreferencesValueImpl*>(value)->value_);
+    // the value still belongs to the caller, the copy of it is moved into the preferences.
+    OHOS::NativePreferences::PreferencesValue valueCopy = static_cast<OH_PreferencesValueImpl*>(value)->value_;
+    int errCode = innerPreferences->Put(std::move(keyStr), std::move(valueCopy));
     if (errCode != OHOS::NativePreferences::E_OK) {
         LOG_ERROR("put value impl failed");
         return PREFERENCES_ERROR_STORAGE;
@@ -16,10 +16,17 @@
 #ifndef PREFERENCES_H
 #define PREFERENCES_H
 
+#include <atomic>
+#include <functional>
+#include <future>
+#include <map>
 #include <unordered_map>
 #include <memory>
 #include <string>
 #include <vector>
+#if defined(__cpp_impl_coroutine)
+#include <coroutine>
+#endif
 
 #include "preferences_errno.h"
 #include "preferences_observer.h"
@@ -60,6 +67,34 @@ public:
     std::string dataGroupId{ "" };
     bool isEnhance = false;
 };
+/**
+ * The cursor over the keys and values of a preferences, created by {@link Preferences::CreateIterator}.
+ */
+class PREF_API_EXPORT PreferencesIterator {
+public:
+    PREF_API_EXPORT virtual ~PreferencesIterator()
+    {
+    }
+
+    /**
+     * @brief Reads the next key and value of the preferences.
+     *
+     * The entries are read in no particular order, each of them once.
+     *
+     * @param key Indicates the key read.
+     * @param value Indicates the value read.
+     *
+     * @return Returns 0 when an entry is read, E_NO_DATA after the last entry, others for failure.
+     */
+    virtual int Next(std::string &key, PreferencesValue &value) = 0;
+};
+
+/**
+ * Hands the callback of an asynchronous operation over to the thread it should run on, such as the event loop of the
+ * caller. Without a resumer, the callback runs on the thread that completed the operation.
+ */
+using PreferencesResumer = std::function<void(std::function<void()>)>;
+
 /**
  * The function class of the preference. Various operations on preferences instances are provided in this class.
  */
@@ -448,7 +483,215 @@ public:
     {
         return {};
     }
+
+    /**
+     * @brief Sets a value for the key in the preferences, taking ownership of the key and value.
+     *
+     * This function behaves like {@link Put}, but moves the key and value into the preferences instead of
+     * copying them, which avoids an extra copy of large strings or arrays built by the caller.
+     *
+     * @param key Indicates the key of the preferences. It cannot be empty.
+     * @param value Indicates the value of the preferences.
+     *
+     * @return Returns 0 for success, others for failure.
+     */
+    virtual int Put(std::string &&key, PreferencesValue &&value)
+    {
+        return Put(static_cast<const std::string &>(key), static_cast<const PreferencesValue &>(value));
+    }
+
+    /**
+     * @brief Creates an iterator over all the keys and values of the preferences.
+     *
+     * Unlike {@link GetAll}, the values are read and decoded a few at a time when the storage supports it, and no
+     * lock is held between the calls of {@link PreferencesIterator::Next}. A key added, deleted or modified since the
+     * creation of the iterator may be returned either way, each key at most once. The preferences may be read and
+     * modified while iterating, by the holder of the iterator as well.
+     *
+     * @return Returns a pair, the first is 0 for success, others for failure.
+     */
+    virtual std::pair<int, std::shared_ptr<PreferencesIterator>> CreateIterator()
+    {
+        return {E_NOT_SUPPORTED, nullptr};
+    }
+
+    /**
+     * @brief Obtains the value of a preferences without waiting for the preferences to be loaded.
+     *
+     * While the preferences are still loading, the value comes from the layer set by {@link SetLoadingDefaults}, or
+     * is defValue when the layer does not have the key.
+     *
+     * @param key Indicates the key of the preferences. It cannot be empty.
+     * @param defValue Indicates the default value of the preferences.
+     *
+     * @return Returns a pair, the first is 0 for success, {@link E_NOT_LOADED} while the preferences are loading,
+     * others for failure.
+     */
+    virtual std::pair<int, PreferencesValue> TryGet(const std::string &key, const PreferencesValue &defValue)
+    {
+        return GetValue(key, defValue);
+    }
+
+    /**
+     * @brief Obtains the value of a preferences once it is loaded, without blocking the caller.
+     *
+     * The callback may run before this function returns when the preferences are loaded already.
+     *
+     * @param key Indicates the key of the preferences. It cannot be empty.
+     * @param defValue Indicates the default value of the preferences.
+     * @param callback Indicates the completion, it receives the result of {@link GetValue}.
+     * @param resumer Indicates where the callback runs, see {@link PreferencesResumer}.
+     */
+    virtual void GetAsync(const std::string &key, const PreferencesValue &defValue,
+        std::function<void(std::pair<int, PreferencesValue>)> callback, PreferencesResumer resumer = nullptr)
+    {
+        auto result = GetValue(key, defValue);
+        Resume(resumer, [callback = std::move(callback), result = std::move(result)] { callback(result); });
+    }
+
+    /**
+     * @brief Obtains the value of a preferences once it is loaded, without blocking the caller.
+     *
+     * @param key Indicates the key of the preferences. It cannot be empty.
+     * @param defValue Indicates the default value of the preferences.
+     *
+     * @return Returns a future of the result of {@link GetValue}.
+     */
+    std::future<std::pair<int, PreferencesValue>> GetAsync(const std::string &key, const PreferencesValue &defValue)
+    {
+        auto promise = std::make_shared<std::promise<std::pair<int, PreferencesValue>>>();
+        auto future = promise->get_future();
+        GetAsync(key, defValue, [promise](std::pair<int, PreferencesValue> result) {
+            promise->set_value(std::move(result));
+        });
+        return future;
+    }
+
+    /**
+     * @brief Sets the values answered by {@link TryGet} while the preferences are loading.
+     *
+     * @param defaults Indicates the keys and values of the layer, they replace the previous layer.
+     *
+     * @return Returns 0 for success, others for failure.
+     */
+    virtual int SetLoadingDefaults(const std::map<std::string, PreferencesValue> &defaults)
+    {
+        return E_NOT_SUPPORTED;
+    }
+
+    /**
+     * @brief Saves the preferences to the file without blocking the caller.
+     *
+     * @param callback Indicates the completion, it receives the result of {@link FlushSync}.
+     * @param resumer Indicates where the callback runs, see {@link PreferencesResumer}.
+     */
+    virtual void FlushAsync(std::function<void(int)> callback, PreferencesResumer resumer = nullptr)
+    {
+        int errCode = FlushSync();
+        Resume(resumer, [callback = std::move(callback), errCode] { callback(errCode); });
+    }
+
+protected:
+    static void Resume(const PreferencesResumer &resumer, std::function<void()> callback)
+    {
+        if (resumer) {
+            resumer(std::move(callback));
+        } else {
+            callback();
+        }
+    }
+};
+
+#if defined(__cpp_impl_coroutine)
+/**
+ * The base of the awaiters of the asynchronous operations of {@link Preferences}. The coroutine resumes where the
+ * callback of the operation runs, or at once when the operation completes before the coroutine is suspended.
+ */
+template<typename Result>
+class PreferencesAwaiter {
+public:
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    Result await_resume()
+    {
+        return std::move(state_->result);
+    }
+
+protected:
+    struct State {
+        std::atomic<bool> isSettled = false;
+        std::coroutine_handle<> handle;
+        Result result{};
+    };
+
+    // The first of the callback and Suspend settles the state, the callback resumes only if it comes second.
+    std::function<void(Result)> MakeCallback(std::coroutine_handle<> handle)
+    {
+        state_->handle = handle;
+        return [state = state_](Result result) {
+            state->result = std::move(result);
+            if (state->isSettled.exchange(true)) {
+                state->handle.resume();
+            }
+        };
+    }
+
+    bool Suspend()
+    {
+        return !state_->isSettled.exchange(true);
+    }
+
+    std::shared_ptr<State> state_ = std::make_shared<State>();
+};
+
+/**
+ * Awaits {@link Preferences::GetAsync}, co_await gives the pair of the error code and the value.
+ */
+class PreferencesGetAwaiter : public PreferencesAwaiter<std::pair<int, PreferencesValue>> {
+public:
+    PreferencesGetAwaiter(std::shared_ptr<Preferences> preferences, const std::string &key,
+        const PreferencesValue &defValue, PreferencesResumer resumer = nullptr)
+        : preferences_(std::move(preferences)), key_(key), defValue_(defValue), resumer_(std::move(resumer))
+    {
+    }
+
+    bool await_suspend(std::coroutine_handle<> handle)
+    {
+        preferences_->GetAsync(key_, defValue_, MakeCallback(handle), resumer_);
+        return Suspend();
+    }
+
+private:
+    std::shared_ptr<Preferences> preferences_;
+    std::string key_;
+    PreferencesValue defValue_;
+    PreferencesResumer resumer_;
+};
+
+/**
+ * Awaits {@link Preferences::FlushAsync}, co_await gives the error code.
+ */
+class PreferencesFlushAwaiter : public PreferencesAwaiter<int> {
+public:
+    explicit PreferencesFlushAwaiter(std::shared_ptr<Preferences> preferences, PreferencesResumer resumer = nullptr)
+        : preferences_(std::move(preferences)), resumer_(std::move(resumer))
+    {
+    }
+
+    bool await_suspend(std::coroutine_handle<> handle)
+    {
+        preferences_->FlushAsync(MakeCallback(handle), resumer_);
+        return Suspend();
+    }
+
+private:
+    std::shared_ptr<Preferences> preferences_;
+    PreferencesResumer resumer_;
 };
+#endif
 } // End of namespace NativePreferences
 } // End of namespace OHOS
 #endif // End of #ifndef PREFERENCES_H
\ No newline at end of file
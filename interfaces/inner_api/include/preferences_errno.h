@@ -183,6 +183,21 @@ constexpr int E_SUBSCRIBE_FAILED = (E_BASE + 26);
 * @brief This code is still operated after the removePreferencesFromCache or deletePreferences operation is performed.
 */
 constexpr int E_OBJECT_NOT_ACTIVE = (E_BASE + 27);
+
+/**
+* @brief This code is used when the unflushed data exceeds the dirty bytes limit and is not flushed in time.
+*/
+constexpr int E_DIRTY_BYTES_EXCEED_LIMIT = (E_BASE + 28);
+
+/**
+* @brief This code is used when some preferences are not flushed before the deadline.
+*/
+constexpr int E_FLUSH_TIMEOUT = (E_BASE + 29);
+
+/**
+* @brief This code is used when a value is read before the preferences are loaded.
+*/
+constexpr int E_NOT_LOADED = (E_BASE + 30);
 } // namespace NativePreferences
 } // namespace OHOS
 #endif // PREFERENCES_ERRNO_H
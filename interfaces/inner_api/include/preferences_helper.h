@@ -16,10 +16,13 @@
 #ifndef PREFERENCES_HELPER_H
 #define PREFERENCES_HELPER_H
 
+#include <chrono>
+#include <future>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <vector>
 
 #include "preferences.h"
 
@@ -38,6 +41,9 @@ public:
      * preferences instance is being used in another thread, it will be cached until it will no longer be used to and
      * performed {@link RemovePreferencesFromCache}.
      *
+     * A GSKV preferences instance is returned while its database is still opening in the background, its operations
+     * wait for the open and return its error code if it fails.
+     *
      * @param options Indicates the preferences configuration
      * @param errCode Indicates the error code. Returns 0 for success, others for failure.
      *
@@ -45,6 +51,16 @@ public:
      */
     PREF_API_EXPORT static std::shared_ptr<Preferences> GetPreferences(const Options &options, int &errCode);
 
+    /**
+     * @brief Obtains a preferences instance in the background, see {@link GetPreferences}.
+     *
+     * @param options Indicates the preferences configuration
+     * @param callback Indicates the completion, called with the error code and the preferences instance.
+     * @param resumer Indicates where to call the completion, see {@link PreferencesResumer}.
+     */
+    PREF_API_EXPORT static void GetPreferencesAsync(const Options &options,
+        std::function<void(int, std::shared_ptr<Preferences>)> callback, PreferencesResumer resumer = nullptr);
+
     /**
      * @brief Deletes a preferences instance matching a specified preferences file name.
      *
@@ -75,9 +91,96 @@ public:
      */
     PREF_API_EXPORT static bool IsStorageTypeSupported(const StorageType &type);
 
+    /**
+     * @brief Flushes all the cached preferences instances which have unsaved modifications to the files.
+     *
+     * The instances are flushed in parallel on a bounded pool of I/O threads, for example when the application is
+     * switched to the background. The flushes which have not started before the deadline are skipped.
+     *
+     * @param timeout Indicates the time budget of the whole operation, counted from the call.
+     * @param unflushedPaths Returns the file paths of the preferences which are not flushed before the deadline or
+     * failed to flush.
+     *
+     * @return Returns 0 if all the preferences are flushed, returns {@link E_FLUSH_TIMEOUT} if some preferences
+     * missed the deadline, others for failure.
+     */
+    PREF_API_EXPORT static int FlushAll(std::chrono::milliseconds timeout, std::vector<std::string> &unflushedPaths);
+
+    struct CacheStats {
+        // the estimated bytes of the cached instances when they were last measured.
+        int64_t memoryBytes = 0;
+        uint64_t evictCount = 0;
+        // the opens of the files whose instances were evicted, and the time they took in microseconds.
+        uint64_t reloadCount = 0;
+        uint64_t reloadTime = 0;
+        // the opens of the files, a caller that shares the open in progress of its file is not counted.
+        uint64_t openCount = 0;
+    };
+
+    /**
+     * @brief Sets the memory budget of the cached preferences instances.
+     *
+     * Past the budget, the cached instances which are not referenced outside the cache and have no unsaved
+     * modifications are closed and removed from the cache, the least recently obtained first. They are opened again
+     * by the next {@link GetPreferences} of their files.
+     *
+     * @param budget Indicates the budget in bytes, 0 for no budget, which is the default.
+     *
+     * @return Returns 0 for success, others if the budget is negative.
+     */
+    PREF_API_EXPORT static int SetCacheMemoryBudget(int64_t budget);
+
+    /**
+     * @brief Obtains the statistics of the eviction of the cached preferences instances.
+     */
+    PREF_API_EXPORT static CacheStats GetCacheStats();
+
+    /**
+     * @brief Opens the preferences in parallel in the background.
+     *
+     * The opens are registered before the call returns, so the {@link GetPreferences} calls of the files made after
+     * it wait for these opens instead of starting their own.
+     *
+     * @param options Indicates the configurations of the preferences.
+     *
+     * @return Returns 0 if all the opens are started, returns the error code of the first invalid file path otherwise.
+     * The opens of the valid ones are started anyway.
+     */
+    PREF_API_EXPORT static int Preload(const std::vector<Options> &options);
+
+    /**
+     * @brief Preloads the preferences recorded in a manifest by the previous launch, and records the current one.
+     *
+     * The files obtained by {@link GetPreferences} and the keys read from the GSKV preferences within the duration
+     * are saved to the manifest when it ends. A later call replaces the recording of an earlier one.
+     *
+     * @param manifestPath Indicates the path of the manifest file.
+     * @param duration Indicates how long to record, counted from the call.
+     *
+     * @return Returns 0 for success, others if the manifest path is invalid.
+     */
+    PREF_API_EXPORT static int StartPrefetchManifest(const std::string &manifestPath,
+        std::chrono::milliseconds duration);
+
 private:
     // use bool to mark whether Preferences is EnhancePreferences or not
     static std::map<std::string, std::pair<std::shared_ptr<Preferences>, bool>> prefsCache_;
+    struct OpenResult {
+        std::shared_ptr<Preferences> pref;
+        bool isEnhance = false;
+        int errCode = 0;
+    };
+    // the opens in progress, outside of prefsCacheMutex_. The callers of the same path wait for the first one.
+    static std::map<std::string, std::shared_future<OpenResult>> openingPrefs_;
+    // The open of a path: the cached instance, or the open to run when promise is set, or the one to wait for.
+    struct OpenState {
+        std::shared_ptr<Preferences> pref;
+        bool isEnhance = false;
+        std::shared_ptr<std::promise<OpenResult>> promise;
+        std::shared_future<OpenResult> future;
+        std::shared_future<void> closing;
+        bool isReload = false;
+    };
     static std::mutex prefsCacheMutex_;
     static std::atomic<bool> isReportFault_;
 
@@ -85,7 +188,45 @@ private:
     static int GetPreferencesInner(const Options &options, bool &isEnhancePreferences,
         std::shared_ptr<Preferences> &pref);
     static std::pair<std::string, int> DeletePreferencesCache(const std::string &realPath);
+    static void WaitOpening(const std::string &realPath, std::unique_lock<std::mutex> &lock);
+    // Finds the path in the cache, or registers its open in openingPrefs_ unless another one is running.
+    static void StartOpen(const std::string &realPath, OpenState &state);
+    static std::shared_ptr<Preferences> FinishOpen(const Options &options, const std::string &realPath,
+        OpenState &state, int &errCode);
+    // Registers the open of the file at once and runs it on the preload pool, then prefetches the keys.
+    static void PreloadFile(const Options &options, std::vector<std::string> &&keys);
+    static void StartEvictIdlePreferences();
+    static void EvictIdlePreferences();
+    static void SavePrefetchManifest(uint64_t generation);
+};
+
+#if defined(__cpp_impl_coroutine)
+/**
+ * Awaits {@link PreferencesHelper::GetPreferencesAsync}, co_await gives the pair of the error code and the
+ * preferences instance.
+ */
+class PreferencesOpenAwaiter : public PreferencesAwaiter<std::pair<int, std::shared_ptr<Preferences>>> {
+public:
+    explicit PreferencesOpenAwaiter(const Options &options, PreferencesResumer resumer = nullptr)
+        : options_(options), resumer_(std::move(resumer))
+    {
+    }
+
+    bool await_suspend(std::coroutine_handle<> handle)
+    {
+        auto callback = MakeCallback(handle);
+        PreferencesHelper::GetPreferencesAsync(options_,
+            [callback = std::move(callback)](int errCode, std::shared_ptr<Preferences> preferences) {
+                callback({ errCode, std::move(preferences) });
+            }, resumer_);
+        return Suspend();
+    }
+
+private:
+    Options options_;
+    PreferencesResumer resumer_;
 };
+#endif
 } // End of namespace NativePreferences
 } // End of namespace OHOS
 #endif // End of #ifndef PREFERENCES_HELPER_H
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "preferences_bloom_filter.h"
+#include <gtest/gtest.h>
+#include <string>
+
+using namespace testing::ext;
+using namespace OHOS::NativePreferences;
+namespace {
+class PreferencesBloomFilterTest : public testing::Test {
+public:
+    static void SetUpTestCase(void);
+    static void TearDownTestCase(void);
+    void SetUp();
+    void TearDown();
+};
+
+void PreferencesBloomFilterTest::SetUpTestCase(void)
+{
+}
+
+void PreferencesBloomFilterTest::TearDownTestCase(void)
+{
+}
+
+void PreferencesBloomFilterTest::SetUp(void)
+{
+}
+
+void PreferencesBloomFilterTest::TearDown(void)
+{
+}
+
+/**
+ * @tc.name: PreferencesBloomFilterTest_001
+ * @tc.desc: normal testcase of the bloom filter, no false negative and few false positives
+ * @tc.type: FUNC
+ */
+HWTEST_F(PreferencesBloomFilterTest, PreferencesBloomFilterTest_001, TestSize.Level0)
+{
+    constexpr int keyNum = 10000;
+    PreferencesBloomFilter filter(keyNum, 1);
+    EXPECT_FALSE(filter.MightContain(PreferencesBloomFilter::Hash("key_0")));
+    for (int i = 0; i < keyNum; i++) {
+        filter.Add(PreferencesBloomFilter::Hash("key_" + std::to_string(i)));
+    }
+    for (int i = 0; i < keyNum; i++) {
+        EXPECT_TRUE(filter.MightContain(PreferencesBloomFilter::Hash("key_" + std::to_string(i))));
+    }
+    int falsePositiveNum = 0;
+    for (int i = 0; i < keyNum; i++) {
+        if (filter.MightContain(PreferencesBloomFilter::Hash("absent_" + std::to_string(i)))) {
+            falsePositiveNum++;
+        }
+    }
+    EXPECT_LT(falsePositiveNum, keyNum / 50);
+    EXPECT_FALSE(filter.IsOverloaded());
+    EXPECT_EQ(filter.GetVersion(), 1);
+    filter.SetVersion(2);
+    EXPECT_EQ(filter.GetVersion(), 2);
+}
+
+/**
+ * @tc.name: PreferencesBloomFilterTest_002
+ * @tc.desc: normal testcase of the bloom filter, it is overloaded by more keys than it is sized for
+ * @tc.type: FUNC
+ */
+HWTEST_F(PreferencesBloomFilterTest, PreferencesBloomFilterTest_002, TestSize.Level0)
+{
+    PreferencesBloomFilter filter(0, 0);
+    int i = 0;
+    while (!filter.IsOverloaded()) {
+        filter.Add(PreferencesBloomFilter::Hash("key_" + std::to_string(i++)));
+    }
+    EXPECT_GT(i, 0);
+    for (int j = 0; j < i; j++) {
+        EXPECT_TRUE(filter.MightContain(PreferencesBloomFilter::Hash("key_" + std::to_string(j))));
+    }
+}
+} // namespace
@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "preferences.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <future>
+#include <string>
+#include <thread>
+
+#include "preferences_errno.h"
+#include "preferences_helper.h"
+
+using namespace testing::ext;
+using namespace OHOS::NativePreferences;
+namespace {
+class PreferencesCoroutineTest : public testing::Test {
+public:
+    static void SetUpTestCase(void);
+    static void TearDownTestCase(void);
+    void SetUp();
+    void TearDown();
+};
+
+void PreferencesCoroutineTest::SetUpTestCase(void)
+{
+}
+
+void PreferencesCoroutineTest::TearDownTestCase(void)
+{
+}
+
+void PreferencesCoroutineTest::SetUp(void)
+{
+}
+
+void PreferencesCoroutineTest::TearDown(void)
+{
+}
+
+// A coroutine that starts at once and frees its frame when it returns.
+struct DetachedTask {
+    struct promise_type {
+        DetachedTask get_return_object()
+        {
+            return {};
+        }
+        std::suspend_never initial_suspend() noexcept
+        {
+            return {};
+        }
+        std::suspend_never final_suspend() noexcept
+        {
+            return {};
+        }
+        void return_void()
+        {
+        }
+        void unhandled_exception()
+        {
+            std::terminate();
+        }
+    };
+};
+
+struct AwaitResult {
+    int openCode = E_ERROR;
+    int flushCode = E_ERROR;
+    int getCode = E_ERROR;
+    int value = 0;
+};
+
+DetachedTask FlushAndGet(std::shared_ptr<Preferences> preferences, PreferencesResumer resumer,
+    std::promise<AwaitResult> *done)
+{
+    AwaitResult result;
+    result.flushCode = co_await PreferencesFlushAwaiter(preferences, resumer);
+    auto [errCode, value] = co_await PreferencesGetAwaiter(preferences, "key", PreferencesValue(0), resumer);
+    result.getCode = errCode;
+    result.value = value;
+    done->set_value(result);
+}
+
+/**
+ * @tc.name: PreferencesCoroutineTest_001
+ * @tc.desc: normal testcase of co_await on FlushAsync and GetAsync, with and without a resumer
+ * @tc.type: FUNC
+ */
+HWTEST_F(PreferencesCoroutineTest, PreferencesCoroutineTest_001, TestSize.Level1)
+{
+    int errCode = E_OK;
+    std::string path = "/data/test/coroutine_test_001";
+    auto preferences = PreferencesHelper::GetPreferences(path, errCode);
+    ASSERT_NE(preferences, nullptr);
+    EXPECT_EQ(preferences->PutInt("key", 1), E_OK);
+
+    // without a resumer the coroutine goes on where the operations complete.
+    std::promise<AwaitResult> done;
+    FlushAndGet(preferences, nullptr, &done);
+    auto future = done.get_future();
+    ASSERT_EQ(future.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    auto result = future.get();
+    EXPECT_EQ(result.flushCode, E_OK);
+    EXPECT_EQ(result.getCode, E_OK);
+    EXPECT_EQ(result.value, 1);
+
+    // the resumer runs the continuations inline, it sees each of the two awaits once.
+    std::atomic<int> resumeCount = 0;
+    PreferencesResumer resumer = [&resumeCount](std::function<void()> continuation) {
+        resumeCount++;
+        continuation();
+    };
+    EXPECT_EQ(preferences->PutInt("key", 2), E_OK);
+    std::promise<AwaitResult> resumedDone;
+    FlushAndGet(preferences, resumer, &resumedDone);
+    auto resumedFuture = resumedDone.get_future();
+    ASSERT_EQ(resumedFuture.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    result = resumedFuture.get();
+    EXPECT_EQ(result.flushCode, E_OK);
+    EXPECT_EQ(result.getCode, E_OK);
+    EXPECT_EQ(result.value, 2);
+    EXPECT_EQ(resumeCount, 2);
+
+    PreferencesHelper::DeletePreferences(path);
+}
+
+DetachedTask OpenAndGet(Options options, PreferencesResumer resumer, std::promise<AwaitResult> *done)
+{
+    AwaitResult result;
+    auto [openCode, preferences] = co_await PreferencesOpenAwaiter(options, resumer);
+    result.openCode = openCode;
+    if (preferences != nullptr) {
+        auto [errCode, value] = co_await PreferencesGetAwaiter(preferences, "key", PreferencesValue(0), resumer);
+        result.getCode = errCode;
+        result.value = value;
+    }
+    done->set_value(result);
+}
+
+/**
+ * @tc.name: PreferencesCoroutineTest_002
+ * @tc.desc: normal testcase of co_await on GetPreferencesAsync, with and without a resumer
+ * @tc.type: FUNC
+ */
+HWTEST_F(PreferencesCoroutineTest, PreferencesCoroutineTest_002, TestSize.Level1)
+{
+    int errCode = E_OK;
+    std::string path = "/data/test/coroutine_test_002";
+    auto preferences = PreferencesHelper::GetPreferences(path, errCode);
+    ASSERT_NE(preferences, nullptr);
+    EXPECT_EQ(preferences->PutInt("key", 1), E_OK);
+    EXPECT_EQ(preferences->FlushSync(), E_OK);
+    preferences = nullptr;
+    EXPECT_EQ(PreferencesHelper::RemovePreferencesFromCache(path), E_OK);
+
+    // the instance is loaded again from the file.
+    std::promise<AwaitResult> done;
+    OpenAndGet(Options(path), nullptr, &done);
+    auto future = done.get_future();
+    ASSERT_EQ(future.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    auto result = future.get();
+    EXPECT_EQ(result.openCode, E_OK);
+    EXPECT_EQ(result.getCode, E_OK);
+    EXPECT_EQ(result.value, 1);
+
+    // the resumer runs the continuations inline, it sees each of the two awaits once.
+    std::atomic<int> resumeCount = 0;
+    PreferencesResumer resumer = [&resumeCount](std::function<void()> continuation) {
+        resumeCount++;
+        continuation();
+    };
+    std::promise<AwaitResult> resumedDone;
+    OpenAndGet(Options(path), resumer, &resumedDone);
+    auto resumedFuture = resumedDone.get_future();
+    ASSERT_EQ(resumedFuture.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    result = resumedFuture.get();
+    EXPECT_EQ(result.openCode, E_OK);
+    EXPECT_EQ(result.value, 1);
+    EXPECT_EQ(resumeCount, 2);
+
+    // an invalid path fails the open, no instance is given.
+    std::promise<AwaitResult> failedDone;
+    OpenAndGet(Options("invalid_path"), nullptr, &failedDone);
+    auto failedFuture = failedDone.get_future();
+    ASSERT_EQ(failedFuture.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    result = failedFuture.get();
+    EXPECT_NE(result.openCode, E_OK);
+    EXPECT_EQ(result.getCode, E_ERROR);
+
+    PreferencesHelper::DeletePreferences(path);
+}
+} // namespace
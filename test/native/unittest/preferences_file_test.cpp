@@ -15,14 +15,18 @@
 
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <cstdio>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include "log_print.h"
 #include "preferences.h"
 #include "preferences_errno.h"
 #include "preferences_file_operation.h"
 #include "preferences_helper.h"
+#include "preferences_vfs.h"
 #include "preferences_xml_utils.h"
 
 using namespace testing::ext;
@@ -431,4 +435,91 @@ HWTEST_F(PreferencesFileTest, NativePreferencesFileTest_009, TestSize.Level0)
     ret = PreferencesHelper::DeletePreferences(file);
     EXPECT_EQ(ret, E_OK);
 }
-}
\ No newline at end of file
+
+/**
+ * @tc.name: NativePreferencesFileTest_010
+ * @tc.desc: normal testcase of WriteAndSync, the file has the content and the data is synced
+ * @tc.type: FUNC
+ */
+HWTEST_F(PreferencesFileTest, NativePreferencesFileTest_010, TestSize.Level1)
+{
+    std::vector<uint8_t> content(16 * 1024, 'a');
+    std::string file = "/data/test/write_and_sync_test";
+    int fd = Open(file);
+    ASSERT_NE(fd, -1);
+    bool isSynced = false;
+    EXPECT_EQ(WriteAndSync(fd, content.data(), static_cast<ssize_t>(content.size()), isSynced),
+        static_cast<int>(content.size()));
+    EXPECT_TRUE(isSynced);
+    Close(fd);
+
+    struct stat buffer;
+    EXPECT_EQ(stat(file.c_str(), &buffer), 0);
+    EXPECT_EQ(buffer.st_size, static_cast<off_t>(content.size()));
+    std::remove(file.c_str());
+}
+
+/**
+ * @tc.name: NativePreferencesFileTest_011
+ * @tc.desc: normal testcase of flush and load on the in-memory file system
+ * @tc.type: FUNC
+ */
+HWTEST_F(PreferencesFileTest, NativePreferencesFileTest_011, TestSize.Level0)
+{
+    auto memoryVfs = std::make_shared<PreferencesMemoryVfs>();
+    PreferencesVfs::SetInstance(memoryVfs);
+    EXPECT_EQ(Mkdir("/data/test"), 0);
+
+    std::string file = "/data/test/memory_vfs_test";
+    int errCode = E_OK;
+    std::shared_ptr<Preferences> pref = PreferencesHelper::GetPreferences(file, errCode);
+    ASSERT_NE(pref, nullptr);
+    EXPECT_EQ(PreferencesPutValue(pref, "intKey", 11, "strKey", "memory"), E_OK);
+    EXPECT_EQ(PreferencesHelper::RemovePreferencesFromCache(file), E_OK);
+
+    pref = PreferencesHelper::GetPreferences(file, errCode);
+    ASSERT_NE(pref, nullptr);
+    EXPECT_EQ(pref->GetInt("intKey", 0), 11);
+    EXPECT_EQ(pref->GetString("strKey", ""), "memory");
+    EXPECT_EQ(Access(file), 0);
+
+    EXPECT_EQ(PreferencesHelper::DeletePreferences(file), E_OK);
+    EXPECT_NE(Access(file), 0);
+    PreferencesVfs::SetInstance(nullptr);
+    EXPECT_NE(Access(file), 0);
+}
+
+/**
+ * @tc.name: NativePreferencesFileTest_012
+ * @tc.desc: testcase of flush with the injected latency and errors
+ * @tc.type: FUNC
+ */
+HWTEST_F(PreferencesFileTest, NativePreferencesFileTest_012, TestSize.Level1)
+{
+    auto faultVfs = std::make_shared<PreferencesFaultVfs>(std::make_shared<PreferencesMemoryVfs>());
+    PreferencesVfs::SetInstance(faultVfs);
+
+    std::string file = "/data/test/fault_vfs_test";
+    int errCode = E_OK;
+    std::shared_ptr<Preferences> pref = PreferencesHelper::GetPreferences(file, errCode);
+    ASSERT_NE(pref, nullptr);
+
+    const auto latency = std::chrono::milliseconds(20);
+    faultVfs->SetFault(VfsOperation::FSYNC, latency);
+    auto begin = std::chrono::steady_clock::now();
+    EXPECT_EQ(PreferencesPutValue(pref, "intKey", 12, "strKey", "fault"), E_OK);
+    EXPECT_GE(std::chrono::steady_clock::now() - begin, latency);
+
+    faultVfs->SetFault(VfsOperation::WRITE, std::chrono::microseconds(0), EIO);
+    EXPECT_EQ(PreferencesPutValue(pref, "intKey", 13, "strKey", "fault"), E_ERROR);
+    faultVfs->ClearFaults();
+
+    EXPECT_EQ(PreferencesHelper::RemovePreferencesFromCache(file), E_OK);
+    pref = PreferencesHelper::GetPreferences(file, errCode);
+    ASSERT_NE(pref, nullptr);
+    EXPECT_EQ(pref->GetInt("intKey", 0), 12);
+
+    EXPECT_EQ(PreferencesHelper::DeletePreferences(file), E_OK);
+    PreferencesVfs::SetInstance(nullptr);
+}
+}
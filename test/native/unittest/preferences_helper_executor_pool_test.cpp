@@ -17,19 +17,58 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cctype>
+#include <chrono>
+#include <future>
 #include <iostream>
+#include <map>
 #include <string>
+#include <thread>
+#include <vector>
 
+#include "executor_pool.h"
 #include "log_print.h"
 #include "preferences.h"
 #include "preferences_errno.h"
 #include "preferences_observer.h"
+#include "preferences_task_processor.h"
+#include "timer_wheel.h"
 
 using namespace testing::ext;
 using namespace OHOS::NativePreferences;
 
 namespace {
+// Submits short tasks from some threads and returns how many times each of the tasks ran.
+std::vector<int> RunShortTasks(ExecutorPool &pool, int submitterNum, int taskNumPerSubmitter)
+{
+    int taskNum = submitterNum * taskNumPerSubmitter;
+    std::vector<int> runTimes(taskNum, 0);
+    std::atomic<int> finishCount = 0;
+    std::promise<void> finished;
+    std::vector<std::thread> submitters;
+    for (int i = 0; i < submitterNum; i++) {
+        submitters.emplace_back([&, i] {
+            for (int j = 0; j < taskNumPerSubmitter; j++) {
+                int index = i * taskNumPerSubmitter + j;
+                auto taskId = pool.Execute([&, index] {
+                    runTimes[index]++;
+                    if (++finishCount == taskNum) {
+                        finished.set_value();
+                    }
+                });
+                EXPECT_NE(taskId, ExecutorPool::INVALID_TASK_ID);
+            }
+        });
+    }
+    for (auto &submitter : submitters) {
+        submitter.join();
+    }
+    EXPECT_EQ(finished.get_future().wait_for(std::chrono::seconds(30)), std::future_status::ready);
+    return runTimes;
+}
+
 class PreferencesHelperExecutorPoolTest : public testing::Test {
 public:
     static void SetUpTestCase(void);
@@ -294,4 +333,240 @@ HWTEST_F(PreferencesHelperExecutorPoolTest, NativePreferencesHelperFfrtTest_001,
     ret = PreferencesHelper::DeletePreferences(path);
     EXPECT_EQ(ret, E_OK);
 }
+
+/**
+ * @tc.name: NativePreferencesTaskLaneTest_001
+ * @tc.desc: normal testcase of the lanes of the task processor, a busy flush lane does not delay the notify lane
+ * @tc.type: FUNC
+ */
+HWTEST_F(PreferencesHelperExecutorPoolTest, NativePreferencesTaskLaneTest_001, TestSize.Level1)
+{
+    auto processor = PreferencesTaskProcessor::GetInstance();
+    ASSERT_NE(processor, nullptr);
+    // the busy tasks hold the flush lane until the gate opens.
+    std::promise<void> gate;
+    std::shared_future<void> gateFuture = gate.get_future().share();
+    auto flushConcurrency = PreferencesTaskProcessor::GetLaneConfig(TaskLane::FLUSH).concurrency;
+    std::vector<std::promise<void>> busyDone(flushConcurrency + 1);
+    std::vector<std::future<void>> busyFutures;
+    for (auto &done : busyDone) {
+        busyFutures.push_back(done.get_future());
+        EXPECT_TRUE(processor->Execute(TaskLane::FLUSH, [gateFuture, &done] {
+            gateFuture.wait();
+            done.set_value();
+        }));
+    }
+    auto before = PreferencesTaskProcessor::GetLaneStats(TaskLane::NOTIFY);
+    std::promise<void> notified;
+    EXPECT_TRUE(processor->Execute(TaskLane::NOTIFY, [&notified] { notified.set_value(); }));
+    auto notifiedFuture = notified.get_future();
+    EXPECT_EQ(notifiedFuture.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    for (auto &future : busyFutures) {
+        EXPECT_EQ(future.wait_for(std::chrono::seconds(0)), std::future_status::timeout);
+    }
+
+    std::promise<void> scheduled;
+    auto begin = std::chrono::steady_clock::now();
+    EXPECT_TRUE(processor->Schedule(TaskLane::DFX, std::chrono::milliseconds(50), [&scheduled] {
+        scheduled.set_value();
+    }));
+    scheduled.get_future().wait();
+    EXPECT_GE(std::chrono::steady_clock::now() - begin, std::chrono::milliseconds(50));
+
+    auto after = PreferencesTaskProcessor::GetLaneStats(TaskLane::NOTIFY);
+    EXPECT_EQ(after.submitCount, before.submitCount + 1);
+    EXPECT_GE(after.maxQueueDepth, 1);
+    auto flushStats = PreferencesTaskProcessor::GetLaneStats(TaskLane::FLUSH);
+    EXPECT_GE(flushStats.maxQueueDepth, 1);
+    // the wait time of the busy tasks is counted when they start.
+    gate.set_value();
+    for (auto &future : busyFutures) {
+        future.wait();
+    }
+    flushStats = PreferencesTaskProcessor::GetLaneStats(TaskLane::FLUSH);
+    EXPECT_EQ(flushStats.queueDepth, 0);
+    EXPECT_GT(flushStats.maxWaitTime, 0);
+}
+
+/**
+ * @tc.name: NativePreferencesTaskLaneStatsTest_001
+ * @tc.desc: normal testcase of the run time, the latency histograms and the executor stats
+ * @tc.type: FUNC
+ */
+HWTEST_F(PreferencesHelperExecutorPoolTest, NativePreferencesTaskLaneStatsTest_001, TestSize.Level1)
+{
+    auto processor = PreferencesTaskProcessor::GetInstance();
+    ASSERT_NE(processor, nullptr);
+    auto before = PreferencesTaskProcessor::GetLaneStats(TaskLane::FLUSH);
+    std::promise<void> finished;
+    EXPECT_TRUE(processor->Execute(TaskLane::FLUSH, [&finished] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        finished.set_value();
+    }));
+    finished.get_future().wait();
+    // the finish is counted after the task returns.
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    auto after = PreferencesTaskProcessor::GetLaneStats(TaskLane::FLUSH);
+    EXPECT_EQ(after.finishCount, before.finishCount + 1);
+    EXPECT_GE(after.totalRunTime - before.totalRunTime, 20000);
+    EXPECT_GE(after.maxRunTime, 20000);
+    // 20 milliseconds fall in the bucket from 10 to 100 milliseconds.
+    EXPECT_EQ(after.runTimeHistogram[3], before.runTimeHistogram[3] + 1);
+    uint64_t waitCount = 0;
+    for (size_t i = 0; i < LATENCY_BUCKET_NUM; i++) {
+        waitCount += after.waitTimeHistogram[i] - before.waitTimeHistogram[i];
+    }
+    EXPECT_EQ(waitCount, 1);
+
+    ExecutorPool pool(2, 0);
+    std::promise<std::pair<size_t, size_t>> running;
+    pool.Schedule(std::chrono::milliseconds(30), [&pool, &running] {
+        running.set_value({ Executor::GetLiveNum(), pool.GetStats().executorNum });
+    });
+    auto [liveNum, executorNum] = running.get_future().get();
+    EXPECT_GE(liveNum, 1);
+    EXPECT_GE(executorNum, 1);
+    EXPECT_GE(pool.GetStats().schedulerWakeupCount, 1);
+
+    PreferencesTaskProcessor::SetStatsDumpInterval(std::chrono::milliseconds(10));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    PreferencesTaskProcessor::SetStatsDumpInterval(std::chrono::milliseconds(0));
+}
+
+/**
+ * @tc.name: NativePreferencesTaskPoolStatsTest_001
+ * @tc.desc: normal testcase of the stats of the pools run apart from the lanes
+ * @tc.type: FUNC
+ */
+HWTEST_F(PreferencesHelperExecutorPoolTest, NativePreferencesTaskPoolStatsTest_001, TestSize.Level1)
+{
+    int errCode = E_OK;
+    std::string path = "/data/test/task_pool_stats_test_001";
+    auto preferences = PreferencesHelper::GetPreferences(path, errCode);
+    ASSERT_NE(preferences, nullptr);
+    EXPECT_EQ(preferences->PutInt("key", 1), E_OK);
+    // FlushAll flushes the dirty instances on the flush pool.
+    std::vector<std::string> unflushedPaths;
+    EXPECT_EQ(PreferencesHelper::FlushAll(std::chrono::milliseconds(5000), unflushedPaths), E_OK);
+
+    std::map<std::string, TaskPoolStats> poolStats;
+    for (const auto &stats : PreferencesTaskProcessor::GetPoolStats()) {
+        poolStats[stats.name] = stats;
+    }
+    ASSERT_EQ(poolStats.count("PreferencesFlushPool"), 1);
+    EXPECT_GE(poolStats["PreferencesFlushPool"].executorNum, 1);
+    EXPECT_EQ(poolStats["PreferencesFlushPool"].queuedTaskNum, 0);
+    EXPECT_EQ(poolStats.count("PreferencesPreloadPool"), 1);
+    EXPECT_FALSE(PreferencesTaskProcessor::RegisterPoolStats("PreferencesNullPool", nullptr));
+    PreferencesTaskProcessor::DumpStats();
+
+    preferences = nullptr;
+    PreferencesHelper::DeletePreferences(path);
+}
+
+/**
+ * @tc.name: NativeExecutorPoolWorkStealingTest_001
+ * @tc.desc: normal testcase of Execute, Schedule and Remove with the work stealing backend
+ * @tc.type: FUNC
+ */
+HWTEST_F(PreferencesHelperExecutorPoolTest, NativeExecutorPoolWorkStealingTest_001, TestSize.Level1)
+{
+    ExecutorPool pool(4, 0, ExecutorPool::Backend::WORK_STEALING);
+    constexpr int taskNum = 100;
+    std::atomic<int> count = 0;
+    std::promise<void> finished;
+    for (int i = 0; i < taskNum; i++) {
+        // the tasks submitted by the tasks go to the deque of their worker.
+        auto taskId = pool.Execute([&pool, &count, &finished] {
+            pool.Execute([&count, &finished] {
+                if (++count == taskNum) {
+                    finished.set_value();
+                }
+            });
+        });
+        EXPECT_NE(taskId, ExecutorPool::INVALID_TASK_ID);
+    }
+    finished.get_future().wait();
+    EXPECT_EQ(count, taskNum);
+    EXPECT_GE(pool.GetStats().executorNum, 4);
+
+    std::atomic<bool> isRemovedRun = false;
+    auto removedId = pool.Schedule(std::chrono::milliseconds(100), [&isRemovedRun] { isRemovedRun = true; });
+    EXPECT_TRUE(pool.Remove(removedId));
+    std::promise<void> scheduled;
+    auto begin = std::chrono::steady_clock::now();
+    pool.Schedule(std::chrono::milliseconds(50), [&scheduled] { scheduled.set_value(); });
+    scheduled.get_future().wait();
+    EXPECT_GE(std::chrono::steady_clock::now() - begin, std::chrono::milliseconds(50));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_FALSE(isRemovedRun);
+}
+
+/**
+ * @tc.name: NativeExecutorPoolWorkStealingTest_002
+ * @tc.desc: normal testcase of short tasks submitted from several threads, each task runs once with both backends
+ * @tc.type: FUNC
+ */
+HWTEST_F(PreferencesHelperExecutorPoolTest, NativeExecutorPoolWorkStealingTest_002, TestSize.Level1)
+{
+    constexpr int submitterNum = 2;
+    constexpr int taskNumPerSubmitter = 10000;
+    for (auto backend : { ExecutorPool::Backend::PRIORITY_QUEUE, ExecutorPool::Backend::WORK_STEALING }) {
+        ExecutorPool pool(4, 0, backend);
+        auto runTimes = RunShortTasks(pool, submitterNum, taskNumPerSubmitter);
+        EXPECT_EQ(std::count(runTimes.begin(), runTimes.end(), 1), submitterNum * taskNumPerSubmitter);
+        auto stats = pool.GetStats();
+        EXPECT_EQ(stats.queuedTaskNum, 0);
+        EXPECT_GE(stats.executorNum, 1);
+    }
+}
+
+/**
+ * @tc.name: NativeTimerWheelTest_001
+ * @tc.desc: normal testcase of the timer wheel, the tasks are popped in time across the levels and the far list
+ * @tc.type: FUNC
+ */
+HWTEST_F(PreferencesHelperExecutorPoolTest, NativeTimerWheelTest_001, TestSize.Level1)
+{
+    using InnerTask = Executor::InnerTask;
+    using Time = Executor::Time;
+    // with ticks of 1 ms the first level holds 64 ms, the delays of the tasks below reach the second level.
+    TimerWheel<InnerTask, Time, Executor::TaskId> wheel(InnerTask(), nullptr, std::chrono::milliseconds(1));
+    constexpr int taskNum = 200;
+    auto now = std::chrono::steady_clock::now();
+    std::map<Executor::TaskId, Time> dueTimes;
+    for (int i = 1; i <= taskNum; i++) {
+        InnerTask task;
+        task.taskId = i;
+        auto dueTime = now + std::chrono::milliseconds((i * 37) % 150);
+        EXPECT_TRUE(wheel.Push(task, task.taskId, dueTime));
+        dueTimes[task.taskId] = dueTime;
+    }
+    InnerTask farTask;
+    farTask.taskId = taskNum + 1;
+    EXPECT_TRUE(wheel.Push(farTask, farTask.taskId, now + std::chrono::seconds(600)));
+    for (int i = 2; i <= taskNum; i += 2) {
+        EXPECT_TRUE(wheel.Remove(i, false));
+        dueTimes.erase(i);
+    }
+    EXPECT_FALSE(wheel.Remove(taskNum + 2, false));
+    EXPECT_EQ(wheel.Size(), dueTimes.size() + 1);
+
+    // moving the far task close, it is popped after the others.
+    EXPECT_TRUE(wheel.Update(farTask.taskId, [now](InnerTask &) {
+        return std::pair{ true, now + std::chrono::milliseconds(200) };
+    }));
+    dueTimes[farTask.taskId] = now + std::chrono::milliseconds(200);
+    while (wheel.Size() > 0) {
+        auto task = wheel.Pop();
+        ASSERT_TRUE(task.Valid());
+        auto it = dueTimes.find(task.taskId);
+        ASSERT_NE(it, dueTimes.end());
+        EXPECT_GE(std::chrono::steady_clock::now(), it->second);
+        EXPECT_LT(std::chrono::steady_clock::now() - it->second, std::chrono::milliseconds(50));
+        dueTimes.erase(it);
+        wheel.Finish(task.taskId);
+    }
+    EXPECT_TRUE(dueTimes.empty());
+}
 }
@@ -17,14 +17,22 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
 #include <cctype>
+#include <chrono>
+#include <cstdio>
 #include <iostream>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
 #include "log_print.h"
 #include "preferences.h"
 #include "preferences_errno.h"
 #include "preferences_observer.h"
+#include "preferences_prefetch_manifest.h"
+#include "preferences_xml_utils.h"
 
 using namespace testing::ext;
 using namespace OHOS::NativePreferences;
@@ -54,6 +62,16 @@ void PreferencesHelperTest::TearDown(void)
 {
 }
 
+class CountingObserver : public PreferencesObserver {
+public:
+    void OnChange(const std::string &key) override
+    {
+        changeCount++;
+    }
+
+    std::atomic<int> changeCount = 0;
+};
+
 /**
  * @tc.name: NativePreferencesHelperTest_001
  * @tc.desc: normal testcase of DeletePreferences
@@ -294,4 +312,302 @@ HWTEST_F(PreferencesHelperTest, NativePreferencesHelperFfrtTest_001, TestSize.Le
     ret = PreferencesHelper::DeletePreferences(path);
     EXPECT_EQ(ret, E_OK);
 }
+
+/**
+ * @tc.name: NativePreferencesHelperFlushAll_001
+ * @tc.desc: normal testcase of FlushAll
+ * @tc.type: FUNC
+ */
+HWTEST_F(PreferencesHelperTest, NativePreferencesHelperFlushAll_001, TestSize.Level0)
+{
+    int errCode = E_OK;
+    const int prefNum = 6;
+    std::vector<std::string> paths;
+    for (int i = 0; i < prefNum; i++) {
+        std::string path = "/data/test/flush_all_" + std::to_string(i);
+        std::shared_ptr<Preferences> pref = PreferencesHelper::GetPreferences(path, errCode);
+        EXPECT_EQ(errCode, E_OK);
+        ASSERT_NE(pref, nullptr);
+        pref->PutInt("key", i);
+        paths.push_back(path);
+    }
+
+    std::vector<std::string> unflushedPaths;
+    int ret = PreferencesHelper::FlushAll(std::chrono::milliseconds(5000), unflushedPaths);
+    EXPECT_EQ(ret, E_OK);
+    EXPECT_TRUE(unflushedPaths.empty());
+
+    for (int i = 0; i < prefNum; i++) {
+        ret = PreferencesHelper::RemovePreferencesFromCache(paths[i]);
+        EXPECT_EQ(ret, E_OK);
+        std::shared_ptr<Preferences> pref = PreferencesHelper::GetPreferences(paths[i], errCode);
+        ASSERT_NE(pref, nullptr);
+        EXPECT_EQ(pref->GetInt("key", -1), i);
+    }
+
+    ret = PreferencesHelper::FlushAll(std::chrono::milliseconds(0), unflushedPaths);
+    EXPECT_EQ(ret, E_OK);
+    for (auto &path : paths) {
+        PreferencesHelper::DeletePreferences(path);
+    }
+}
+
+/**
+ * @tc.name: NativePreferencesHelperFlushAll_002
+ * @tc.desc: normal testcase of FlushAll while a delayed flush is pending, the data is on disk when it returns
+ * @tc.type: FUNC
+ */
+HWTEST_F(PreferencesHelperTest, NativePreferencesHelperFlushAll_002, TestSize.Level0)
+{
+    int errCode = E_OK;
+    std::string path = "/data/test/flush_all_pending";
+    std::shared_ptr<Preferences> pref = PreferencesHelper::GetPreferences(path, errCode);
+    ASSERT_NE(pref, nullptr);
+    EXPECT_EQ(pref->PutInt("key", 1), E_OK);
+    EXPECT_EQ(pref->FlushSync(), E_OK);
+    EXPECT_EQ(pref->PutInt("key", 2), E_OK);
+    // the delayed flush holds its token until it runs, FlushAll writes the data anyway.
+    pref->Flush();
+
+    std::vector<std::string> unflushedPaths;
+    EXPECT_EQ(PreferencesHelper::FlushAll(std::chrono::milliseconds(5000), unflushedPaths), E_OK);
+    EXPECT_TRUE(unflushedPaths.empty());
+    std::unordered_map<std::string, PreferencesValue> datas;
+    EXPECT_TRUE(PreferencesXmlUtils::ReadSettingXml(path, "", datas));
+    ASSERT_NE(datas.find("key"), datas.end());
+    EXPECT_EQ(static_cast<int>(datas["key"]), 2);
+
+    pref = nullptr;
+    EXPECT_EQ(PreferencesHelper::DeletePreferences(path), E_OK);
+}
+
+/**
+ * @tc.name: NativePreferencesHelperParallelOpen_001
+ * @tc.desc: normal testcase of GetPreferences from many threads, the calls of a file share one open and one
+ *           instance, the calls of different files open each of them once
+ * @tc.type: FUNC
+ */
+HWTEST_F(PreferencesHelperTest, NativePreferencesHelperParallelOpen_001, TestSize.Level1)
+{
+    constexpr int threadNum = 8;
+    constexpr int prefNum = 64;
+    std::vector<std::shared_ptr<Preferences>> prefs(threadNum);
+    std::vector<std::thread> threads;
+    auto openCount = PreferencesHelper::GetCacheStats().openCount;
+    for (int i = 0; i < threadNum; i++) {
+        threads.emplace_back([&prefs, i] {
+            int errCode = E_OK;
+            prefs[i] = PreferencesHelper::GetPreferences("/data/test/parallel_open_same", errCode);
+            EXPECT_EQ(errCode, E_OK);
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    threads.clear();
+    EXPECT_EQ(PreferencesHelper::GetCacheStats().openCount, openCount + 1);
+    for (int i = 0; i < threadNum; i++) {
+        ASSERT_NE(prefs[i], nullptr);
+        EXPECT_EQ(prefs[i], prefs[0]);
+    }
+    prefs.clear();
+    EXPECT_EQ(PreferencesHelper::DeletePreferences("/data/test/parallel_open_same"), E_OK);
+
+    // half of the threads open the even files and half the odd ones, each file by several threads at once.
+    auto openAll = [](int start, int step) {
+        for (int i = start; i < prefNum; i += step) {
+            int errCode = E_OK;
+            auto pref = PreferencesHelper::GetPreferences("/data/test/parallel_open_" + std::to_string(i), errCode);
+            EXPECT_EQ(errCode, E_OK);
+            EXPECT_NE(pref, nullptr);
+        }
+    };
+    openCount = PreferencesHelper::GetCacheStats().openCount;
+    for (int i = 0; i < threadNum; i++) {
+        threads.emplace_back(openAll, i % 2, 2);
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(PreferencesHelper::GetCacheStats().openCount, openCount + prefNum);
+    for (int i = 0; i < prefNum; i++) {
+        EXPECT_EQ(PreferencesHelper::DeletePreferences("/data/test/parallel_open_" + std::to_string(i)), E_OK);
+    }
+}
+
+/**
+ * @tc.name: NativePreferencesHelperCacheBudget_001
+ * @tc.desc: normal testcase of SetCacheMemoryBudget, the idle instances are evicted and reopened on demand
+ * @tc.type: FUNC
+ */
+HWTEST_F(PreferencesHelperTest, NativePreferencesHelperCacheBudget_001, TestSize.Level1)
+{
+    constexpr int prefNum = 4;
+    EXPECT_NE(PreferencesHelper::SetCacheMemoryBudget(-1), E_OK);
+    auto path = [](int i) { return "/data/test/cache_budget_" + std::to_string(i); };
+    int errCode = E_OK;
+    std::shared_ptr<Preferences> busyPref = PreferencesHelper::GetPreferences(path(0), errCode);
+    ASSERT_NE(busyPref, nullptr);
+    EXPECT_EQ(busyPref->PutString("key", std::string(1024, 'a')), E_OK);
+    EXPECT_EQ(busyPref->FlushSync(), E_OK);
+    for (int i = 1; i < prefNum; i++) {
+        std::shared_ptr<Preferences> pref = PreferencesHelper::GetPreferences(path(i), errCode);
+        ASSERT_NE(pref, nullptr);
+        EXPECT_EQ(pref->PutInt("key", i), E_OK);
+        EXPECT_EQ(pref->FlushSync(), E_OK);
+    }
+
+    auto stats = PreferencesHelper::GetCacheStats();
+    ASSERT_EQ(PreferencesHelper::SetCacheMemoryBudget(1), E_OK);
+    for (int i = 0; i < 100 && PreferencesHelper::GetCacheStats().evictCount < stats.evictCount + prefNum - 1; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_GE(PreferencesHelper::GetCacheStats().evictCount, stats.evictCount + prefNum - 1);
+    ASSERT_EQ(PreferencesHelper::SetCacheMemoryBudget(0), E_OK);
+
+    // the referenced instance is kept, the evicted ones are reopened with their data.
+    EXPECT_EQ(PreferencesHelper::GetPreferences(path(0), errCode), busyPref);
+    for (int i = 1; i < prefNum; i++) {
+        std::shared_ptr<Preferences> pref = PreferencesHelper::GetPreferences(path(i), errCode);
+        ASSERT_NE(pref, nullptr);
+        EXPECT_EQ(pref->GetInt("key", -1), i);
+    }
+    EXPECT_GE(PreferencesHelper::GetCacheStats().reloadCount, stats.reloadCount + prefNum - 1);
+    busyPref = nullptr;
+    for (int i = 0; i < prefNum; i++) {
+        EXPECT_EQ(PreferencesHelper::DeletePreferences(path(i)), E_OK);
+    }
+}
+
+/**
+ * @tc.name: NativePreferencesHelperCacheBudget_002
+ * @tc.desc: normal testcase of SetCacheMemoryBudget, an idle instance with an observer is kept in the cache
+ * @tc.type: FUNC
+ */
+HWTEST_F(PreferencesHelperTest, NativePreferencesHelperCacheBudget_002, TestSize.Level1)
+{
+    std::string observedPath = "/data/test/cache_budget_observed";
+    std::string idlePath = "/data/test/cache_budget_idle";
+    int errCode = E_OK;
+    auto observer = std::make_shared<CountingObserver>();
+    std::weak_ptr<Preferences> observedPref;
+    {
+        auto pref = PreferencesHelper::GetPreferences(observedPath, errCode);
+        ASSERT_NE(pref, nullptr);
+        EXPECT_EQ(pref->RegisterObserver(observer), E_OK);
+        EXPECT_EQ(pref->PutInt("key", 1), E_OK);
+        EXPECT_EQ(pref->FlushSync(), E_OK);
+        observedPref = pref;
+        pref = PreferencesHelper::GetPreferences(idlePath, errCode);
+        ASSERT_NE(pref, nullptr);
+        EXPECT_EQ(pref->PutInt("key", 1), E_OK);
+        EXPECT_EQ(pref->FlushSync(), E_OK);
+    }
+    int changeCount = observer->changeCount.load();
+
+    auto stats = PreferencesHelper::GetCacheStats();
+    ASSERT_EQ(PreferencesHelper::SetCacheMemoryBudget(1), E_OK);
+    for (int i = 0; i < 100 && PreferencesHelper::GetCacheStats().evictCount < stats.evictCount + 1; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_GE(PreferencesHelper::GetCacheStats().evictCount, stats.evictCount + 1);
+    ASSERT_EQ(PreferencesHelper::SetCacheMemoryBudget(0), E_OK);
+
+    // the observed instance is the cached one, its observer still sees the changes.
+    auto pref = PreferencesHelper::GetPreferences(observedPath, errCode);
+    ASSERT_NE(pref, nullptr);
+    EXPECT_EQ(pref, observedPref.lock());
+    EXPECT_EQ(pref->PutInt("key", 2), E_OK);
+    EXPECT_EQ(pref->FlushSync(), E_OK);
+    EXPECT_EQ(observer->changeCount.load(), changeCount + 1);
+    EXPECT_EQ(pref->UnRegisterObserver(observer), E_OK);
+    pref = nullptr;
+    EXPECT_EQ(PreferencesHelper::DeletePreferences(observedPath), E_OK);
+    EXPECT_EQ(PreferencesHelper::DeletePreferences(idlePath), E_OK);
+}
+
+/**
+ * @tc.name: NativePreferencesHelperPreload_001
+ * @tc.desc: normal testcase of Preload, the GetPreferences calls made after it share its opens
+ * @tc.type: FUNC
+ */
+HWTEST_F(PreferencesHelperTest, NativePreferencesHelperPreload_001, TestSize.Level1)
+{
+    constexpr int prefNum = 15;
+    constexpr int keyNum = 200;
+    std::vector<Options> options;
+    int errCode = E_OK;
+    for (int i = 0; i < prefNum; i++) {
+        options.emplace_back("/data/test/preload_" + std::to_string(i));
+        std::shared_ptr<Preferences> pref = PreferencesHelper::GetPreferences(options.back(), errCode);
+        ASSERT_NE(pref, nullptr);
+        for (int j = 0; j < keyNum; j++) {
+            pref->PutString("key_" + std::to_string(j), std::string(64, 'a' + (j % 26)));
+        }
+        EXPECT_EQ(pref->FlushSync(), E_OK);
+        EXPECT_EQ(PreferencesHelper::RemovePreferencesFromCache(options.back().filePath), E_OK);
+    }
+
+    // the opens are registered when Preload returns, the calls right after it do not open the files again.
+    auto openCount = PreferencesHelper::GetCacheStats().openCount;
+    EXPECT_EQ(PreferencesHelper::Preload(options), E_OK);
+    for (int i = 0; i < prefNum; i++) {
+        std::shared_ptr<Preferences> pref = PreferencesHelper::GetPreferences(options[i], errCode);
+        ASSERT_NE(pref, nullptr);
+        EXPECT_EQ(pref->GetString("key_0", ""), std::string(64, 'a'));
+    }
+    EXPECT_EQ(PreferencesHelper::GetCacheStats().openCount, openCount + prefNum);
+
+    // the files are cached already, preloading them again opens nothing.
+    EXPECT_EQ(PreferencesHelper::Preload(options), E_OK);
+    std::vector<Options> invalidOptions = { Options("relative_path"), options[0] };
+    EXPECT_EQ(PreferencesHelper::Preload(invalidOptions), E_RELATIVE_PATH);
+    EXPECT_EQ(PreferencesHelper::GetCacheStats().openCount, openCount + prefNum);
+    for (int i = 0; i < prefNum; i++) {
+        EXPECT_EQ(PreferencesHelper::DeletePreferences(options[i].filePath), E_OK);
+    }
+}
+
+/**
+ * @tc.name: NativePreferencesHelperPrefetchManifest_001
+ * @tc.desc: normal testcase of StartPrefetchManifest, the files opened during the recording are saved
+ * @tc.type: FUNC
+ */
+HWTEST_F(PreferencesHelperTest, NativePreferencesHelperPrefetchManifest_001, TestSize.Level1)
+{
+    std::string manifestPath = "/data/test/prefetch_manifest";
+    std::remove(manifestPath.c_str());
+    std::vector<PreferencesPrefetchManifest::Entry> entries;
+    EXPECT_NE(PreferencesPrefetchManifest::Load(manifestPath, entries), E_OK);
+
+    ASSERT_EQ(PreferencesHelper::StartPrefetchManifest(manifestPath, std::chrono::milliseconds(100)), E_OK);
+    int errCode = E_OK;
+    for (int i = 0; i < 3; i++) {
+        std::shared_ptr<Preferences> pref =
+            PreferencesHelper::GetPreferences("/data/test/prefetch_" + std::to_string(i), errCode);
+        ASSERT_NE(pref, nullptr);
+    }
+    PreferencesHelper::GetPreferences("/data/test/prefetch_0", errCode);
+    for (int i = 0; i < 100 && PreferencesPrefetchManifest::Load(manifestPath, entries) != E_OK; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(entries.size(), 3);
+    EXPECT_EQ(entries[0].options.filePath, "/data/test/prefetch_0");
+    EXPECT_EQ(entries[2].options.filePath, "/data/test/prefetch_2");
+    EXPECT_FALSE(entries[0].options.isEnhance);
+
+    // the keys may hold any byte
+    entries[1].keys = { "key", std::string("a\tb\nc\0d", 7) };
+    ASSERT_EQ(PreferencesPrefetchManifest::Save(manifestPath, entries), E_OK);
+    std::vector<PreferencesPrefetchManifest::Entry> loadedEntries;
+    ASSERT_EQ(PreferencesPrefetchManifest::Load(manifestPath, loadedEntries), E_OK);
+    ASSERT_EQ(loadedEntries.size(), 3);
+    EXPECT_EQ(loadedEntries[1].keys, entries[1].keys);
+    EXPECT_TRUE(loadedEntries[2].keys.empty());
+
+    std::remove(manifestPath.c_str());
+    for (int i = 0; i < 3; i++) {
+        EXPECT_EQ(PreferencesHelper::DeletePreferences("/data/test/prefetch_" + std::to_string(i)), E_OK);
+    }
+}
 }
@@ -12,17 +12,25 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <algorithm>
+#include <atomic>
 #include <cctype>
+#include <chrono>
 #include <condition_variable>
 #include <cstdint>
+#include <cstring>
 #include <iostream>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include <gtest/gtest.h>
 #include "log_print.h"
 #include "preferences.h"
+#include "preferences_enhance_impl.h"
 #include "preferences_errno.h"
 #include "preferences_file_operation.h"
 #include "preferences_helper.h"
@@ -610,4 +618,515 @@ HWTEST_F(PreferencesStorageTypeTest, StorageTypeApiTest013, TestSize.Level0)
     }
 }
 
+/**
+ * @tc.name: StorageTypeApiTest014
+ * @tc.desc: api test, concurrent reads in GSKV mode from 1 to 8 threads all read the values written
+ * @tc.type: FUNC
+ */
+HWTEST_F(PreferencesStorageTypeTest, StorageTypeApiTest014, TestSize.Level1)
+{
+    bool isEnhance = PreferencesHelper::IsStorageTypeSupported(StorageType::GSKV);
+    if (!isEnhance) {
+        return;
+    }
+    int errCode = E_OK;
+    std::string filePath = "/data/test/Test014";
+    Options option = Options(filePath, "", "", true);
+    std::shared_ptr<Preferences> pref = PreferencesHelper::GetPreferences(option, errCode);
+    ASSERT_EQ(errCode, E_OK);
+    constexpr int keyNum = 100;
+    constexpr int readTimes = 2000;
+    for (int i = 0; i < keyNum; i++) {
+        ASSERT_EQ(pref->PutString("test014_key_" + std::to_string(i), "test014_value_" + std::to_string(i)), E_OK);
+    }
+    // a large value goes through the cache of the large values
+    std::string largeValue(600 * 1024, 'a');
+    ASSERT_EQ(pref->PutString("test014_large", largeValue), E_OK);
+
+    for (int threadNum = 1; threadNum <= 8; threadNum *= 2) {
+        std::atomic<int> mismatchNum = 0;
+        std::vector<std::thread> threads;
+        for (int t = 0; t < threadNum; t++) {
+            threads.emplace_back([&pref, &mismatchNum, &largeValue, t]() {
+                for (int i = 0; i < readTimes; i++) {
+                    int index = (i + t) % keyNum;
+                    std::string expValue = "test014_value_" + std::to_string(index);
+                    if (pref->GetString("test014_key_" + std::to_string(index), "def") != expValue) {
+                        mismatchNum++;
+                    }
+                    if (i % keyNum == 0 && pref->GetString("test014_large", "def") != largeValue) {
+                        mismatchNum++;
+                    }
+                }
+            });
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+        EXPECT_EQ(mismatchNum, 0);
+    }
+    ASSERT_EQ(PreferencesHelper::RemovePreferencesFromCache(filePath), E_OK);
+    ASSERT_EQ(PreferencesHelper::DeletePreferences(filePath), E_OK);
+}
+
+/**
+ * @tc.name: StorageTypeApiTest015
+ * @tc.desc: api test, the reads in GSKV mode check the data version each time without an interval, and once per
+ *           interval with one
+ * @tc.type: FUNC
+ */
+HWTEST_F(PreferencesStorageTypeTest, StorageTypeApiTest015, TestSize.Level1)
+{
+    bool isEnhance = PreferencesHelper::IsStorageTypeSupported(StorageType::GSKV);
+    if (!isEnhance) {
+        return;
+    }
+    int errCode = E_OK;
+    std::string filePath = "/data/test/Test015";
+    Options option = Options(filePath, "", "", true);
+    std::shared_ptr<Preferences> pref = PreferencesHelper::GetPreferences(option, errCode);
+    ASSERT_EQ(errCode, E_OK);
+    ASSERT_EQ(pref->PutString("test015_key", "test015_value"), E_OK);
+
+    constexpr int readTimes = 1000;
+    auto enhancePref = std::static_pointer_cast<PreferencesEnhanceImpl>(pref);
+    auto originInterval = PreferencesEnhanceImpl::GetVersionCheckInterval();
+    PreferencesEnhanceImpl::SetVersionCheckInterval(std::chrono::microseconds(0));
+    auto checkCount = enhancePref->GetVersionCheckCount();
+    for (int i = 0; i < readTimes; i++) {
+        EXPECT_EQ(pref->GetString("test015_key", "def"), "test015_value");
+    }
+    EXPECT_GE(enhancePref->GetVersionCheckCount() - checkCount, readTimes);
+
+    // within the interval the reads reuse the version checked, the build of the key filter may check it too.
+    PreferencesEnhanceImpl::SetVersionCheckInterval(std::chrono::seconds(10));
+    checkCount = enhancePref->GetVersionCheckCount();
+    for (int i = 0; i < readTimes; i++) {
+        EXPECT_EQ(pref->GetString("test015_key", "def"), "test015_value");
+    }
+    EXPECT_LE(enhancePref->GetVersionCheckCount() - checkCount, 2);
+
+    // the writes of this process are seen at once whatever the interval
+    ASSERT_EQ(pref->PutString("test015_key", "test015_value2"), E_OK);
+    EXPECT_EQ(pref->GetString("test015_key", "def"), "test015_value2");
+    ASSERT_EQ(pref->Delete("test015_key"), E_OK);
+    EXPECT_EQ(pref->GetString("test015_key", "def"), "def");
+    PreferencesEnhanceImpl::SetVersionCheckInterval(originInterval);
+    ASSERT_EQ(PreferencesHelper::RemovePreferencesFromCache(filePath), E_OK);
+    ASSERT_EQ(PreferencesHelper::DeletePreferences(filePath), E_OK);
+}
+
+/**
+ * @tc.name: StorageTypeApiTest016
+ * @tc.desc: api test, iterate over all the keys and values in GSKV mode, reading and writing while iterating
+ * @tc.type: FUNC
+ */
+HWTEST_F(PreferencesStorageTypeTest, StorageTypeApiTest016, TestSize.Level0)
+{
+    bool isEnhance = PreferencesHelper::IsStorageTypeSupported(StorageType::GSKV);
+    if (!isEnhance) {
+        return;
+    }
+    int errCode = E_OK;
+    std::string filePath = "/data/test/Test016";
+    Options option = Options(filePath, "", "", true);
+    std::shared_ptr<Preferences> pref = PreferencesHelper::GetPreferences(option, errCode);
+    ASSERT_EQ(errCode, E_OK);
+    for (int i = 0; i < 100; i++) {
+        ASSERT_EQ(pref->PutString("test016_key_" + std::to_string(i), "test016_value_" + std::to_string(i)), E_OK);
+    }
+    auto enhancePref = std::static_pointer_cast<PreferencesEnhanceImpl>(pref);
+    {
+        // the values are decoded from the cursor, the value cache is neither read nor filled.
+        auto stats = enhancePref->GetValueCacheStats();
+        auto [ret, iterator] = pref->CreateIterator();
+        ASSERT_EQ(ret, E_OK);
+        ASSERT_NE(iterator, nullptr);
+        std::string key;
+        PreferencesValue value;
+        int count = 0;
+        while ((ret = iterator->Next(key, value)) == E_OK) {
+            EXPECT_EQ(static_cast<std::string>(value), "test016_value_" + key.substr(strlen("test016_key_")));
+            count++;
+        }
+        EXPECT_EQ(ret, E_NO_DATA);
+        EXPECT_EQ(count, 100);
+        auto after = enhancePref->GetValueCacheStats();
+        EXPECT_EQ(after.hitCount, stats.hitCount);
+        EXPECT_EQ(after.missCount, stats.missCount);
+        EXPECT_EQ(after.entryCount, stats.entryCount);
+    }
+    {
+        auto [ret, iterator] = pref->CreateIterator();
+        ASSERT_EQ(ret, E_OK);
+        ASSERT_NE(iterator, nullptr);
+        std::string key;
+        PreferencesValue value;
+        int count = 0;
+        while ((ret = iterator->Next(key, value)) == E_OK) {
+            EXPECT_EQ(static_cast<std::string>(value), "test016_value_" + key.substr(strlen("test016_key_")));
+            // the iterator holds no lock between the calls, the same thread can read and write the preferences.
+            EXPECT_EQ(pref->GetString(key, ""), static_cast<std::string>(value));
+            // a key added since the creation may be returned, once.
+            if (key == "test016_key_new") {
+                continue;
+            }
+            if (count == 0) {
+                ASSERT_EQ(pref->PutString("test016_key_new", "test016_value_new"), E_OK);
+            }
+            count++;
+        }
+        EXPECT_EQ(ret, E_NO_DATA);
+        EXPECT_EQ(count, 100);
+    }
+    ASSERT_EQ(pref->Clear(), E_OK);
+    EXPECT_EQ(pref->GetAll().size(), 0);
+    ASSERT_EQ(PreferencesHelper::RemovePreferencesFromCache(filePath), E_OK);
+    ASSERT_EQ(PreferencesHelper::DeletePreferences(filePath), E_OK);
+}
+
+/**
+ * @tc.name: StorageTypeApiTest017
+ * @tc.desc: api test, the lookups of absent keys in GSKV mode are answered by the key filter, which the writes of
+ *           this process keep
+ * @tc.type: FUNC
+ */
+HWTEST_F(PreferencesStorageTypeTest, StorageTypeApiTest017, TestSize.Level1)
+{
+    bool isEnhance = PreferencesHelper::IsStorageTypeSupported(StorageType::GSKV);
+    if (!isEnhance) {
+        return;
+    }
+    // without the value cache every lookup which the filter does not answer goes to the db
+    auto originCapacity = PreferencesEnhanceImpl::GetValueCacheCapacity();
+    PreferencesEnhanceImpl::SetValueCacheCapacity(0);
+    int errCode = E_OK;
+    std::string filePath = "/data/test/Test017";
+    Options option = Options(filePath, "", "", true);
+    std::shared_ptr<Preferences> pref = PreferencesHelper::GetPreferences(option, errCode);
+    ASSERT_EQ(errCode, E_OK);
+    constexpr int keyNum = 1000;
+    constexpr int readTimes = 1000;
+    for (int i = 0; i < keyNum; i++) {
+        ASSERT_EQ(pref->PutInt("test017_key_" + std::to_string(i), i), E_OK);
+    }
+    ASSERT_EQ(PreferencesHelper::RemovePreferencesFromCache(filePath), E_OK);
+    pref = PreferencesHelper::GetPreferences(option, errCode);
+    ASSERT_EQ(errCode, E_OK);
+    auto enhancePref = std::static_pointer_cast<PreferencesEnhanceImpl>(pref);
+
+    // the filter is built in the background after the open
+    for (int i = 0; i < 100 && enhancePref->GetKeyFilterHitCount() == 0; i++) {
+        EXPECT_FALSE(pref->HasKey("test017_wait_" + std::to_string(i)));
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    auto hitCount = enhancePref->GetKeyFilterHitCount();
+    ASSERT_GT(hitCount, 0);
+    for (int i = 0; i < readTimes; i++) {
+        EXPECT_FALSE(pref->HasKey("test017_absent_" + std::to_string(i)));
+        EXPECT_EQ(pref->GetInt("test017_absent_" + std::to_string(i), -1), -1);
+    }
+    // a few false positives of the filter go to the db
+    EXPECT_GE(enhancePref->GetKeyFilterHitCount() - hitCount, readTimes * 2 * 9 / 10);
+    hitCount = enhancePref->GetKeyFilterHitCount();
+    for (int i = 0; i < readTimes; i++) {
+        EXPECT_TRUE(pref->HasKey("test017_key_" + std::to_string(i % keyNum)));
+    }
+    EXPECT_EQ(enhancePref->GetKeyFilterHitCount(), hitCount);
+
+    // the writes of this process keep the filter
+    ASSERT_EQ(pref->PutInt("test017_new", 1), E_OK);
+    EXPECT_TRUE(pref->HasKey("test017_new"));
+    EXPECT_EQ(pref->GetInt("test017_new", -1), 1);
+    ASSERT_EQ(pref->Delete("test017_key_0"), E_OK);
+    EXPECT_FALSE(pref->HasKey("test017_key_0"));
+    hitCount = enhancePref->GetKeyFilterHitCount();
+    for (int i = 0; i < readTimes; i++) {
+        EXPECT_FALSE(pref->HasKey("test017_absent_" + std::to_string(i)));
+    }
+    EXPECT_GE(enhancePref->GetKeyFilterHitCount() - hitCount, readTimes * 9 / 10);
+    ASSERT_EQ(pref->Clear(), E_OK);
+    EXPECT_FALSE(pref->HasKey("test017_key_1"));
+    ASSERT_EQ(pref->PutInt("test017_key_1", 1), E_OK);
+    EXPECT_TRUE(pref->HasKey("test017_key_1"));
+    hitCount = enhancePref->GetKeyFilterHitCount();
+    for (int i = 0; i < readTimes; i++) {
+        EXPECT_FALSE(pref->HasKey("test017_absent_" + std::to_string(i)));
+    }
+    EXPECT_GE(enhancePref->GetKeyFilterHitCount() - hitCount, readTimes * 9 / 10);
+    PreferencesEnhanceImpl::SetValueCacheCapacity(originCapacity);
+    ASSERT_EQ(PreferencesHelper::RemovePreferencesFromCache(filePath), E_OK);
+    ASSERT_EQ(PreferencesHelper::DeletePreferences(filePath), E_OK);
+}
+
+class FlushObserver : public PreferencesObserver {
+public:
+    void OnChange(const std::string &key) override
+    {
+    }
+
+    void OnChange(const std::map<std::string, PreferencesValue> &records) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        records_.push_back(records);
+        cond_.notify_all();
+    }
+
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    std::vector<std::map<std::string, PreferencesValue>> records_;
+};
+
+/**
+ * @tc.name: StorageTypeApiTest018
+ * @tc.desc: api test, the reads see the buffered writes in GSKV mode, which are in the db after FlushSync and
+ *           notified once they are
+ * @tc.type: FUNC
+ */
+HWTEST_F(PreferencesStorageTypeTest, StorageTypeApiTest018, TestSize.Level1)
+{
+    bool isEnhance = PreferencesHelper::IsStorageTypeSupported(StorageType::GSKV);
+    if (!isEnhance) {
+        return;
+    }
+    constexpr int keyNum = 1000;
+    int errCode = E_OK;
+    std::string filePath = "/data/test/Test018";
+    Options option = Options(filePath, "", "", true);
+    for (bool isWriteBehind : { false, true }) {
+        PreferencesEnhanceImpl::SetWriteBehindEnabled(isWriteBehind);
+        std::shared_ptr<Preferences> pref = PreferencesHelper::GetPreferences(option, errCode);
+        ASSERT_EQ(errCode, E_OK);
+        for (int i = 0; i < keyNum; i++) {
+            ASSERT_EQ(pref->PutInt("test018_key_" + std::to_string(i), i), E_OK);
+        }
+        ASSERT_EQ(pref->Delete("test018_key_0"), E_OK);
+        EXPECT_FALSE(pref->HasKey("test018_key_0"));
+        EXPECT_EQ(pref->GetInt("test018_key_1", -1), 1);
+        EXPECT_EQ(pref->GetAll().size(), keyNum - 1);
+        auto [ret, iterator] = pref->CreateIterator();
+        ASSERT_EQ(ret, E_OK);
+        std::string key;
+        PreferencesValue value;
+        int count = 0;
+        while (iterator->Next(key, value) == E_OK) {
+            EXPECT_EQ(static_cast<int>(value), std::stoi(key.substr(strlen("test018_key_"))));
+            count++;
+        }
+        iterator = nullptr;
+        EXPECT_EQ(count, keyNum - 1);
+        ASSERT_EQ(pref->FlushSync(), E_OK);
+        if (isWriteBehind) {
+            // the buffered writes of a key are coalesced, its observer is notified once they reach the db.
+            auto observer = std::make_shared<FlushObserver>();
+            ASSERT_EQ(pref->RegisterDataObserver(observer, { "test018_key_1" }), E_OK);
+            for (int i = 0; i < 5; i++) {
+                ASSERT_EQ(pref->PutInt("test018_key_1", i), E_OK);
+            }
+            {
+                std::lock_guard<std::mutex> lock(observer->mutex_);
+                EXPECT_TRUE(observer->records_.empty());
+            }
+            ASSERT_EQ(pref->FlushSync(), E_OK);
+            std::unique_lock<std::mutex> lock(observer->mutex_);
+            observer->cond_.wait_for(lock, std::chrono::seconds(1), [&observer] {
+                return !observer->records_.empty();
+            });
+            ASSERT_EQ(observer->records_.size(), 1);
+            EXPECT_EQ(static_cast<int>(observer->records_[0]["test018_key_1"]), 4);
+            lock.unlock();
+            EXPECT_EQ(pref->UnRegisterDataObserver(observer, { "test018_key_1" }), E_OK);
+            ASSERT_EQ(pref->PutInt("test018_key_1", 1), E_OK);
+            ASSERT_EQ(pref->FlushSync(), E_OK);
+        }
+        ASSERT_EQ(PreferencesHelper::RemovePreferencesFromCache(filePath), E_OK);
+
+        // the writes are in the db
+        PreferencesEnhanceImpl::SetWriteBehindEnabled(false);
+        pref = PreferencesHelper::GetPreferences(option, errCode);
+        ASSERT_EQ(errCode, E_OK);
+        EXPECT_EQ(pref->GetAll().size(), keyNum - 1);
+        EXPECT_EQ(pref->GetInt("test018_key_" + std::to_string(keyNum - 1), -1), keyNum - 1);
+        ASSERT_EQ(pref->Clear(), E_OK);
+        ASSERT_EQ(PreferencesHelper::RemovePreferencesFromCache(filePath), E_OK);
+    }
+    ASSERT_EQ(PreferencesHelper::DeletePreferences(filePath), E_OK);
+}
+
+class ClearObserver : public PreferencesObserver {
+public:
+    void OnChange(const std::string &key) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        keyNum_++;
+        cond_.notify_all();
+    }
+
+    void OnChange(const std::map<std::string, PreferencesValue> &records) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        records_.push_back(records);
+        cond_.notify_all();
+    }
+
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    int keyNum_ = 0;
+    std::vector<std::map<std::string, PreferencesValue>> records_;
+};
+
+/**
+ * @tc.name: StorageTypeApiTest019
+ * @tc.desc: api test, Clear in GSKV mode notifies every key, and a data observer once with its keys and values
+ * @tc.type: FUNC
+ */
+HWTEST_F(PreferencesStorageTypeTest, StorageTypeApiTest019, TestSize.Level1)
+{
+    bool isEnhance = PreferencesHelper::IsStorageTypeSupported(StorageType::GSKV);
+    if (!isEnhance) {
+        return;
+    }
+    int errCode = E_OK;
+    std::string filePath = "/data/test/Test019";
+    Options option = Options(filePath, "", "", true);
+    std::shared_ptr<Preferences> pref = PreferencesHelper::GetPreferences(option, errCode);
+    ASSERT_EQ(errCode, E_OK);
+    constexpr int keyNum = 1000;
+    for (int i = 0; i < keyNum; i++) {
+        ASSERT_EQ(pref->PutString("test019_key_" + std::to_string(i), "test019_value_" + std::to_string(i)), E_OK);
+    }
+    auto localObserver = std::make_shared<ClearObserver>();
+    auto dataObserver = std::make_shared<ClearObserver>();
+    ASSERT_EQ(pref->RegisterObserver(localObserver), E_OK);
+    ASSERT_EQ(pref->RegisterDataObserver(dataObserver, { "test019_key_1", "test019_key_2", "test019_absent" }),
+        E_OK);
+
+    ASSERT_EQ(pref->Clear(), E_OK);
+    {
+        std::unique_lock<std::mutex> lock(localObserver->mutex_);
+        localObserver->cond_.wait_for(lock, std::chrono::seconds(5),
+            [&localObserver]() { return localObserver->keyNum_ == keyNum; });
+        EXPECT_EQ(localObserver->keyNum_, keyNum);
+    }
+    std::unique_lock<std::mutex> lock(dataObserver->mutex_);
+    dataObserver->cond_.wait_for(lock, std::chrono::seconds(5),
+        [&dataObserver]() { return !dataObserver->records_.empty(); });
+    ASSERT_EQ(dataObserver->records_.size(), 1);
+    auto &records = dataObserver->records_[0];
+    ASSERT_EQ(records.size(), 2);
+    EXPECT_EQ(static_cast<std::string>(records["test019_key_1"]), "test019_value_1");
+    EXPECT_EQ(static_cast<std::string>(records["test019_key_2"]), "test019_value_2");
+    lock.unlock();
+    EXPECT_EQ(pref->UnRegisterObserver(localObserver), E_OK);
+    ASSERT_EQ(PreferencesHelper::RemovePreferencesFromCache(filePath), E_OK);
+    ASSERT_EQ(PreferencesHelper::DeletePreferences(filePath), E_OK);
+}
+
+/**
+ * @tc.name: StorageTypeApiTest020
+ * @tc.desc: test the GSKV stores are usable at once while they open in the background, a failed open is retried
+ * @tc.type: FUNC
+ */
+HWTEST_F(PreferencesStorageTypeTest, StorageTypeApiTest020, TestSize.Level1)
+{
+    bool isEnhance = PreferencesHelper::IsStorageTypeSupported(StorageType::GSKV);
+    if (!isEnhance) {
+        return;
+    }
+    constexpr int storeNum = 8;
+    int errCode = E_OK;
+    std::vector<std::shared_ptr<Preferences>> prefs;
+    for (int i = 0; i < storeNum; i++) {
+        Options option = Options("/data/test/Test020_" + std::to_string(i), "", "", true);
+        prefs.push_back(PreferencesHelper::GetPreferences(option, errCode));
+        ASSERT_EQ(errCode, E_OK);
+        ASSERT_NE(prefs.back(), nullptr);
+        EXPECT_EQ(prefs.back()->PutInt("test020_key", i), E_OK);
+    }
+    for (int i = 0; i < storeNum; i++) {
+        EXPECT_EQ(prefs[i]->GetInt("test020_key", -1), i);
+    }
+    prefs.clear();
+    for (int i = 0; i < storeNum; i++) {
+        EXPECT_EQ(PreferencesHelper::DeletePreferences("/data/test/Test020_" + std::to_string(i)), E_OK);
+    }
+
+    // the directory does not exist, the open fails in the background and the operations report it.
+    std::string filePath = "/data/test/test020_not_exist/Test020";
+    Options option = Options(filePath, "", "", true);
+    std::shared_ptr<Preferences> pref = PreferencesHelper::GetPreferences(option, errCode);
+    ASSERT_EQ(errCode, E_OK);
+    ASSERT_NE(pref, nullptr);
+    EXPECT_NE(pref->GetValue("test020_key", PreferencesValue(0)).first, E_OK);
+    EXPECT_NE(pref->PutInt("test020_key", 1), E_OK);
+    EXPECT_TRUE(pref->GetAll().empty());
+    EXPECT_TRUE(pref->GetAllDatas().empty());
+    std::shared_ptr<Preferences> newPref = PreferencesHelper::GetPreferences(option, errCode);
+    EXPECT_NE(newPref, pref);
+    pref = nullptr;
+    newPref = nullptr;
+    PreferencesHelper::RemovePreferencesFromCache(filePath);
+}
+
+/**
+ * @tc.name: StorageTypeApiTest021
+ * @tc.desc: test the eviction and FlushAll read the memtables of write-behind GSKV stores while they are written
+ *           and flushed
+ * @tc.type: FUNC
+ */
+HWTEST_F(PreferencesStorageTypeTest, StorageTypeApiTest021, TestSize.Level1)
+{
+    bool isEnhance = PreferencesHelper::IsStorageTypeSupported(StorageType::GSKV);
+    if (!isEnhance) {
+        return;
+    }
+    PreferencesEnhanceImpl::SetWriteBehindEnabled(true);
+    constexpr int storeNum = 4;
+    constexpr int writeNum = 2000;
+    auto path = [](int i) { return "/data/test/Test021_" + std::to_string(i); };
+    int errCode = E_OK;
+    std::shared_ptr<Preferences> pref = PreferencesHelper::GetPreferences(Options(path(0), "", "", true), errCode);
+    ASSERT_EQ(errCode, E_OK);
+    ASSERT_NE(pref, nullptr);
+    for (int i = 1; i < storeNum; i++) {
+        auto idlePref = PreferencesHelper::GetPreferences(Options(path(i), "", "", true), errCode);
+        ASSERT_NE(idlePref, nullptr);
+        EXPECT_EQ(idlePref->PutInt("test021_key", i), E_OK);
+        EXPECT_EQ(idlePref->FlushSync(), E_OK);
+    }
+
+    std::atomic<bool> isWriting = true;
+    std::thread writer([&pref, &isWriting] {
+        for (int i = 0; i < writeNum; i++) {
+            EXPECT_EQ(pref->PutString("test021_key_" + std::to_string(i), std::string(256, 'a')), E_OK);
+            if (i % 100 == 0) {
+                pref->Flush();
+            }
+        }
+        isWriting = false;
+    });
+    // each budget change starts an eviction, which reads the memtable of the store being written and flushed.
+    while (isWriting) {
+        EXPECT_EQ(PreferencesHelper::SetCacheMemoryBudget(1), E_OK);
+        std::vector<std::string> unflushedPaths;
+        (void)PreferencesHelper::FlushAll(std::chrono::milliseconds(100), unflushedPaths);
+        EXPECT_EQ(PreferencesHelper::SetCacheMemoryBudget(0), E_OK);
+    }
+    writer.join();
+
+    EXPECT_EQ(pref->FlushSync(), E_OK);
+    EXPECT_EQ(pref->GetAll().size(), writeNum);
+    pref = nullptr;
+    PreferencesEnhanceImpl::SetWriteBehindEnabled(false);
+    for (int i = 0; i < storeNum; i++) {
+        auto reopened = PreferencesHelper::GetPreferences(Options(path(i), "", "", true), errCode);
+        ASSERT_NE(reopened, nullptr);
+        if (i > 0) {
+            EXPECT_EQ(reopened->GetInt("test021_key", -1), i);
+        }
+        reopened = nullptr;
+        EXPECT_EQ(PreferencesHelper::DeletePreferences(path(i)), E_OK);
+    }
+}
+
 } // namespace
\ No newline at end of file
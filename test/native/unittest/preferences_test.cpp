@@ -17,20 +17,27 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
 #include <cctype>
+#include <chrono>
 #include <condition_variable>
 #include <cstdint>
+#include <functional>
+#include <future>
 #include <iostream>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include "log_print.h"
 #include "preferences_errno.h"
 #include "preferences_file_operation.h"
 #include "preferences_helper.h"
+#include "preferences_impl.h"
 #include "preferences_observer.h"
+#include "preferences_task_processor.h"
 #include "preferences_utils.h"
 #include "preferences_value.h"
 
@@ -1460,4 +1467,333 @@ HWTEST_F(PreferencesTest, NativePreferencesMultiThreadTest_002, TestSize.Level1)
     EXPECT_EQ(readCount.load(), readerThreadCount * iterations);
     PreferencesHelper::DeletePreferences(path);
 }
+
+/**
+ * @tc.name: NativePreferencesTestPutMove_001
+ * @tc.desc: normal testcase of Put with rvalue key and value
+ * @tc.type: FUNC
+ */
+HWTEST_F(PreferencesTest, NativePreferencesTestPutMove_001, TestSize.Level0)
+{
+    std::string key = "test_put_move";
+    std::string longStr(Preferences::MAX_KEY_LENGTH, 'a');
+    int ret = pref->Put(std::string(key), PreferencesValue(longStr));
+    EXPECT_EQ(ret, E_OK);
+    EXPECT_EQ(pref->GetString(key, ""), longStr);
+
+    ret = pref->Put(std::string(key), PreferencesValue(std::string("new_value")));
+    EXPECT_EQ(ret, E_OK);
+    EXPECT_EQ(pref->GetString(key, ""), "new_value");
+
+    std::string invalidKey(Preferences::MAX_KEY_LENGTH + 1, 'a');
+    ret = pref->Put(std::move(invalidKey), PreferencesValue(1));
+    EXPECT_EQ(ret, E_KEY_EXCEED_MAX_LENGTH);
+
+    ret = pref->FlushSync();
+    EXPECT_EQ(ret, E_OK);
+    pref->Delete(key);
+}
+
+/**
+ * @tc.name: NativePreferencesDirtyBudgetTest_001
+ * @tc.desc: normal testcase of writes past the dirty bytes budget
+ * @tc.type: FUNC
+ */
+HWTEST_F(PreferencesTest, NativePreferencesDirtyBudgetTest_001, TestSize.Level1)
+{
+    auto oriBudget = PreferencesImpl::GetDirtyBytesBudget();
+    PreferencesImpl::DirtyBytesBudget invalidBudget = { 2048, 2048, 1024, 1024, 0 };
+    EXPECT_EQ(PreferencesImpl::SetDirtyBytesBudget(invalidBudget), E_ERROR);
+    PreferencesImpl::DirtyBytesBudget budget = { 1024, 4096, 2048, 8192, 2000 };
+    EXPECT_EQ(PreferencesImpl::SetDirtyBytesBudget(budget), E_OK);
+
+    int errCode;
+    std::string path = "/data/test/dirty_budget_test_001";
+    auto preferences = PreferencesHelper::GetPreferences(path, errCode);
+    ASSERT_NE(preferences, nullptr);
+    auto before = PreferencesImpl::GetWriteThrottleStats();
+    std::string value(512, 'a');
+    for (int i = 0; i < 100; i++) {
+        EXPECT_EQ(preferences->PutString("key_" + std::to_string(i), value), E_OK);
+    }
+    auto after = PreferencesImpl::GetWriteThrottleStats();
+    EXPECT_GT(after.earlyFlushCount, before.earlyFlushCount);
+    EXPECT_EQ(after.rejectedCount, before.rejectedCount);
+
+    auto impl = std::static_pointer_cast<PreferencesImpl>(preferences);
+    EXPECT_LT(impl->GetDirtyBytes(), budget.hardLimit + static_cast<int64_t>(value.size()) + 16);
+    EXPECT_EQ(preferences->FlushSync(), E_OK);
+    EXPECT_EQ(impl->GetDirtyBytes(), 0);
+    EXPECT_EQ(preferences->GetString("key_99", ""), value);
+
+    EXPECT_EQ(PreferencesImpl::SetDirtyBytesBudget(oriBudget), E_OK);
+    PreferencesHelper::DeletePreferences(path);
+}
+
+/**
+ * @tc.name: NativePreferencesDirtyBudgetTest_002
+ * @tc.desc: normal testcase of writes past the dirty bytes budget from a task of the flush lane
+ * @tc.type: FUNC
+ */
+HWTEST_F(PreferencesTest, NativePreferencesDirtyBudgetTest_002, TestSize.Level1)
+{
+    auto oriBudget = PreferencesImpl::GetDirtyBytesBudget();
+    PreferencesImpl::DirtyBytesBudget budget = { 1024, 4096, 2048, 8192, 2000 };
+    EXPECT_EQ(PreferencesImpl::SetDirtyBytesBudget(budget), E_OK);
+    int errCode;
+    std::string path = "/data/test/dirty_budget_test_002";
+    auto preferences = PreferencesHelper::GetPreferences(path, errCode);
+    ASSERT_NE(preferences, nullptr);
+
+    // the writer starts first, then the other workers of the flush lane are kept busy, so the early flush can not
+    // run before the writer returns.
+    auto processor = PreferencesTaskProcessor::GetInstance();
+    std::promise<void> started;
+    std::promise<void> start;
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    std::promise<std::pair<int, std::chrono::steady_clock::duration>> written;
+    EXPECT_TRUE(processor->Execute(TaskLane::FLUSH, [&preferences, &started, &start, &written] {
+        started.set_value();
+        start.get_future().wait();
+        auto begin = std::chrono::steady_clock::now();
+        int lastErrCode = E_OK;
+        std::string value(512, 'a');
+        for (int i = 0; i < 20 && lastErrCode == E_OK; i++) {
+            lastErrCode = preferences->PutString("key_" + std::to_string(i), value);
+        }
+        written.set_value({ lastErrCode, std::chrono::steady_clock::now() - begin });
+    }));
+    started.get_future().wait();
+    auto concurrency = PreferencesTaskProcessor::GetLaneConfig(TaskLane::FLUSH).concurrency;
+    for (int32_t i = 0; i < concurrency - 1; i++) {
+        EXPECT_TRUE(processor->Execute(TaskLane::FLUSH, [released] { released.wait(); }));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    start.set_value();
+    auto [lastErrCode, elapsed] = written.get_future().get();
+    release.set_value();
+    EXPECT_EQ(lastErrCode, E_DIRTY_BYTES_EXCEED_LIMIT);
+    EXPECT_LT(elapsed, std::chrono::milliseconds(budget.waitTime));
+
+    EXPECT_EQ(preferences->FlushSync(), E_OK);
+    EXPECT_EQ(std::static_pointer_cast<PreferencesImpl>(preferences)->GetDirtyBytes(), 0);
+    EXPECT_EQ(PreferencesImpl::SetDirtyBytesBudget(oriBudget), E_OK);
+    PreferencesHelper::DeletePreferences(path);
+}
+
+/**
+ * @tc.name: NativePreferencesDirtyBudgetTest_003
+ * @tc.desc: normal testcase of overwriting one key past the soft limit, the key is charged once while it is dirty
+ * @tc.type: FUNC
+ */
+HWTEST_F(PreferencesTest, NativePreferencesDirtyBudgetTest_003, TestSize.Level1)
+{
+    auto oriBudget = PreferencesImpl::GetDirtyBytesBudget();
+    PreferencesImpl::DirtyBytesBudget budget = { 1024, 1024 * 1024, 2048, 2 * 1024 * 1024, 0 };
+    EXPECT_EQ(PreferencesImpl::SetDirtyBytesBudget(budget), E_OK);
+
+    int errCode;
+    std::string path = "/data/test/dirty_budget_test_003";
+    auto preferences = PreferencesHelper::GetPreferences(path, errCode);
+    ASSERT_NE(preferences, nullptr);
+    auto impl = std::static_pointer_cast<PreferencesImpl>(preferences);
+    auto before = PreferencesImpl::GetWriteThrottleStats();
+    std::string key = "key";
+    for (int i = 0; i < 100; i++) {
+        EXPECT_EQ(preferences->PutString(key, std::string(512, 'a' + i % 2)), E_OK);
+    }
+    EXPECT_EQ(preferences->PutString(key, std::string(256, 'c')), E_OK);
+    auto after = PreferencesImpl::GetWriteThrottleStats();
+    EXPECT_EQ(after.earlyFlushCount, before.earlyFlushCount);
+    EXPECT_EQ(after.rejectedCount, before.rejectedCount);
+    EXPECT_EQ(impl->GetDirtyBytes(), static_cast<int64_t>(key.size() + 256));
+    EXPECT_EQ(preferences->FlushSync(), E_OK);
+    EXPECT_EQ(impl->GetDirtyBytes(), 0);
+
+    EXPECT_EQ(PreferencesImpl::SetDirtyBytesBudget(oriBudget), E_OK);
+    PreferencesHelper::DeletePreferences(path);
+}
+
+/**
+ * @tc.name: NativePreferencesLoadWaitTest_001
+ * @tc.desc: normal testcase of a read while the load is queued behind a busy task, the read runs the load itself
+ * @tc.type: FUNC
+ */
+HWTEST_F(PreferencesTest, NativePreferencesLoadWaitTest_001, TestSize.Level1)
+{
+    int errCode = E_OK;
+    std::string path = "/data/test/load_wait_test_001";
+    auto preferences = PreferencesHelper::GetPreferences(path, errCode);
+    ASSERT_NE(preferences, nullptr);
+    EXPECT_EQ(preferences->PutInt("key", 1), E_OK);
+    EXPECT_EQ(preferences->FlushSync(), E_OK);
+    preferences = nullptr;
+    EXPECT_EQ(PreferencesHelper::RemovePreferencesFromCache(path), E_OK);
+
+    // the load lane runs one task at a time, the blocker keeps it busy until the read returns. It gives up after a
+    // while, so that a read waiting for the queued load fails the test instead of hanging it.
+    auto before = PreferencesImpl::GetLoadWaitStats();
+    std::promise<void> started;
+    std::promise<void> release;
+    std::atomic<bool> isBlockerDone = false;
+    EXPECT_TRUE(PreferencesTaskProcessor::GetInstance()->Execute(TaskLane::LOAD,
+        [&started, released = release.get_future().share(), &isBlockerDone] {
+            started.set_value();
+            released.wait_for(std::chrono::seconds(2));
+            isBlockerDone = true;
+        }));
+    started.get_future().wait();
+    preferences = PreferencesHelper::GetPreferences(path, errCode);
+    ASSERT_NE(preferences, nullptr);
+    EXPECT_EQ(preferences->GetInt("key", 0), 1);
+    EXPECT_FALSE(isBlockerDone.load());
+    release.set_value();
+    auto after = PreferencesImpl::GetLoadWaitStats();
+    EXPECT_EQ(after.stealCount, before.stealCount + 1);
+    uint64_t histogramCount = 0;
+    for (size_t i = 0; i < after.waitTimeHistogram.size(); i++) {
+        histogramCount += after.waitTimeHistogram[i];
+    }
+    EXPECT_EQ(histogramCount, after.waitCount);
+    EXPECT_GE(after.waitCount, before.waitCount + 1);
+    PreferencesHelper::DeletePreferences(path);
+}
+
+/**
+ * @tc.name: NativePreferencesTryGetTest_001
+ * @tc.desc: normal testcase of TryGet and GetAsync while the load is queued behind a busy task
+ * @tc.type: FUNC
+ */
+HWTEST_F(PreferencesTest, NativePreferencesTryGetTest_001, TestSize.Level1)
+{
+    int errCode = E_OK;
+    std::string path = "/data/test/try_get_test_001";
+    auto preferences = PreferencesHelper::GetPreferences(path, errCode);
+    ASSERT_NE(preferences, nullptr);
+    EXPECT_EQ(preferences->PutInt("key", 1), E_OK);
+    EXPECT_EQ(preferences->FlushSync(), E_OK);
+    preferences = nullptr;
+    EXPECT_EQ(PreferencesHelper::RemovePreferencesFromCache(path), E_OK);
+
+    PreferencesTaskProcessor::GetInstance()->Execute([] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    });
+    preferences = PreferencesHelper::GetPreferences(path, errCode);
+    ASSERT_NE(preferences, nullptr);
+    EXPECT_EQ(preferences->SetLoadingDefaults({ { "key", PreferencesValue(2) } }), E_OK);
+    auto [code, value] = preferences->TryGet("key", PreferencesValue(0));
+    // the executor may run tasks in parallel, then the load may finish before the read.
+    if (code == E_NOT_LOADED) {
+        EXPECT_EQ(static_cast<int>(value), 2);
+        EXPECT_EQ(static_cast<int>(preferences->TryGet("other", PreferencesValue(3)).second), 3);
+    } else {
+        EXPECT_EQ(code, E_OK);
+        EXPECT_EQ(static_cast<int>(value), 1);
+    }
+    EXPECT_EQ(preferences->TryGet("", PreferencesValue(0)).first, E_KEY_EMPTY);
+
+    auto future = preferences->GetAsync("key", PreferencesValue(0));
+    auto result = future.get();
+    EXPECT_EQ(result.first, E_OK);
+    EXPECT_EQ(static_cast<int>(result.second), 1);
+    result = preferences->TryGet("key", PreferencesValue(0));
+    EXPECT_EQ(result.first, E_OK);
+    EXPECT_EQ(static_cast<int>(result.second), 1);
+    EXPECT_EQ(preferences->GetAsync("other", PreferencesValue(3)).get().first, E_NO_DATA);
+    PreferencesHelper::DeletePreferences(path);
+}
+
+/**
+ * @tc.name: NativePreferencesAsyncTest_001
+ * @tc.desc: normal testcase of the async completions resumed on the thread of the caller
+ * @tc.type: FUNC
+ */
+HWTEST_F(PreferencesTest, NativePreferencesAsyncTest_001, TestSize.Level1)
+{
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<std::function<void()>> completions;
+    PreferencesResumer resumer = [&mutex, &cv, &completions](std::function<void()> completion) {
+        std::lock_guard<std::mutex> lock(mutex);
+        completions.push_back(std::move(completion));
+        cv.notify_one();
+    };
+    auto runOne = [&mutex, &cv, &completions] {
+        std::function<void()> completion;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            ASSERT_TRUE(cv.wait_for(lock, std::chrono::seconds(5), [&completions] { return !completions.empty(); }));
+            completion = std::move(completions.front());
+            completions.erase(completions.begin());
+        }
+        completion();
+    };
+    auto threadId = std::this_thread::get_id();
+
+    std::string path = "/data/test/async_test_001";
+    std::shared_ptr<Preferences> preferences;
+    PreferencesHelper::GetPreferencesAsync(Options(path),
+        [&preferences, threadId](int errCode, std::shared_ptr<Preferences> pref) {
+            EXPECT_EQ(std::this_thread::get_id(), threadId);
+            EXPECT_EQ(errCode, E_OK);
+            preferences = pref;
+        }, resumer);
+    runOne();
+    ASSERT_NE(preferences, nullptr);
+
+    EXPECT_EQ(preferences->PutInt("key", 1), E_OK);
+    int flushCode = E_ERROR;
+    preferences->FlushAsync([&flushCode, threadId](int errCode) {
+        EXPECT_EQ(std::this_thread::get_id(), threadId);
+        flushCode = errCode;
+    }, resumer);
+    runOne();
+    EXPECT_EQ(flushCode, E_OK);
+
+    std::pair<int, PreferencesValue> result = { E_ERROR, PreferencesValue(0) };
+    preferences->GetAsync("key", PreferencesValue(0), [&result, threadId](std::pair<int, PreferencesValue> res) {
+        EXPECT_EQ(std::this_thread::get_id(), threadId);
+        result = std::move(res);
+    }, resumer);
+    runOne();
+    EXPECT_EQ(result.first, E_OK);
+    EXPECT_EQ(static_cast<int>(result.second), 1);
+
+    // without a resumer the completion runs on the thread that finished the work.
+    std::promise<int> promise;
+    preferences->FlushAsync([&promise](int errCode) { promise.set_value(errCode); });
+    EXPECT_EQ(promise.get_future().get(), E_OK);
+
+    preferences = nullptr;
+    PreferencesHelper::DeletePreferences(path);
+}
+
+/**
+ * @tc.name: NativePreferencesIteratorTest_001
+ * @tc.desc: normal testcase of iterating over all the keys and values
+ * @tc.type: FUNC
+ */
+HWTEST_F(PreferencesTest, NativePreferencesIteratorTest_001, TestSize.Level0)
+{
+    pref->PutInt(KEY_TEST_INT_ELEMENT, 1);
+    pref->PutString(KEY_TEST_STRING_ELEMENT, "test");
+    pref->Put(KEY_TEST_STRING_ARRAY_ELEMENT, std::vector<std::string>{ "a", "b" });
+
+    auto [errCode, iterator] = pref->CreateIterator();
+    ASSERT_EQ(errCode, E_OK);
+    ASSERT_NE(iterator, nullptr);
+    std::map<std::string, PreferencesValue> data;
+    std::string key;
+    PreferencesValue value;
+    while ((errCode = iterator->Next(key, value)) == E_OK) {
+        EXPECT_TRUE(data.insert_or_assign(key, value).second);
+    }
+    EXPECT_EQ(errCode, E_NO_DATA);
+    EXPECT_EQ(iterator->Next(key, value), E_NO_DATA);
+    EXPECT_EQ(data.size(), 3);
+    EXPECT_EQ(static_cast<int>(data[KEY_TEST_INT_ELEMENT]), 1);
+    EXPECT_EQ(static_cast<std::string>(data[KEY_TEST_STRING_ELEMENT]), "test");
+    EXPECT_EQ(static_cast<std::vector<std::string>>(data[KEY_TEST_STRING_ARRAY_ELEMENT]).size(), 2);
+}
 } // namespace
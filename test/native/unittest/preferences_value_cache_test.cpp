@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "preferences_value_cache.h"
+#include <gtest/gtest.h>
+#include <string>
+
+using namespace testing::ext;
+using namespace OHOS::NativePreferences;
+namespace {
+class PreferencesValueCacheTest : public testing::Test {
+public:
+    static void SetUpTestCase(void);
+    static void TearDownTestCase(void);
+    void SetUp();
+    void TearDown();
+};
+
+void PreferencesValueCacheTest::SetUpTestCase(void)
+{
+}
+
+void PreferencesValueCacheTest::TearDownTestCase(void)
+{
+}
+
+void PreferencesValueCacheTest::SetUp(void)
+{
+}
+
+void PreferencesValueCacheTest::TearDown(void)
+{
+}
+
+/**
+ * @tc.name: PreferencesValueCacheTest_001
+ * @tc.desc: normal testcase of the values, the absent keys and the version of the value cache
+ * @tc.type: FUNC
+ */
+HWTEST_F(PreferencesValueCacheTest, PreferencesValueCacheTest_001, TestSize.Level0)
+{
+    PreferencesValueCache cache(1024 * 1024);
+    PreferencesValue value;
+    bool isExist = false;
+    EXPECT_FALSE(cache.Get("key", 1, value, isExist));
+
+    cache.Put("key", PreferencesValue(1), sizeof(int), 1);
+    cache.PutAbsent("absent", 1);
+    EXPECT_TRUE(cache.Get("key", 1, value, isExist));
+    EXPECT_TRUE(isExist);
+    EXPECT_EQ(static_cast<int>(value), 1);
+    EXPECT_TRUE(cache.Get("absent", 1, value, isExist));
+    EXPECT_FALSE(isExist);
+
+    // the entries are kept after a write of this process, and dropped under another version
+    cache.AdvanceVersion(2);
+    cache.Put("key2", PreferencesValue(2), sizeof(int), 2);
+    EXPECT_TRUE(cache.Get("key", 2, value, isExist));
+    EXPECT_FALSE(cache.Get("key", 1, value, isExist));
+    cache.AdvanceVersion(5);
+    EXPECT_FALSE(cache.Get("key2", 5, value, isExist));
+
+    cache.Put("key", PreferencesValue(3), sizeof(int), 6);
+    EXPECT_FALSE(cache.Get("key2", 6, value, isExist));
+    EXPECT_TRUE(cache.Get("key", 6, value, isExist));
+    EXPECT_EQ(static_cast<int>(value), 3);
+
+    auto stats = cache.GetStats();
+    EXPECT_EQ(stats.hitCount, 4);
+    EXPECT_EQ(stats.missCount, 4);
+    EXPECT_EQ(stats.entryCount, 1);
+    cache.Clear();
+    EXPECT_EQ(cache.GetStats().usedBytes, 0);
+}
+
+/**
+ * @tc.name: PreferencesValueCacheTest_002
+ * @tc.desc: normal testcase of the byte budget of the value cache, the hot keys outlive a scan of cold keys
+ * @tc.type: FUNC
+ */
+HWTEST_F(PreferencesValueCacheTest, PreferencesValueCacheTest_002, TestSize.Level0)
+{
+    constexpr size_t valueSize = 1000;
+    constexpr size_t capacity = 20 * 1024;
+    PreferencesValueCache cache(capacity);
+    PreferencesValue value;
+    bool isExist = false;
+    std::string bigValue(valueSize, 'a');
+    for (int i = 0; i < 5; i++) {
+        cache.Put("hot" + std::to_string(i), PreferencesValue(bigValue), valueSize, 1);
+        EXPECT_TRUE(cache.Get("hot" + std::to_string(i), 1, value, isExist));
+    }
+    for (int i = 0; i < 100; i++) {
+        cache.Put("cold" + std::to_string(i), PreferencesValue(bigValue), valueSize, 1);
+    }
+    auto stats = cache.GetStats();
+    EXPECT_LE(stats.usedBytes, capacity);
+    EXPECT_GT(stats.evictCount, 0);
+    for (int i = 0; i < 5; i++) {
+        EXPECT_TRUE(cache.Get("hot" + std::to_string(i), 1, value, isExist));
+        EXPECT_EQ(static_cast<std::string>(value), bigValue);
+    }
+    EXPECT_FALSE(cache.Get("cold0", 1, value, isExist));
+
+    // an entry larger than the budget is held alone besides the budget, the hot keys stay.
+    auto entryCount = cache.GetStats().entryCount;
+    cache.Put("huge", PreferencesValue(bigValue), capacity, 1);
+    EXPECT_TRUE(cache.Get("huge", 1, value, isExist));
+    EXPECT_EQ(static_cast<std::string>(value), bigValue);
+    EXPECT_EQ(cache.GetStats().entryCount, entryCount + 1);
+    for (int i = 0; i < 5; i++) {
+        EXPECT_TRUE(cache.Get("hot" + std::to_string(i), 1, value, isExist));
+    }
+    cache.Put("huge2", PreferencesValue(bigValue), capacity, 1);
+    EXPECT_FALSE(cache.Get("huge", 1, value, isExist));
+    EXPECT_TRUE(cache.Get("huge2", 1, value, isExist));
+    EXPECT_EQ(cache.GetStats().entryCount, entryCount + 1);
+    // overwritten by a value which fits the budget, the key leaves the oversize slot.
+    cache.Put("huge2", PreferencesValue(1), sizeof(int), 1);
+    EXPECT_TRUE(cache.Get("huge2", 1, value, isExist));
+    EXPECT_EQ(static_cast<int>(value), 1);
+    EXPECT_LE(cache.GetStats().usedBytes, capacity);
+
+    cache.Put("huge", PreferencesValue(bigValue), capacity, 1);
+    cache.SetCapacity(0);
+    EXPECT_EQ(cache.GetStats().entryCount, 0);
+    EXPECT_EQ(cache.GetStats().usedBytes, 0);
+    cache.Put("huge", PreferencesValue(bigValue), capacity, 1);
+    EXPECT_FALSE(cache.Get("huge", 1, value, isExist));
+}
+} // namespace
@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "preferences_value_parcel.h"
+#include <gtest/gtest.h>
+#include <climits>
+#include <cstring>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "preferences_errno.h"
+
+using namespace testing::ext;
+using namespace OHOS::NativePreferences;
+namespace {
+class PreferencesValueParcelTest : public testing::Test {
+public:
+    static void SetUpTestCase(void);
+    static void TearDownTestCase(void);
+    void SetUp();
+    void TearDown();
+};
+
+void PreferencesValueParcelTest::SetUpTestCase(void)
+{
+}
+
+void PreferencesValueParcelTest::TearDownTestCase(void)
+{
+}
+
+void PreferencesValueParcelTest::SetUp(void)
+{
+}
+
+void PreferencesValueParcelTest::TearDown(void)
+{
+}
+
+static std::vector<uint8_t> Encode(const PreferencesValue &value)
+{
+    std::vector<uint8_t> data(PreferencesValueParcel::CalSize(value));
+    EXPECT_EQ(PreferencesValueParcel::MarshallingPreferenceValue(value, data), E_OK);
+    return data;
+}
+
+static bool IsRoundTrip(PreferencesValue value)
+{
+    auto data = Encode(value);
+    auto [errCode, result] = PreferencesValueParcel::UnmarshallingPreferenceValue(data);
+    return errCode == E_OK && value == result;
+}
+
+/**
+ * @tc.name: PreferencesValueParcelTest_001
+ * @tc.desc: normal testcase of the v2 codec, every type is decoded as it is encoded
+ * @tc.type: FUNC
+ */
+HWTEST_F(PreferencesValueParcelTest, PreferencesValueParcelTest_001, TestSize.Level0)
+{
+    EXPECT_TRUE(IsRoundTrip(PreferencesValue(0)));
+    EXPECT_TRUE(IsRoundTrip(PreferencesValue(INT_MIN)));
+    EXPECT_TRUE(IsRoundTrip(PreferencesValue(INT_MAX)));
+    EXPECT_TRUE(IsRoundTrip(PreferencesValue(static_cast<int64_t>(INT64_MIN))));
+    EXPECT_TRUE(IsRoundTrip(PreferencesValue(static_cast<int64_t>(INT64_MAX))));
+    EXPECT_TRUE(IsRoundTrip(PreferencesValue(1.5f)));
+    EXPECT_TRUE(IsRoundTrip(PreferencesValue(-2.25)));
+    EXPECT_TRUE(IsRoundTrip(PreferencesValue(true)));
+    EXPECT_TRUE(IsRoundTrip(PreferencesValue(std::string(""))));
+    EXPECT_TRUE(IsRoundTrip(PreferencesValue(std::string("value"))));
+    EXPECT_TRUE(IsRoundTrip(PreferencesValue(Object("{\"key\":1}"))));
+    EXPECT_TRUE(IsRoundTrip(PreferencesValue(std::vector<std::string>{ "a", "", "ccc" })));
+    EXPECT_TRUE(IsRoundTrip(PreferencesValue(std::vector<bool>{ true, false, true, true, false, false, true, true,
+        false, true })));
+    EXPECT_TRUE(IsRoundTrip(PreferencesValue(std::vector<bool>())));
+    EXPECT_TRUE(IsRoundTrip(PreferencesValue(std::vector<double>{ 1.0, -0.5, 1e300 })));
+    EXPECT_TRUE(IsRoundTrip(PreferencesValue(std::vector<uint8_t>{ 0, 1, 255 })));
+    EXPECT_TRUE(IsRoundTrip(PreferencesValue(BigInt({ 1, UINT64_MAX }, -1))));
+    EXPECT_TRUE(IsRoundTrip(PreferencesValue(std::vector<int>{ 0, -1, INT_MIN, INT_MAX })));
+    EXPECT_TRUE(IsRoundTrip(PreferencesValue(std::vector<int64_t>{ 0, -1, INT64_MIN, INT64_MAX })));
+
+    // the small ints take a byte, the bools a bit
+    EXPECT_EQ(Encode(PreferencesValue(1)).size(), 3);
+    EXPECT_EQ(Encode(PreferencesValue(std::vector<bool>(16, true))).size(), 5);
+    EXPECT_EQ(Encode(PreferencesValue(std::vector<int>(100, 1))).size(), 103);
+    std::vector<uint8_t> data;
+    EXPECT_EQ(PreferencesValueParcel::MarshallingPreferenceValue(PreferencesValue(), data), E_INVALID_ARGS);
+}
+
+/**
+ * @tc.name: PreferencesValueParcelTest_002
+ * @tc.desc: normal testcase of the v2 codec, the data of v1 is still decoded
+ * @tc.type: FUNC
+ */
+HWTEST_F(PreferencesValueParcelTest, PreferencesValueParcelTest_002, TestSize.Level0)
+{
+    constexpr uint8_t intType = 1;
+    constexpr uint8_t stringType = 6;
+    constexpr uint8_t boolArrayType = 8;
+    int intValue = -7;
+    std::vector<uint8_t> data(sizeof(uint8_t) + sizeof(int));
+    data[0] = intType;
+    (void)memcpy(data.data() + sizeof(uint8_t), &intValue, sizeof(int));
+    auto [errCode, value] = PreferencesValueParcel::UnmarshallingPreferenceValue(data);
+    EXPECT_EQ(errCode, E_OK);
+    EXPECT_EQ(static_cast<int>(value), intValue);
+
+    std::string str = "v1 string";
+    size_t len = str.size();
+    data.assign(sizeof(uint8_t) + sizeof(size_t) + len, 0);
+    data[0] = stringType;
+    (void)memcpy(data.data() + sizeof(uint8_t), &len, sizeof(size_t));
+    (void)memcpy(data.data() + sizeof(uint8_t) + sizeof(size_t), str.data(), len);
+    std::tie(errCode, value) = PreferencesValueParcel::UnmarshallingPreferenceValue(data);
+    EXPECT_EQ(errCode, E_OK);
+    EXPECT_EQ(static_cast<std::string>(value), str);
+
+    size_t num = 3;
+    data.assign(sizeof(uint8_t) + sizeof(size_t) + num * sizeof(bool), 0);
+    data[0] = boolArrayType;
+    (void)memcpy(data.data() + sizeof(uint8_t), &num, sizeof(size_t));
+    data[sizeof(uint8_t) + sizeof(size_t)] = 1;
+    std::tie(errCode, value) = PreferencesValueParcel::UnmarshallingPreferenceValue(data);
+    EXPECT_EQ(errCode, E_OK);
+    EXPECT_EQ(static_cast<std::vector<bool>>(value), std::vector<bool>({ true, false, false }));
+}
+
+/**
+ * @tc.name: PreferencesValueParcelTest_003
+ * @tc.desc: normal testcase of the v2 codec, the large strings are compressed and the corrupted data is rejected
+ * @tc.type: FUNC
+ */
+HWTEST_F(PreferencesValueParcelTest, PreferencesValueParcelTest_003, TestSize.Level0)
+{
+    std::string repeated;
+    for (int i = 0; repeated.size() < 64 * 1024; i++) {
+        repeated += "{\"id\":" + std::to_string(i % 10) + ",\"name\":\"preferences\"},";
+    }
+    auto data = Encode(PreferencesValue(repeated));
+    EXPECT_LT(data.size(), repeated.size() / 4);
+    EXPECT_TRUE(IsRoundTrip(PreferencesValue(repeated)));
+    EXPECT_TRUE(IsRoundTrip(PreferencesValue(Object(repeated))));
+
+    // the string which does not get smaller is stored as it is
+    std::string random(8 * 1024, '\0');
+    uint32_t seed = 1;
+    for (auto &c : random) {
+        seed = seed * 1103515245U + 12345U;
+        c = static_cast<char>(seed >> 24);
+    }
+    EXPECT_EQ(Encode(PreferencesValue(random)).size(), PreferencesValueParcel::CalSize(PreferencesValue(random)));
+    EXPECT_TRUE(IsRoundTrip(PreferencesValue(random)));
+
+    // every truncation of the data fails to decode
+    for (const auto &value : { PreferencesValue(repeated), PreferencesValue(std::vector<int>{ 1, 300, -70000 }),
+        PreferencesValue(std::vector<std::string>{ "a", "bc" }), PreferencesValue(int64_t(1) << 40) }) {
+        data = Encode(value);
+        for (size_t len = 1; len < data.size(); len++) {
+            EXPECT_NE(PreferencesValueParcel::UnmarshallingPreferenceValue(data.data(), len).first, E_OK);
+        }
+    }
+}
+
+/**
+ * @tc.name: PreferencesValueParcelTest_004
+ * @tc.desc: normal testcase of the v2 codec, the encoded size of the common values is smaller than in v1
+ * @tc.type: FUNC
+ */
+HWTEST_F(PreferencesValueParcelTest, PreferencesValueParcelTest_004, TestSize.Level1)
+{
+    std::string json;
+    for (int i = 0; json.size() < 16 * 1024; i++) {
+        json += "{\"id\":" + std::to_string(i) + ",\"enabled\":true},";
+    }
+    constexpr size_t num = 1000;
+    // the sizes in v1: the type, the length as a size_t and the elements in their native width.
+    size_t header = sizeof(uint8_t) + sizeof(size_t);
+    std::vector<std::tuple<PreferencesValue, size_t>> cases = {
+        { PreferencesValue(std::string(16, 'a')), header + 16 },
+        { PreferencesValue(json), header + json.size() },
+        { PreferencesValue(std::vector<bool>(num, true)), header + num * sizeof(bool) },
+        { PreferencesValue(std::vector<double>(num, 0.5)), header + num * sizeof(double) },
+    };
+    for (auto &[value, v1Size] : cases) {
+        auto data = Encode(value);
+        EXPECT_LT(data.size(), v1Size);
+        EXPECT_TRUE(IsRoundTrip(value));
+    }
+    // the large strings are compressed, the packed booleans take a bit each.
+    EXPECT_LT(Encode(PreferencesValue(json)).size(), json.size() / 2);
+    EXPECT_LE(Encode(PreferencesValue(std::vector<bool>(num, true))).size(), num / 8 + header);
+}
+} // namespace